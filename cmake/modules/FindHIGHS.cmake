@@ -0,0 +1,44 @@
+# Try to find the HiGHS headers and library.
+#
+# Usage of this module as follows:
+#
+#     find_package(HIGHS)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+#  HIGHS_PREFIX         Set this variable to the root installation of HiGHS if
+#                       the module has problems finding the proper installation
+#                       path.
+#
+# Variables defined by this module:
+#
+#  HIGHS_FOUND              System has the HiGHS library and headers
+#  HIGHS_LIBRARIES          The HiGHS library
+#  HIGHS_INCLUDE_DIRS       The location of the HiGHS headers
+
+if(NOT HIGHS_PREFIX)
+	set(HIGHS_PREFIX $ENV{HIGHS_PREFIX})
+endif()
+
+find_library(HIGHS_LIBRARIES
+    NAMES highs libhighs.so
+    HINTS ${HIGHS_PREFIX}/lib ${HIGHS_PREFIX}/lib64
+)
+
+find_path(HIGHS_INCLUDE_DIRS
+    NAMES Highs.h
+    HINTS ${HIGHS_PREFIX}/include
+    PATH_SUFFIXES highs
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(HIGHS DEFAULT_MSG
+    HIGHS_LIBRARIES
+    HIGHS_INCLUDE_DIRS
+)
+
+mark_as_advanced(
+    HIGHS_LIBRARIES
+    HIGHS_INCLUDE_DIRS
+)
@@ -1,7 +1,9 @@
 #include "graphalgos.hpp"
 
-#include "../manager/errors.hpp"   // for InconsistentDataError
-#include "../util/fault_codes.hpp" // for FAULT_CRITICAL_PATH_INFEASIBLE
+#include "../manager/errors.hpp"     // for InconsistentDataError
+#include "../util/configuration.hpp" // for Configuration
+#include "../util/fault_codes.hpp"   // for FAULT_CRITICAL_PATH_INFEASIBLE
+#include "../util/workerpool.hpp"    // for WorkerPool
 #include "datastructures/fast_reset_vector.hpp"
 #include "instance/instance.hpp" // for Instance
 #include "instance/job.hpp"      // for Job
@@ -9,10 +11,10 @@
 
 #include <algorithm>           // for move, max, reverse
 #include <assert.h>            // for assert
-#include <bits/std_function.h> // for function
+#include <atomic>              // for atomic
 #include <boost/range/adaptor/reversed.hpp>
+#include <limits> // for numeric_limits
 #include <ext/alloc_traits.h> // for __alloc_traits<>::value_type
-#include <functional>         // for function
 #include <numeric>
 #include <string> // for string
 #include <unordered_set>
@@ -77,204 +79,794 @@ NecessaryOrderComputer::get_predecessor_count() const noexcept
 	return this->predecessor_count;
 }
 
-TopologicalSort::TopologicalSort(const LagGraph & graph_in) : graph(graph_in) {}
+FlatLagGraph::FlatLagGraph(const LagGraph & graph)
+    : offsets(graph.vertex_count() + 1, 0),
+      reverse_offsets(graph.vertex_count() + 1, 0)
+{
+	// One pass over the maps, edges come ordered by source, then target
+	this->arcs.reserve(graph.edge_count());
+	for (const auto & edge : graph.edges()) {
+		this->arcs.push_back({edge.t, edge.lag});
+		this->offsets[edge.s + 1]++;
+		this->reverse_offsets[edge.t + 1]++;
+	}
+
+	for (vertex v = 0; v < graph.vertex_count(); ++v) {
+		this->offsets[v + 1] += this->offsets[v];
+		this->reverse_offsets[v + 1] += this->reverse_offsets[v];
+	}
+
+	// Counting sort by target. Sources are visited in ascending order, which
+	// is the order of the reverse maps.
+	this->reverse_arcs.resize(this->arcs.size());
+	std::vector<size_t> fill(this->reverse_offsets.begin(),
+	                         this->reverse_offsets.end() - 1);
+	for (vertex v = 0; v < graph.vertex_count(); ++v) {
+		for (const Arc & arc : this->neighbors(v)) {
+			this->reverse_arcs[fill[arc.v]++] = {v, arc.lag};
+		}
+	}
+}
+
+TopologicalSort::TopologicalSort(const LagGraph & graph_in)
+    : own_graph(graph_in), graph(own_graph)
+{}
+
+TopologicalSort::TopologicalSort(const FlatLagGraph & graph_in)
+    : graph(graph_in)
+{}
 
 std::vector<LagGraph::vertex>
 TopologicalSort::get()
 {
 	using vertex = LagGraph::vertex;
 
-	std::vector<unsigned int> indices(this->graph.vertex_count(), 0);
-
-	unsigned int index = (unsigned int)(this->graph.vertex_count() - 1);
-
-	std::function<bool(vertex, vertex)> visit = [&](vertex v, vertex from) {
-		(void)from;
-		(void)v;
-		return true;
-	};
-	std::function<void(vertex, vertex, int)> traverse = [&](vertex from,
-	                                                        vertex to, int lag) {
-		(void)from;
-		(void)to;
-		(void)lag;
-	};
-	std::function<void(vertex)> backtrack = [&](unsigned int v) {
-		if (indices[v] <= index) {
-			indices[v] = index;
-			index--;
-		}
-	};
-
-#ifdef ASSERTIONS
-	bool finished = false;
-#endif
+	const size_t vertex_count = this->graph.vertex_count();
 
-	std::vector<bool> visited;
+	std::vector<size_t> in_degree(vertex_count);
+	std::vector<vertex> ordered;
+	ordered.reserve(vertex_count);
 
-	for (vertex v = 0; v < this->graph.vertex_count(); ++v) {
-		if (this->graph.reverse_neighbor_count(v) > 0) {
-			continue; // Only select vertices without incoming edges as roots
+	for (vertex v = 0; v < vertex_count; ++v) {
+		in_degree[v] = this->graph.reverse_neighbors(v).size();
+		if (in_degree[v] == 0) {
+			ordered.push_back(v);
 		}
-		assert(indices[v] == 0);
-		DFS<decltype(visit), decltype(backtrack), decltype(traverse)>(
-		    this->graph, v, visit, backtrack, traverse);
+	}
 
-#ifdef ASSERTIONS
-		if (index == ((unsigned int)0 - 1)) {
-			finished = true;
+	// ordered doubles as the queue
+	for (size_t head = 0; head < ordered.size(); ++head) {
+		for (const auto & arc : this->graph.neighbors(ordered[head])) {
+			if (--in_degree[arc.v] == 0) {
+				ordered.push_back(arc.v);
+			}
 		}
-#endif
 	}
 
-#ifdef ASSERTIONS
-	assert(finished);
-#endif
-
-	std::vector<vertex> ordered(this->graph.vertex_count());
-	for (vertex v = 0; v < this->graph.vertex_count(); ++v) {
-		ordered[indices[v]] = v;
+	if (ordered.size() < vertex_count) {
+		// Cycles. Everything left has a predecessor that is left.
+		for (vertex v = 0; v < vertex_count; ++v) {
+			if (in_degree[v] > 0) {
+				ordered.push_back(v);
+			}
+		}
 	}
 
 	return ordered;
 }
 
+CriticalPathComputer::Times::Times(size_t job_count)
+    : values(job_count), base(job_count), bound(job_count), computed(false),
+      journaled(job_count, false), queued(job_count, false),
+      affected(job_count, false)
+{}
+
 CriticalPathComputer::CriticalPathComputer(const Instance & instance_in)
-    : l("CritPath"), instance(instance_in)
+    : CriticalPathComputer(instance_in, 0,
+                           std::numeric_limits<unsigned int>::max())
 {}
 
-std::vector<unsigned int>
-CriticalPathComputer::get_forward()
+CriticalPathComputer::CriticalPathComputer(const Instance & instance_in,
+                                           unsigned int window_extension,
+                                           unsigned int hard_deadline)
+    : l("CritPath"), instance(instance_in), graph(instance_in.get_laggraph()),
+      topological_order(TopologicalSort(this->graph).get()),
+      forward_times(instance_in.job_count()),
+      reverse_times(instance_in.job_count()), durations(instance_in.job_count()),
+      dynamic(false)
 {
-	using vertex = LagGraph::vertex;
-	const LagGraph & graph = this->instance.get_laggraph();
+	for (JobId jid = 0; jid < this->instance.job_count(); ++jid) {
+		const Job & job = this->instance.get_job(jid);
+		int64_t release =
+		    std::max((int64_t)job.get_release() - window_extension, (int64_t)0);
+		int64_t deadline = std::min((int64_t)job.get_deadline() + window_extension,
+		                            (int64_t)hard_deadline);
+		int64_t duration = job.get_duration();
+
+		this->durations[jid] = duration;
+		this->forward_times.base[jid] = release;
+		this->forward_times.bound[jid] = deadline - duration;
+		this->reverse_times.base[jid] = duration - deadline;
+		this->reverse_times.bound[jid] = -release;
+	}
+}
+
+CriticalPathComputer::Times &
+CriticalPathComputer::times(Direction direction) noexcept
+{
+	return (direction == FORWARD) ? this->forward_times : this->reverse_times;
+}
 
-	std::vector<vertex> topological_order = TopologicalSort(graph).get();
-	std::vector<unsigned int> earliest_start(graph.vertex_count());
+std::vector<std::vector<FlatLagGraph::Arc>> &
+CriticalPathComputer::propagating_arcs(Direction direction) noexcept
+{
+	return (direction == FORWARD) ? this->successors : this->predecessors;
+}
 
-	for (auto v : topological_order) {
-		earliest_start[v] = this->instance.get_job(v).get_release();
+std::vector<std::vector<FlatLagGraph::Arc>> &
+CriticalPathComputer::supporting_arcs(Direction direction) noexcept
+{
+	return (direction == FORWARD) ? this->predecessors : this->successors;
+}
+
+void
+CriticalPathComputer::compute(Direction direction)
+{
+	Times & t = this->times(direction);
+	if (t.computed) {
+		return;
 	}
 
-	for (auto v : topological_order) {
-		const auto ec = graph.neighbors(v);
-		for (auto edge = ec.cbegin(); edge != ec.cend(); ++edge) {
-			unsigned int new_start;
-			if (edge->lag < -1 * (int)earliest_start[v]) {
-				new_start = 0;
-			} else {
-				new_start = (unsigned int)((int)earliest_start[v] + edge->lag);
+	t.values = t.base;
+
+	if (direction == FORWARD) {
+		for (auto v : this->topological_order) {
+			for (const auto & arc : this->graph.neighbors(v)) {
+				t.values[arc.v] = std::max(t.values[arc.v], t.values[v] + arc.lag);
 			}
+		}
+	} else {
+		const auto reverse_order =
+		    boost::adaptors::reverse(this->topological_order);
+		for (auto v : reverse_order) {
+			for (const auto & arc : this->graph.reverse_neighbors(v)) {
+				auto pred = arc.v;
+				int64_t new_value = t.values[v] + arc.lag;
+
+				// i.e., the latest finish would become negative
+				if (new_value > this->durations[pred]) {
+					BOOST_LOG(l.e()) << "Negative latest finish time detected.";
+					BOOST_LOG(l.d()) << "LF-Times computed so far:";
+					for (auto w : reverse_order) {
+						BOOST_LOG(l.d()) << "-> " << w << ": "
+						                 << this->durations[w] - t.values[w];
+						if (w == v) {
+							BOOST_LOG(l.d()) << "--> Results in "
+							                 << this->durations[pred] - new_value << " for "
+							                 << pred;
+							break;
+						}
+					}
 
-			earliest_start[edge->t] = std::max(earliest_start[edge->t], new_start);
+					throw InconsistentDataError(this->instance, -1,
+					                            FAULT_CRITICAL_PATH_INFEASIBLE,
+					                            "Negative latest finish time");
+				}
+
+				t.values[pred] = std::max(t.values[pred], new_value);
+			}
 		}
 	}
 
-	return earliest_start;
+	this->settle(direction);
+	t.computed = true;
+}
+
+void
+CriticalPathComputer::settle(Direction direction)
+{
+	Times & t = this->times(direction);
+	auto arcs = [&](JobId v) {
+		return (direction == FORWARD) ? this->graph.neighbors(v)
+		                              : this->graph.reverse_neighbors(v);
+	};
+
+	for (JobId v = 0; v < this->instance.job_count(); ++v) {
+		for (const auto & arc : arcs(v)) {
+			if (t.values[v] + arc.lag > t.values[arc.v]) {
+				t.queued[v] = true;
+				t.queue.push_back(v);
+				break;
+			}
+		}
+	}
+
+	while (!t.queue.empty()) {
+		JobId v = t.queue.front();
+		t.queue.pop_front();
+		t.queued[v] = false;
+
+		for (const auto & arc : arcs(v)) {
+			int64_t new_value = t.values[v] + arc.lag;
+			if (new_value <= t.values[arc.v]) {
+				continue;
+			}
+			t.values[arc.v] = new_value;
+
+			// This also ends the propagation around cycles of positive length
+			if (new_value > t.bound[arc.v]) {
+				BOOST_LOG(l.w()) << "Job " << arc.v
+				                 << " can not be scheduled within its window. The lag "
+				                    "graph may contain a cycle of positive length.";
+				t.queue.clear();
+				t.queued.reset();
+				return;
+			}
+
+			if (!t.queued[arc.v]) {
+				t.queued[arc.v] = true;
+				t.queue.push_back(arc.v);
+			}
+		}
+	}
+}
+
+std::vector<unsigned int>
+CriticalPathComputer::get_forward()
+{
+	this->compute(FORWARD);
+	return std::vector<unsigned int>(this->forward_times.values.begin(),
+	                                 this->forward_times.values.end());
 }
 
 std::vector<unsigned int>
 CriticalPathComputer::get_reverse()
 {
-	using vertex = LagGraph::vertex;
-	const LagGraph & graph = this->instance.get_laggraph();
+	this->compute(REVERSE);
+	std::vector<unsigned int> latest_finish(this->instance.job_count());
+	for (JobId jid = 0; jid < this->instance.job_count(); ++jid) {
+		latest_finish[jid] =
+		    (unsigned int)(this->durations[jid] - this->reverse_times.values[jid]);
+	}
+	return latest_finish;
+}
+
+unsigned int
+CriticalPathComputer::get_earliest_start(JobId jid)
+{
+	this->compute(FORWARD);
+	return (unsigned int)this->forward_times.values[jid];
+}
+
+unsigned int
+CriticalPathComputer::get_latest_finish(JobId jid)
+{
+	this->compute(REVERSE);
+	return (unsigned int)(this->durations[jid] - this->reverse_times.values[jid]);
+}
+
+const std::vector<CriticalPathComputer::JobId> &
+CriticalPathComputer::get_changed_earliest_starts() const noexcept
+{
+	return this->forward_times.changed;
+}
 
-	std::vector<vertex> topological_order = TopologicalSort(graph).get();
-	std::reverse(topological_order.begin(), topological_order.end());
+const std::vector<CriticalPathComputer::JobId> &
+CriticalPathComputer::get_changed_latest_finishs() const noexcept
+{
+	return this->reverse_times.changed;
+}
 
-	std::vector<unsigned int> latest_finish(graph.vertex_count());
+void
+CriticalPathComputer::prepare_change()
+{
+	this->compute(FORWARD);
+	this->compute(REVERSE);
+
+	if (!this->dynamic) {
+		this->successors.resize(this->graph.vertex_count());
+		this->predecessors.resize(this->graph.vertex_count());
+		for (JobId v = 0; v < this->graph.vertex_count(); ++v) {
+			auto out = this->graph.neighbors(v);
+			this->successors[v].assign(out.begin(), out.end());
+			auto in = this->graph.reverse_neighbors(v);
+			this->predecessors[v].assign(in.begin(), in.end());
+		}
+		this->dynamic = true;
+	}
+}
 
-	for (auto v : topological_order) {
-		latest_finish[v] = this->instance.get_job(v).get_deadline();
+void
+CriticalPathComputer::start_change()
+{
+	for (Direction direction : {FORWARD, REVERSE}) {
+		Times & t = this->times(direction);
+		t.journal.clear();
+		t.journaled.reset();
+		t.changed.clear();
 	}
+}
 
-	for (auto v : topological_order) {
-		for (auto edge : graph.reverse_neighbors(v)) {
-			assert(edge.s == v);
-			auto t = edge.t;
-			const Job & t_job = this->instance.get_job(t);
-			const Job & s_job = this->instance.get_job(v);
+void
+CriticalPathComputer::set_value(Direction direction, JobId jid, int64_t value)
+{
+	Times & t = this->times(direction);
+	if (!t.journaled[jid]) {
+		t.journaled[jid] = true;
+		t.journal.emplace_back(jid, t.values[jid]);
+	}
+	t.values[jid] = value;
+}
 
-			int new_finish = (int)latest_finish[v] - (int)s_job.get_duration() +
-			                 (int)t_job.get_duration() - (int)edge.lag;
+bool
+CriticalPathComputer::relax(Direction direction, JobId from, JobId to,
+                            int lag, bool check_bound)
+{
+	Times & t = this->times(direction);
+	int64_t new_value = t.values[from] + lag;
+	if (new_value <= t.values[to]) {
+		return true;
+	}
 
-			if (new_finish < 0) {
-				BOOST_LOG(l.e()) << "Negative latest finish time detected.";
-				BOOST_LOG(l.d()) << "LF-Times computed so far:";
-				for (auto w : topological_order) {
-					BOOST_LOG(l.d()) << "-> " << w << ": " << latest_finish[w];
-					if (w == v) {
-						BOOST_LOG(l.d()) << "--> Results in " << new_finish << " for " << t;
-						break;
-					}
-				}
+	this->set_value(direction, to, new_value);
+	// This also ends the propagation around cycles of positive length
+	if (check_bound && (new_value > t.bound[to])) {
+		return false;
+	}
+
+	if (!t.queued[to]) {
+		t.queued[to] = true;
+		t.queue.push_back(to);
+	}
+	return true;
+}
+
+bool
+CriticalPathComputer::raise(Direction direction, bool check_bound)
+{
+	Times & t = this->times(direction);
+	auto & arcs = this->propagating_arcs(direction);
+
+	while (!t.queue.empty()) {
+		JobId v = t.queue.front();
+		t.queue.pop_front();
+		t.queued[v] = false;
+
+		for (const auto & arc : arcs[v]) {
+			if (!this->relax(direction, v, arc.v, arc.lag, check_bound)) {
+				t.queue.clear();
+				t.queued.reset();
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
 
-				throw InconsistentDataError(this->instance, -1,
-				                            FAULT_CRITICAL_PATH_INFEASIBLE,
-				                            "Negative latest finish time");
+void
+CriticalPathComputer::lower(Direction direction, JobId root)
+{
+	Times & t = this->times(direction);
+	auto & arcs = this->propagating_arcs(direction);
+
+	/* Every job whose value might depend on the root: reachable from it along
+	 * tight arcs. */
+	t.affected.reset();
+	t.affected_buf.clear();
+	t.affected[root] = true;
+	t.affected_buf.push_back(root);
+	for (size_t i = 0; i < t.affected_buf.size(); ++i) {
+		JobId v = t.affected_buf[i];
+		for (const auto & arc : arcs[v]) {
+			if (!t.affected[arc.v] && (t.values[v] + arc.lag == t.values[arc.v])) {
+				t.affected[arc.v] = true;
+				t.affected_buf.push_back(arc.v);
 			}
+		}
+	}
 
-			if ((unsigned int)new_finish < latest_finish[t]) {
-				latest_finish[t] = (unsigned int)new_finish;
+	// Restart the affected jobs from what the rest of the graph supports...
+	for (JobId v : t.affected_buf) {
+		int64_t value = t.base[v];
+		for (const auto & arc : this->supporting_arcs(direction)[v]) {
+			if (!t.affected[arc.v]) {
+				value = std::max(value, t.values[arc.v] + arc.lag);
 			}
 		}
+		if (value != t.values[v]) {
+			this->set_value(direction, v, value);
+		}
+		t.queued[v] = true;
+		t.queue.push_back(v);
 	}
 
-	return latest_finish;
+	// ... and propagate among them. Nothing can rise above its old value.
+	this->raise(direction, false);
 }
 
-APLPComputer::APLPComputer(const Instance & instance_in) : instance(instance_in)
-{}
+bool
+CriticalPathComputer::commit(bool check_windows)
+{
+	if (check_windows) {
+		for (Direction direction : {FORWARD, REVERSE}) {
+			for (const auto & entry : this->times(direction).journal) {
+				JobId jid = entry.first;
+				if (this->forward_times.values[jid] + this->reverse_times.values[jid] >
+				    0) {
+					this->rollback();
+					return false;
+				}
+			}
+		}
+	}
 
-std::vector<std::vector<int>>
-APLPComputer::get()
+	for (Direction direction : {FORWARD, REVERSE}) {
+		Times & t = this->times(direction);
+		for (const auto & [jid, old_value] : t.journal) {
+			if (t.values[jid] != old_value) {
+				t.changed.push_back(jid);
+			}
+		}
+	}
+	return true;
+}
+
+void
+CriticalPathComputer::rollback()
 {
-	this->result.clear();
-	this->result.resize(this->instance.job_count(),
-	                    std::vector<int>(this->instance.job_count(), -1));
+	for (Direction direction : {FORWARD, REVERSE}) {
+		Times & t = this->times(direction);
+		for (const auto & [jid, old_value] : t.journal) {
+			t.values[jid] = old_value;
+		}
+		t.journal.clear();
+		t.journaled.reset();
+		t.changed.clear();
+	}
+}
 
-	this->topological_order =
-	    TopologicalSort(this->instance.get_laggraph()).get();
+bool
+CriticalPathComputer::add_edge(JobId s, JobId t, int lag)
+{
+	this->prepare_change();
+	this->start_change();
 
-	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
-		this->compute_SSLP(jid);
+	// Relaxing a job against itself would corrupt the journal
+	if (s == t) {
+		return false;
 	}
 
-	// TODO this is unsafe! But fast…
-	return std::move(this->result);
+	auto find = [](std::vector<FlatLagGraph::Arc> & arcs, JobId v) {
+		return std::find_if(arcs.begin(), arcs.end(),
+		                    [&](const FlatLagGraph::Arc & arc) { return arc.v == v; });
+	};
+	auto out_it = find(this->successors[s], t);
+	bool existed = (out_it != this->successors[s].end());
+	int old_lag = 0;
+
+	if (existed) {
+		auto in_it = find(this->predecessors[t], s);
+		old_lag = out_it->lag;
+		out_it->lag = lag;
+		in_it->lag = lag;
+	} else {
+		this->successors[s].push_back({t, lag});
+		this->predecessors[t].push_back({s, lag});
+	}
+
+	bool feasible = true;
+	if (!existed || (lag > old_lag)) {
+		feasible = this->relax(FORWARD, s, t, lag, true) &&
+		           this->raise(FORWARD, true) &&
+		           this->relax(REVERSE, t, s, lag, true) &&
+		           this->raise(REVERSE, true) && this->commit(true);
+	} else if (lag < old_lag) {
+		// Loosening constraints can never be infeasible
+		this->lower(FORWARD, t);
+		this->lower(REVERSE, s);
+		this->commit(false);
+	}
+
+	if (!feasible) {
+		this->forward_times.queue.clear();
+		this->forward_times.queued.reset();
+		this->reverse_times.queue.clear();
+		this->reverse_times.queued.reset();
+		this->rollback();
+
+		if (existed) {
+			find(this->successors[s], t)->lag = old_lag;
+			find(this->predecessors[t], s)->lag = old_lag;
+		} else {
+			this->successors[s].pop_back();
+			this->predecessors[t].pop_back();
+		}
+	}
+
+	return feasible;
+}
+
+bool
+CriticalPathComputer::remove_edge(JobId s, JobId t)
+{
+	this->prepare_change();
+
+	auto remove = [](std::vector<FlatLagGraph::Arc> & arcs, JobId v) {
+		auto it =
+		    std::find_if(arcs.begin(), arcs.end(),
+		                 [&](const FlatLagGraph::Arc & arc) { return arc.v == v; });
+		if (it == arcs.end()) {
+			return false;
+		}
+		*it = arcs.back();
+		arcs.pop_back();
+		return true;
+	};
+
+	if (!remove(this->successors[s], t)) {
+		return false;
+	}
+	remove(this->predecessors[t], s);
+	this->start_change();
+
+	// Removing constraints can never be infeasible
+	this->lower(FORWARD, t);
+	this->lower(REVERSE, s);
+	this->commit(false);
+
+	return true;
+}
+
+bool
+CriticalPathComputer::tighten_window(JobId jid, unsigned int release,
+                                     unsigned int deadline)
+{
+	this->prepare_change();
+	this->start_change();
+
+	const int64_t old_release = this->forward_times.base[jid];
+	const int64_t old_reverse_base = this->reverse_times.base[jid];
+	const int64_t new_release = std::max(old_release, (int64_t)release);
+	const int64_t new_reverse_base =
+	    std::max(old_reverse_base, this->durations[jid] - (int64_t)deadline);
+
+	auto restore_window = [&]() {
+		this->forward_times.base[jid] = old_release;
+		this->reverse_times.bound[jid] = -old_release;
+		this->reverse_times.base[jid] = old_reverse_base;
+		this->forward_times.bound[jid] = -old_reverse_base;
+	};
+
+	this->forward_times.base[jid] = new_release;
+	this->reverse_times.bound[jid] = -new_release;
+	this->reverse_times.base[jid] = new_reverse_base;
+	this->forward_times.bound[jid] = -new_reverse_base;
+
+	for (Direction direction : {FORWARD, REVERSE}) {
+		Times & t = this->times(direction);
+		if (t.base[jid] <= t.values[jid]) {
+			continue;
+		}
+		this->set_value(direction, jid, t.base[jid]);
+		t.queued[jid] = true;
+		t.queue.push_back(jid);
+		if (!this->raise(direction, true)) {
+			this->rollback();
+			restore_window();
+			return false;
+		}
+	}
+
+	// The job itself might now be infeasible without any value changing
+	if ((this->forward_times.values[jid] + this->reverse_times.values[jid] > 0) ||
+	    !this->commit(true)) {
+		this->rollback();
+		restore_window();
+		return false;
+	}
+
+	return true;
+}
+
+APLPComputer::APLPComputer(const Instance & instance_in,
+                           unsigned int thread_count_in)
+    : prepared(false), thread_count(thread_count_in), query_source(0),
+      query_valid(false), instance(instance_in)
+{
+	if ((this->thread_count == 0) &&
+	    Configuration::get()->get_threads().valid()) {
+		this->thread_count = Configuration::get()->get_threads().value();
+	}
+	this->thread_count = std::max(1u, this->thread_count);
 }
 
-// TODO this can be sped up.
-// TODO make this fail if there are negative edges / cycles
 void
-APLPComputer::compute_SSLP(unsigned int start_job)
+APLPComputer::prepare()
+{
+	if (this->prepared) {
+		return;
+	}
+
+	this->graph = FlatLagGraph(this->instance.get_laggraph());
+	this->topological_order = TopologicalSort(this->graph).get();
+	this->topological_position.resize(this->topological_order.size());
+	for (size_t i = 0; i < this->topological_order.size(); ++i) {
+		this->topological_position[this->topological_order[i]] = i;
+	}
+
+	this->prepared = true;
+}
+
+void
+APLPComputer::reset(SSLPBuffers & buffers) const noexcept
+{
+	if (buffers.distances.size() != this->instance.job_count()) {
+		buffers.distances.assign(this->instance.job_count(), -1);
+		buffers.reached.clear();
+		return;
+	}
+
+	for (unsigned int v : buffers.reached) {
+		buffers.distances[v] = -1;
+	}
+	buffers.reached.clear();
+}
+
+template <class Fn>
+void
+APLPComputer::for_each_source(Fn && fn)
+{
+	this->prepare();
+
+	const unsigned int job_count = (unsigned int)this->instance.job_count();
+	unsigned int workers =
+	    std::min(this->thread_count, std::max(1u, job_count));
+	std::vector<SSLPBuffers> buffers(workers);
+	// Sources are handed out in small chunks, the sweeps differ a lot in length
+	constexpr unsigned int CHUNK_SIZE = 16;
+	std::atomic<unsigned int> next_source(0);
+
+	util::WorkerPool pool(workers);
+	pool.run([&](unsigned int worker) {
+		while (true) {
+			unsigned int first = next_source.fetch_add(CHUNK_SIZE);
+			if (first >= job_count) {
+				return;
+			}
+			unsigned int last = std::min(job_count, first + CHUNK_SIZE);
+			for (unsigned int start_job = first; start_job < last; ++start_job) {
+				this->compute_SSLP(start_job, buffers[worker]);
+				fn(start_job, buffers[worker], worker);
+			}
+		}
+	});
+}
+
+std::vector<std::vector<int>>
+APLPComputer::get()
 {
-	const LagGraph & graph = this->instance.get_laggraph();
+	std::vector<std::vector<int>> result(
+	    this->instance.job_count(), std::vector<int>(this->instance.job_count(), -1));
+
+	// Every source writes only its own row
+	this->for_each_source(
+	    [&](unsigned int start_job, const SSLPBuffers & buffers, unsigned int) {
+		    for (unsigned int v : buffers.reached) {
+			    result[start_job][v] = buffers.distances[v];
+		    }
+	    });
+
+	return result;
+}
 
-	this->result[start_job][start_job] = 0;
+LongestPaths
+APLPComputer::get_sparse()
+{
+	const size_t job_count = this->instance.job_count();
 
-	auto it = this->topological_order.begin();
+	// Every worker collects the rows of its sources. Row locations are written
+	// by the one worker that computed the row.
+	struct RowStore
+	{
+		std::vector<std::pair<unsigned int, int>> pairs;
+	};
+	std::vector<RowStore> stores(
+	    std::min((size_t)this->thread_count, std::max((size_t)1, job_count)));
+	std::vector<unsigned int> row_worker(job_count);
+	std::vector<size_t> row_begin(job_count);
+	std::vector<size_t> row_size(job_count);
+
+	this->for_each_source([&](unsigned int start_job, const SSLPBuffers & buffers,
+	                          unsigned int worker) {
+		auto & pairs = stores[worker].pairs;
+		size_t begin = pairs.size();
+		for (unsigned int v : buffers.reached) {
+			pairs.emplace_back(v, buffers.distances[v]);
+		}
+		std::sort(pairs.begin() + (std::ptrdiff_t)begin, pairs.end());
+
+		row_worker[start_job] = worker;
+		row_begin[start_job] = begin;
+		row_size[start_job] = pairs.size() - begin;
+	});
+
+	LongestPaths paths;
+	paths.offsets.resize(job_count + 1);
+	paths.offsets[0] = 0;
+	for (size_t jid = 0; jid < job_count; ++jid) {
+		paths.offsets[jid + 1] = paths.offsets[jid] + row_size[jid];
+	}
 
-	// skip forward to job A
-	while (*it != start_job) {
-		it++;
+	paths.targets.resize(paths.offsets[job_count]);
+	paths.lengths.resize(paths.offsets[job_count]);
+	for (size_t jid = 0; jid < job_count; ++jid) {
+		const auto & pairs = stores[row_worker[jid]].pairs;
+		for (size_t i = 0; i < row_size[jid]; ++i) {
+			paths.targets[paths.offsets[jid] + i] = pairs[row_begin[jid] + i].first;
+			paths.lengths[paths.offsets[jid] + i] = pairs[row_begin[jid] + i].second;
+		}
 	}
 
+	return paths;
+}
+
+int
+APLPComputer::get_path_length(unsigned int from, unsigned int to)
+{
+	assert(from < this->instance.job_count());
+	assert(to < this->instance.job_count());
+
+	if (!this->query_valid || (this->query_source != from)) {
+		this->prepare();
+		this->compute_SSLP(from, this->query_buffers);
+		this->query_source = from;
+		this->query_valid = true;
+	}
+
+	return this->query_buffers.distances[to];
+}
+
+// TODO make this fail if there are negative edges / cycles
+void
+APLPComputer::compute_SSLP(unsigned int start_job, SSLPBuffers & buffers) const
+{
+	this->reset(buffers);
+	buffers.distances[start_job] = 0;
+
+	// Nothing after the last reached job can be reached
+	size_t last_reached = this->topological_position[start_job];
+
 	// relax edges
-	while (it != topological_order.end()) {
-		const unsigned int v = *it;
-		it++;
+	for (size_t pos = this->topological_position[start_job];
+	     pos <= last_reached; ++pos) {
+		const unsigned int v = this->topological_order[pos];
 
-		if (this->result[start_job][v] == -1) { // no path here
+		if (buffers.distances[v] == -1) { // no path here
 			continue;
 		}
+		buffers.reached.push_back(v);
 
-		for (const auto & edge : graph.neighbors(v)) {
-			int relaxed_dist = this->result[start_job][v] + edge.lag;
+		for (const auto & arc : this->graph.neighbors(v)) {
+			int relaxed_dist = buffers.distances[v] + arc.lag;
 			assert(relaxed_dist >= 0); // negative paths break things for now
 
-			this->result[start_job][edge.t] =
-			    std::max(this->result[start_job][edge.t], relaxed_dist);
+			buffers.distances[arc.v] =
+			    std::max(buffers.distances[arc.v], relaxed_dist);
+			last_reached =
+			    std::max(last_reached, this->topological_position[arc.v]);
 		}
 	}
 }
+
+int
+LongestPaths::get(unsigned int from, unsigned int to) const noexcept
+{
+	auto row_begin = this->targets.begin() + (std::ptrdiff_t)this->offsets[from];
+	auto row_end = this->targets.begin() + (std::ptrdiff_t)this->offsets[from + 1];
+	auto it = std::lower_bound(row_begin, row_end, to);
+	if ((it == row_end) || (*it != to)) {
+		return -1;
+	}
+	return this->lengths[(size_t)(it - this->targets.begin())];
+}
@@ -1,12 +1,96 @@
 #ifndef GRAPHALGOS_H
 #define GRAPHALGOS_H
 
+#include "../datastructures/circular_vector.hpp"   // for CircularVector
+#include "../datastructures/fast_reset_vector.hpp" // for FastResetVector
 #include "../instance/laggraph.hpp" // for LagGraph, LagGraph::vertex
 #include "../util/log.hpp"
 
-#include <vector> // for vector
+#include <cstddef> // for size_t
+#include <cstdint> // for int64_t
+#include <utility> // for pair
+#include <vector>  // for vector
 class Instance;
 
+/* A read-only copy of a LagGraph in compressed sparse row form, for
+ * algorithms that walk the whole graph. Iterating over the neighbors of a
+ * vertex scans one array instead of walking a std::map. Neighbors are in the
+ * same order as in the LagGraph. */
+class FlatLagGraph {
+public:
+	using vertex = LagGraph::vertex;
+
+	struct Arc
+	{
+		// The other end of the edge
+		vertex v;
+		int lag;
+	};
+
+	struct ArcRange
+	{
+		const Arc * first;
+		const Arc * last;
+
+		const Arc *
+		begin() const noexcept
+		{
+			return this->first;
+		}
+		const Arc *
+		end() const noexcept
+		{
+			return this->last;
+		}
+		size_t
+		size() const noexcept
+		{
+			return (size_t)(this->last - this->first);
+		}
+	};
+
+	FlatLagGraph() = default;
+	explicit FlatLagGraph(const LagGraph & graph);
+
+	size_t
+	vertex_count() const noexcept
+	{
+		return this->offsets.empty() ? 0 : this->offsets.size() - 1;
+	}
+
+	ArcRange
+	neighbors(vertex v) const noexcept
+	{
+		return {this->arcs.data() + this->offsets[v],
+		        this->arcs.data() + this->offsets[v + 1]};
+	}
+
+	/* The arcs point to the predecessors, with the lag of the edge from the
+	 * predecessor to v. */
+	ArcRange
+	reverse_neighbors(vertex v) const noexcept
+	{
+		return {this->reverse_arcs.data() + this->reverse_offsets[v],
+		        this->reverse_arcs.data() + this->reverse_offsets[v + 1]};
+	}
+
+private:
+	std::vector<size_t> offsets;
+	std::vector<Arc> arcs;
+	std::vector<size_t> reverse_offsets;
+	std::vector<Arc> reverse_arcs;
+};
+
+/* Depth-first search from start, calling
+ *
+ * * visit(v, from) when reaching v. If it returns false, the edges of v are
+ *   not followed.
+ * * traverse(v, to, lag) for every edge that is followed, whether or not 'to'
+ *   has been visited before.
+ * * backtrack(v) when leaving v.
+ *
+ * The search uses an explicit stack, so arbitrarily long paths are fine. The
+ * callbacks are called directly, pass lambdas instead of std::function. */
 template <typename visit_func, typename backtrack_func, typename traverse_func>
 class DFS {
 public:
@@ -14,25 +98,44 @@ public:
 
 	DFS(const LagGraph & graph, const LagGraph::vertex start, visit_func visit,
 	    backtrack_func backtrack, traverse_func traverse, bool reverse = false);
+	DFS(const FlatLagGraph & graph, const LagGraph::vertex start,
+	    visit_func visit, backtrack_func backtrack, traverse_func traverse,
+	    bool reverse = false);
 
 private:
 	visit_func visit;
 	backtrack_func backtrack;
 	traverse_func traverse;
-	const LagGraph & graph;
 
 	std::vector<bool> visited;
 
-	void dfs_rec(vertex v, vertex from, bool reverse);
+	struct Frame
+	{
+		vertex v;
+		const FlatLagGraph::Arc * next;
+		const FlatLagGraph::Arc * end;
+	};
+	std::vector<Frame> stack;
+
+	void run(const FlatLagGraph & graph, vertex start, bool reverse);
+	void enter(const FlatLagGraph & graph, vertex v, vertex from, bool reverse);
 };
 
+/* Kahn's algorithm. Jobs without predecessors come first, by ascending ID.
+ *
+ * If the graph has cycles, the jobs on or behind a cycle are appended by
+ * ascending ID. The result is then not a topological order, which callers
+ * can detect by finding an edge that points backwards. */
 class TopologicalSort {
 public:
 	TopologicalSort(const LagGraph & graph);
+	TopologicalSort(const FlatLagGraph & graph);
 	std::vector<LagGraph::vertex> get();
 
 private:
-	const LagGraph & graph;
+	// Only used if constructed from a LagGraph
+	FlatLagGraph own_graph;
+	const FlatLagGraph & graph;
 };
 
 // TODO this is currently only based on earliest starts / latest finishs.
@@ -59,28 +162,218 @@ private:
 	std::vector<unsigned int> latest_finishs;
 };
 
+/* Earliest starts and latest finishes of all jobs along the lag graph.
+ *
+ * Besides computing them once, the computer can keep them up to date while
+ * edges are added or removed and windows are tightened. These changes only
+ * apply to the computer, never to the instance. Every change is propagated
+ * only as far as times actually change, and afterwards
+ * get_changed_earliest_starts() / get_changed_latest_finishs() list the jobs
+ * whose times changed. A change that would move the earliest start of any
+ * job past its latest start is rejected and leaves everything as it was.
+ *
+ * Removing edges is exact as long as the lag graph has no cycles of positive
+ * length. Such cycles are infeasible anyway, and adding an edge that closes
+ * one is always rejected. When computing the times from scratch, propagation
+ * around cycles stops as soon as some earliest start passes its latest start,
+ * so the times stay valid bounds, but that job's window is empty.
+ */
 class CriticalPathComputer {
 public:
+	using JobId = LagGraph::vertex;
+
 	CriticalPathComputer(const Instance & instance);
+	/* Every job's window is widened by window_extension on both sides, but
+	 * neither below 0 nor above hard_deadline. */
+	CriticalPathComputer(const Instance & instance, unsigned int window_extension,
+	                     unsigned int hard_deadline);
 	std::vector<unsigned int> get_forward();
 	std::vector<unsigned int> get_reverse();
 
+	unsigned int get_earliest_start(JobId jid);
+	unsigned int get_latest_finish(JobId jid);
+
+	/* If there already is an edge from s to t, its lag is replaced. Returns
+	 * false if the change is infeasible or s == t, and leaves the graph
+	 * unchanged then. */
+	bool add_edge(JobId s, JobId t, int lag);
+	/* Returns false if there is no edge from s to t. */
+	bool remove_edge(JobId s, JobId t);
+	/* Raises the release and lowers the deadline of a job. Values that would
+	 * widen the window are ignored. Returns false if the change is
+	 * infeasible. */
+	bool tighten_window(JobId jid, unsigned int release, unsigned int deadline);
+
+	/* The jobs whose times were changed by the last successful change.
+	 * Removing a nonexistent edge does not count as a change. */
+	const std::vector<JobId> & get_changed_earliest_starts() const noexcept;
+	const std::vector<JobId> & get_changed_latest_finishs() const noexcept;
+
 private:
+	enum Direction { FORWARD = 0, REVERSE = 1 };
+
+	/* Both directions are kept in the same form:
+	 *
+	 *   value[v] = max(base[v], max over supporting arcs (u, lag): value[u] + lag)
+	 *
+	 * Forward, the values are the earliest starts, the bases are the releases
+	 * and the supporting arcs of v come from its predecessors. In reverse, the
+	 * values are (duration - latest finish), the bases are
+	 * (duration - deadline) and the supporting arcs come from the successors.
+	 * A job's window is feasible iff its two values sum up to at most 0. */
+	struct Times
+	{
+		explicit Times(size_t job_count);
+
+		std::vector<int64_t> values;
+		std::vector<int64_t> base;
+		// Raising a value above its bound is always infeasible
+		std::vector<int64_t> bound;
+		bool computed;
+
+		// (job, value before the current change), once per changed job
+		std::vector<std::pair<JobId, int64_t>> journal;
+		FastResetVector<bool> journaled;
+		std::vector<JobId> changed;
+
+		// Buffers for propagation
+		CircularVector<JobId> queue;
+		FastResetVector<bool> queued;
+		FastResetVector<bool> affected;
+		std::vector<JobId> affected_buf;
+	};
+
+	Times & times(Direction direction) noexcept;
+	// The arcs along which increases of values are propagated
+	std::vector<std::vector<FlatLagGraph::Arc>> &
+	propagating_arcs(Direction direction) noexcept;
+	std::vector<std::vector<FlatLagGraph::Arc>> &
+	supporting_arcs(Direction direction) noexcept;
+
+	void compute(Direction direction);
+	/* Corrects the values along arcs the topological order could not
+	 * respect, i.e., on cycles, until nothing changes or a value passes its
+	 * bound. */
+	void settle(Direction direction);
+	// Computes the times and builds the adjacency lists, if necessary
+	void prepare_change();
+	// Forgets about the previous change
+	void start_change();
+	void set_value(Direction direction, JobId jid, int64_t value);
+	bool relax(Direction direction, JobId from, JobId to, int lag,
+	           bool check_bound);
+	bool raise(Direction direction, bool check_bound);
+	void lower(Direction direction, JobId root);
+	/* Records the changed jobs. If check_windows is set, rolls back instead
+	 * if any changed job's window became infeasible. */
+	bool commit(bool check_windows);
+	void rollback();
+
 	Log l;
 	const Instance & instance;
+	// Shared by both directions
+	FlatLagGraph graph;
+	std::vector<LagGraph::vertex> topological_order;
+
+	Times forward_times;
+	Times reverse_times;
+	std::vector<int64_t> durations;
+
+	// Only built on the first change
+	bool dynamic;
+	std::vector<std::vector<FlatLagGraph::Arc>> successors;
+	std::vector<std::vector<FlatLagGraph::Arc>> predecessors;
 };
 
-class APLPComputer {
+/* Longest path lengths from every job to every job reachable from it, as
+ * computed by APLPComputer::get_sparse(). Only reachable pairs are stored, so
+ * the memory needed is linear in the number of such pairs instead of
+ * quadratic in the number of jobs. */
+class LongestPaths {
 public:
-	APLPComputer(const Instance & instance);
 	// -1 as path length means 'no path'
+	int get(unsigned int from, unsigned int to) const noexcept;
+
+	/* Number of jobs reachable from 'from', including 'from' itself. */
+	size_t
+	get_reachable_count(unsigned int from) const noexcept
+	{
+		return this->offsets[from + 1] - this->offsets[from];
+	}
+
+	/* Calls fn(to, length) for every job reachable from 'from', by ascending
+	 * job ID. */
+	template <class Fn>
+	void
+	for_each_reachable(unsigned int from, Fn && fn) const
+	{
+		for (size_t i = this->offsets[from]; i < this->offsets[from + 1]; ++i) {
+			fn(this->targets[i], this->lengths[i]);
+		}
+	}
+
+	/* Total number of stored pairs. */
+	size_t
+	size() const noexcept
+	{
+		return this->targets.size();
+	}
+
+private:
+	// Row of job j is [offsets[j], offsets[j + 1]) in targets / lengths
+	std::vector<size_t> offsets;
+	std::vector<unsigned int> targets;
+	std::vector<int> lengths;
+
+	friend class APLPComputer;
+};
+
+/* All-pairs longest paths along the lag graph, by one sweep along the
+ * topological order per source job. The sources are distributed over
+ * thread_count threads. A thread count of 0 means to use as many threads as
+ * configured via the command line. */
+class APLPComputer {
+public:
+	APLPComputer(const Instance & instance, unsigned int thread_count = 0);
+	// -1 as path length means 'no path'. This needs memory quadratic in the
+	// number of jobs, use get_sparse() for large instances.
 	std::vector<std::vector<int>> get();
+	LongestPaths get_sparse();
+
+	/* A single longest path length, without computing all pairs. The sweep
+	 * from 'from' is kept, so asking for several targets of the same source
+	 * costs only one sweep. -1 means 'no path'. */
+	int get_path_length(unsigned int from, unsigned int to);
 
 private:
-	std::vector<std::vector<int>> result;
+	// Per-thread state of single-source sweeps
+	struct SSLPBuffers
+	{
+		// -1 for all jobs not in reached
+		std::vector<int> distances;
+		// Jobs reached by the last sweep, in topological order
+		std::vector<unsigned int> reached;
+	};
+
+	void prepare();
+	void reset(SSLPBuffers & buffers) const noexcept;
+	void compute_SSLP(unsigned int start_job, SSLPBuffers & buffers) const;
+	/* Computes the sweep for every start job in parallel, calling
+	 * fn(start_job, buffers, worker) after each. */
+	template <class Fn>
+	void for_each_source(Fn && fn);
+
+	FlatLagGraph graph;
 	std::vector<unsigned int> topological_order;
+	// Index of every job in topological_order
+	std::vector<size_t> topological_position;
+	bool prepared;
+
+	unsigned int thread_count;
 
-	void compute_SSLP(unsigned int start_job);
+	SSLPBuffers query_buffers;
+	unsigned int query_source;
+	bool query_valid;
 
 	const Instance & instance;
 };
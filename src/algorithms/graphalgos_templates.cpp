@@ -1,36 +1,55 @@
 template <typename visit_func, typename backtrack_func, typename traverse_func>
 DFS<visit_func, backtrack_func, traverse_func>::DFS(const LagGraph & graph_in, const LagGraph::vertex start, visit_func visit_in, backtrack_func backtrack_in, traverse_func traverse_in, bool reverse)
-  : visit(visit_in), backtrack(backtrack_in), traverse(traverse_in), graph(graph_in), visited(graph_in.vertex_count(), false)
+  : visit(visit_in), backtrack(backtrack_in), traverse(traverse_in), visited(graph_in.vertex_count(), false)
 {
-  this->dfs_rec(start, LagGraph::no_vertex, reverse);
+  this->run(FlatLagGraph(graph_in), start, reverse);
+}
+
+template <typename visit_func, typename backtrack_func, typename traverse_func>
+DFS<visit_func, backtrack_func, traverse_func>::DFS(const FlatLagGraph & graph_in, const LagGraph::vertex start, visit_func visit_in, backtrack_func backtrack_in, traverse_func traverse_in, bool reverse)
+  : visit(visit_in), backtrack(backtrack_in), traverse(traverse_in), visited(graph_in.vertex_count(), false)
+{
+  this->run(graph_in, start, reverse);
 }
 
 template <typename visit_func, typename backtrack_func, typename traverse_func>
 void
-DFS<visit_func, backtrack_func, traverse_func>::dfs_rec(vertex v, vertex from, bool reverse)
+DFS<visit_func, backtrack_func, traverse_func>::enter(const FlatLagGraph & graph, vertex v, vertex from, bool reverse)
 {
   this->visited[v] = true;
   bool keep_going = this->visit(v, from);
 
-  if (keep_going) {
-    if (!reverse) {
-      auto container = this->graph.neighbors(v);
-      for (auto edge : container) {
-        this->traverse(v, edge.t, edge.lag);
-        if (!this->visited[edge.t]) {
-          this->dfs_rec(edge.t, v, reverse);
-        }
-      }
-    } else {
-      auto container = this->graph.reverse_neighbors(v);
-      for (auto edge : container) {
-        this->traverse(v, edge.t, edge.lag);
-        if (!this->visited[edge.t]) {
-          this->dfs_rec(edge.t, v, reverse);
-        }
-      }
-    }
+  FlatLagGraph::ArcRange arcs = reverse ? graph.reverse_neighbors(v) : graph.neighbors(v);
+  if (!keep_going) {
+    arcs.first = arcs.last;
   }
+  this->stack.push_back({v, arcs.first, arcs.last});
+}
+
+template <typename visit_func, typename backtrack_func, typename traverse_func>
+void
+DFS<visit_func, backtrack_func, traverse_func>::run(const FlatLagGraph & graph, vertex start, bool reverse)
+{
+  this->enter(graph, start, LagGraph::no_vertex, reverse);
+
+  while (!this->stack.empty()) {
+    Frame & frame = this->stack.back();
+
+    if (frame.next == frame.end) {
+      vertex v = frame.v;
+      this->stack.pop_back();
+      this->backtrack(v);
+      continue;
+    }
+
+    vertex v = frame.v;
+    const FlatLagGraph::Arc & arc = *frame.next;
+    frame.next++;
 
-  this->backtrack(v);
+    // frame is invalid after enter()
+    this->traverse(v, arc.v, arc.lag);
+    if (!this->visited[arc.v]) {
+      this->enter(graph, arc.v, v, reverse);
+    }
+  }
 }
@@ -170,6 +170,15 @@ struct LocalStats {
 #if HAVE_THREAD_LOCAL
 static thread_local LocalStats tl_stats = { 0, 0, 0 };
 static const ssize_t tl_delay_threshold = 1024 * 1024;
+
+//! per-thread accounting, never flushed into the global counters
+struct ThreadStats {
+    size_t  total_allocs;
+    ssize_t curr;
+    ssize_t peak;
+};
+
+static thread_local ThreadStats tl_thread_stats = { 0, 0, 0 };
 #endif
 
 ATTRIBUTE_NO_SANITIZE
@@ -201,6 +210,11 @@ void flush_memory_statistics() {
 ATTRIBUTE_NO_SANITIZE
 static void inc_count(size_t inc) {
 #if HAVE_THREAD_LOCAL
+    tl_thread_stats.total_allocs++;
+    tl_thread_stats.curr += inc;
+    if (tl_thread_stats.curr > tl_thread_stats.peak)
+        tl_thread_stats.peak = tl_thread_stats.curr;
+
     tl_stats.total_allocs++;
     tl_stats.current_allocs++;
     tl_stats.bytes += inc;
@@ -224,6 +238,8 @@ static void inc_count(size_t inc) {
 ATTRIBUTE_NO_SANITIZE
 static void dec_count(size_t dec) {
 #if HAVE_THREAD_LOCAL
+    tl_thread_stats.curr -= dec;
+
     tl_stats.current_allocs--;
     tl_stats.bytes -= dec;
 
@@ -259,6 +275,42 @@ ssize_t malloc_tracker_total_allocs() {
     return total_allocs;
 }
 
+//! user function to return the memory currently allocated by this thread
+ssize_t malloc_tracker_thread_current() {
+#if HAVE_THREAD_LOCAL
+    return tl_thread_stats.curr;
+#else
+    return malloc_tracker_current();
+#endif
+}
+
+//! user function to return the peak allocation of this thread
+ssize_t malloc_tracker_thread_peak() {
+#if HAVE_THREAD_LOCAL
+    return tl_thread_stats.peak;
+#else
+    return malloc_tracker_peak();
+#endif
+}
+
+//! user function to reset the peak allocation of this thread to current
+void malloc_tracker_thread_reset_peak() {
+#if HAVE_THREAD_LOCAL
+    tl_thread_stats.peak = tl_thread_stats.curr;
+#else
+    malloc_tracker_reset_peak();
+#endif
+}
+
+//! user function to return the number of allocations by this thread
+ssize_t malloc_tracker_thread_total_allocs() {
+#if HAVE_THREAD_LOCAL
+    return static_cast<ssize_t>(tl_thread_stats.total_allocs);
+#else
+    return malloc_tracker_total_allocs();
+#endif
+}
+
 //! user function which prints current and peak allocation to stderr
 void malloc_tracker_print_status() {
     fprintf(stderr, PPREFIX "floating %zu, peak %zu, base %zu\n",
@@ -59,6 +59,20 @@ void malloc_tracker_reset_peak();
 //! returns the total number of allocations
 ssize_t malloc_tracker_total_allocs();
 
+//! returns the amount of memory currently allocated by the calling thread.
+//! Memory is attributed to the thread that allocates or frees it, so this may
+//! go negative if a thread frees memory that was allocated by another one.
+ssize_t malloc_tracker_thread_current();
+
+//! returns the peak memory allocation of the calling thread
+ssize_t malloc_tracker_thread_peak();
+
+//! resets the peak memory allocation of the calling thread to its current
+void malloc_tracker_thread_reset_peak();
+
+//! returns the total number of allocations by the calling thread
+ssize_t malloc_tracker_thread_total_allocs();
+
 //! user function which prints current and peak allocation to stderr
 void malloc_tracker_print_status();
 
@@ -0,0 +1,110 @@
+#ifndef TCPSPSUITE_BUCKET_ARENA_HPP
+#define TCPSPSUITE_BUCKET_ARENA_HPP
+
+#include <cstddef> // for size_t
+#include <limits>  // for numeric_limits
+#include <vector>  // for vector
+
+namespace ds {
+
+/* A fixed number of buckets of values, all stored in one flat array.
+ *
+ * This replaces a vector of vectors that is filled sparsely and cleared
+ * often. Every bucket is a singly linked list of entries in the flat array,
+ * so values can be added to any bucket without allocating once the array has
+ * grown large enough. Clearing only bumps a generation counter: a bucket
+ * whose stamp is from an older generation is empty. Thus, clearing is
+ * independent of the number of buckets.
+ *
+ * Values are visited in the order in which they were added to their bucket.
+ * The non-empty buckets can be listed in the order in which they were first
+ * used, so that callers do not have to scan all buckets.
+ */
+template <class T>
+class BucketArena {
+public:
+	explicit BucketArena(size_t bucket_count)
+	    : heads(bucket_count), tails(bucket_count), stamps(bucket_count, 0),
+	      generation(1)
+	{}
+
+	void
+	clear() noexcept
+	{
+		this->generation++;
+		this->entries.clear();
+		this->used_buckets.clear();
+	}
+
+	void
+	push_back(size_t bucket, const T & value)
+	{
+		size_t index = this->entries.size();
+		this->entries.push_back({value, NO_ENTRY});
+
+		if (this->stamps[bucket] != this->generation) {
+			this->stamps[bucket] = this->generation;
+			this->heads[bucket] = index;
+			this->used_buckets.push_back(bucket);
+		} else {
+			this->entries[this->tails[bucket]].next = index;
+		}
+		this->tails[bucket] = index;
+	}
+
+	bool
+	empty(size_t bucket) const noexcept
+	{
+		return this->stamps[bucket] != this->generation;
+	}
+
+	/* Calls fn(value) for every value in the bucket. */
+	template <class Fn>
+	void
+	for_each(size_t bucket, Fn && fn) const
+	{
+		if (this->empty(bucket)) {
+			return;
+		}
+		for (size_t index = this->heads[bucket]; index != NO_ENTRY;
+		     index = this->entries[index].next) {
+			fn(this->entries[index].value);
+		}
+	}
+
+	/* The non-empty buckets, in the order in which they were first used. */
+	const std::vector<size_t> &
+	get_used_buckets() const noexcept
+	{
+		return this->used_buckets;
+	}
+
+	/* Total number of values in all buckets. */
+	size_t
+	size() const noexcept
+	{
+		return this->entries.size();
+	}
+
+private:
+	static constexpr size_t NO_ENTRY = std::numeric_limits<size_t>::max();
+
+	struct Entry
+	{
+		T value;
+		size_t next;
+	};
+
+	std::vector<Entry> entries;
+	// Only valid for buckets stamped with the current generation
+	std::vector<size_t> heads;
+	std::vector<size_t> tails;
+	std::vector<size_t> stamps;
+	size_t generation;
+
+	std::vector<size_t> used_buckets;
+};
+
+} // namespace ds
+
+#endif
@@ -1,34 +1,66 @@
 #ifndef CIRCULAR_VECTOR_HPP
 #define CIRCULAR_VECTOR_HPP
 
-#include <vector>
 #include <cstdlib>
 #include <cstring>
-
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/* A growable ring buffer for use as FIFO or LIFO queue.
+ *
+ * Elements are moved around with memcpy, so only trivially copyable types are
+ * allowed. The capacity is always a power of two and never shrinks, so a
+ * buffer that is cleared and refilled does not allocate once it has grown
+ * large enough.
+ */
 template<class T>
 class CircularVector {
+	static_assert(std::is_trivially_copyable<T>::value,
+	              "CircularVector only supports trivially copyable types.");
 public:
 	// TODO configurable default size?
-	CircularVector() : is_empty(true), data(nullptr), i_start(0), i_end(0) {
-		this->data = (T*)malloc(16 * sizeof(T));
-		this->allocated = 16;
+	CircularVector() : is_empty(true), data(nullptr), allocated(16), i_start(0), i_end(0) {
+		this->data = (T*)malloc(this->allocated * sizeof(T));
+		if (this->data == nullptr) {
+			throw std::bad_alloc();
+		}
 	};
 
+	CircularVector(const CircularVector &) = delete;
+	CircularVector & operator=(const CircularVector &) = delete;
+
+	// A moved-from CircularVector may only be destroyed or assigned to.
+	CircularVector(CircularVector && other) noexcept
+		: is_empty(other.is_empty), data(other.data), allocated(other.allocated),
+		  i_start(other.i_start), i_end(other.i_end)
+	{
+		other.data = nullptr;
+		other.allocated = 0;
+		other.clear();
+	}
+
+	CircularVector & operator=(CircularVector && other) noexcept {
+		std::swap(this->is_empty, other.is_empty);
+		std::swap(this->data, other.data);
+		std::swap(this->allocated, other.allocated);
+		std::swap(this->i_start, other.i_start);
+		std::swap(this->i_end, other.i_end);
+		return *this;
+	}
+
 	~CircularVector() {
 		free(this->data);
 	}
 
 	void clear() noexcept {
-		this->i_end = this->i_start;
+		this->i_start = 0;
+		this->i_end = 0;
 		this->is_empty = true;
 	}
 
 	T & back() const {
-		if (this->i_end > 0) {
-			return this->data[this->i_end - 1];
-		} else {
-			return this->data[this->allocated - 1];
-		}
+		return this->data[(this->i_end - 1) & (this->allocated - 1)];
 	}
 
 	T & front() const {
@@ -42,20 +74,13 @@ public:
 		}
 
 		this->data[i_end] = std::forward<InnerT>(value);
-		this->i_end++;
-		if (this->i_end == this->allocated) {
-			this->i_end = 0;
-		}
+		this->i_end = (this->i_end + 1) & (this->allocated - 1);
 		
 		this->is_empty = false;
 	}
 
 	void pop_back() noexcept {
-		if (__builtin_expect(this->i_end == 0, false)) {
-			this->i_end = this->allocated - 1;
-		} else {
-			this->i_end--;
-		}
+		this->i_end = (this->i_end - 1) & (this->allocated - 1);
 
 		if (__builtin_expect(this->i_end == this->i_start, false)) {
 			this->is_empty = true;
@@ -63,11 +88,7 @@ public:
 	}
 
 	void pop_front() noexcept {
-		if (__builtin_expect(this->i_start == this->allocated - 1, false)) {
-			this->i_start = 0;
-		} else {
-			this->i_start++;
-		}
+		this->i_start = (this->i_start + 1) & (this->allocated - 1);
 		
 		if (__builtin_expect(this->i_end == this->i_start, false)) {
 			this->is_empty = true;
@@ -80,48 +101,53 @@ public:
 			this->grow();
 		}
 
-		// TODO after growing, the expectation is wrong.
-		if (__builtin_expect((this->i_start == 0), false)) {
-			this->i_start = this->allocated - 1;
-		} else {
-			this->i_start--;
-		}
-
+		this->i_start = (this->i_start - 1) & (this->allocated - 1);
 		this->data[this->i_start] = std::forward<InnerT>(value);
 
 		this->is_empty = false;
 	}
 
 	T & operator[](size_t index) noexcept {
-		return this->data[(this->i_start + index) % this->allocated];
+		return this->data[(this->i_start + index) & (this->allocated - 1)];
+	}
+
+	const T & operator[](size_t index) const noexcept {
+		return this->data[(this->i_start + index) & (this->allocated - 1)];
 	}
 
 	size_t size() const noexcept {
-		if (this->i_start < this->i_end) {
-			return this->i_end - this->i_start;
-		} else if (this->i_start > this->i_end) {
-			return (this->allocated - this->i_start + this->i_end);
-		} else if (!this->is_empty) {
+		if (!this->is_empty && (this->i_start == this->i_end)) {
 			return this->allocated;
-		} else {
-			return 0;
 		}
+		return (this->i_end - this->i_start) & (this->allocated - 1);
 	}
 
 	bool empty() const noexcept {
 		return this->is_empty;
 	}
 
+	size_t capacity() const noexcept {
+		return this->allocated;
+	}
+
 private:
+	// Only called when full. Unrolls the contents to the start of a buffer of
+	// twice the size.
 	void grow() {
 		T * new_data = (T*) malloc(sizeof(T) * this->allocated * 2);
+		if (new_data == nullptr) {
+			throw std::bad_alloc();
+		}
 
-		// TODO copy into the middle?
-		std::memcpy(new_data, this->data + this->i_start, this->allocated - this->i_start);
-		std::memcpy(new_data + (this->allocated - this->i_start), this->data, this->i_end);
+		size_t first_part = this->allocated - this->i_start;
+		std::memcpy(new_data, this->data + this->i_start, first_part * sizeof(T));
+		std::memcpy(new_data + first_part, this->data, this->i_end * sizeof(T));
 
 		free(this->data);
 		this->data = new_data;
+		this->i_start = 0;
+		this->i_end = this->allocated;
+		this->allocated *= 2;
 	}
 
 	bool is_empty;
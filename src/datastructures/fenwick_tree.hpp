@@ -0,0 +1,128 @@
+#ifndef TCPSPSUITE_FENWICK_TREE_HPP
+#define TCPSPSUITE_FENWICK_TREE_HPP
+
+#include <cassert> // for assert
+#include <cstddef> // for size_t
+#include <vector>  // for vector
+
+namespace ds {
+
+/* A Fenwick (binary indexed) tree over non-negative weights, used for
+ * weighted random sampling.
+ *
+ * Building is linear, everything else is logarithmic in the number of
+ * weights. Apart from changing single weights, the last weight can be
+ * removed, which together with swapping the last weight into a removed
+ * position gives the same "swap and pop" removal that plain vectors offer.
+ */
+template <class T>
+class FenwickTree {
+public:
+	FenwickTree() : nodes(1, T(0)) {}
+
+	/* Builds the tree from the weights in [begin, end), reading each weight
+	 * through get_weight. */
+	template <class It, class Getter>
+	void
+	build(It begin, It end, Getter && get_weight)
+	{
+		this->nodes.resize(1);
+		for (It it = begin; it != end; ++it) {
+			this->nodes.push_back(get_weight(*it));
+		}
+
+		size_t n = this->size();
+		for (size_t i = 1; i <= n; ++i) {
+			size_t parent = i + (i & (~i + 1));
+			if (parent <= n) {
+				this->nodes[parent] += this->nodes[i];
+			}
+		}
+	}
+
+	void
+	clear() noexcept
+	{
+		this->nodes.resize(1);
+	}
+
+	size_t
+	size() const noexcept
+	{
+		return this->nodes.size() - 1;
+	}
+
+	bool
+	empty() const noexcept
+	{
+		return this->nodes.size() == 1;
+	}
+
+	/* Adds delta to the weight at (zero-based) index. */
+	void
+	add(size_t index, T delta) noexcept
+	{
+		for (size_t i = index + 1; i < this->nodes.size(); i += (i & (~i + 1))) {
+			this->nodes[i] += delta;
+		}
+	}
+
+	/* Removes the last weight. No node below the last one covers it, so the
+	 * remaining prefix sums stay intact. */
+	void
+	pop_back() noexcept
+	{
+		assert(!this->empty());
+		this->nodes.pop_back();
+	}
+
+	/* Sum of the weights in [0, count). */
+	T
+	prefix_sum(size_t count) const noexcept
+	{
+		T sum = T(0);
+		for (size_t i = count; i > 0; i -= (i & (~i + 1))) {
+			sum += this->nodes[i];
+		}
+		return sum;
+	}
+
+	T
+	total() const noexcept
+	{
+		return this->prefix_sum(this->size());
+	}
+
+	/* Returns the smallest index whose inclusive prefix sum exceeds point,
+	 * i.e., the index hit by point when the weights are laid out one after
+	 * the other. Points beyond the total (e.g., from rounding) hit the last
+	 * index. Must not be called on an empty tree. */
+	size_t
+	find(T point) const noexcept
+	{
+		assert(!this->empty());
+		size_t n = this->size();
+		size_t step = 1;
+		while ((step << 1) <= n) {
+			step <<= 1;
+		}
+
+		size_t pos = 0;
+		for (; step > 0; step >>= 1) {
+			if ((pos + step <= n) && (this->nodes[pos + step] <= point)) {
+				pos += step;
+				point -= this->nodes[pos];
+			}
+		}
+
+		return (pos < n) ? pos : n - 1;
+	}
+
+private:
+	// One-based, nodes[0] is unused
+	std::vector<T> nodes;
+};
+
+} // namespace ds
+
+#endif // TCPSPSUITE_FENWICK_TREE_HPP
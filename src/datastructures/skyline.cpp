@@ -16,8 +16,8 @@ namespace ds {
  */
 template <bool support_it>
 ArraySkyLineBase<support_it>::ArraySkyLineBase(const Instance * instance_in)
-    : instance(instance_in), usage(instance->resource_count()),
-      start_times(instance->job_count())
+    : instance(instance_in), maximum_range_version(0),
+      usage(instance->resource_count()), start_times(instance->job_count())
 {
   unsigned int max_deadline = 0;
   for (unsigned int jid = 0; jid < this->instance->job_count(); ++jid) {
@@ -46,6 +46,8 @@ template <bool support_it>
 void
 ArraySkyLineBase<support_it>::remove_job(const Job & job) noexcept
 {
+  this->maximum_range_version++;
+
   for (unsigned int rid = 0; rid < this->instance->resource_count(); ++rid) {
     double u = job.get_resource_usage(rid);
 
@@ -77,6 +79,7 @@ void
 ArraySkyLineBase<support_it>::insert_job(const Job & job,
                                          unsigned int pos) noexcept
 {
+  this->maximum_range_version++;
   this->start_times[job.get_jid()] = pos;
 
   for (unsigned int rid = 0; rid < this->instance->resource_count(); ++rid) {
@@ -98,6 +101,7 @@ void
 ArraySkyLineBase<support_it>::set_pos(const Job & job,
                                       unsigned int pos) noexcept
 {
+  this->maximum_range_version++;
   unsigned int jid = job.get_jid();
 
   if (pos < this->start_times[jid]) {
@@ -239,6 +243,13 @@ ArraySkyLineBase<support_it>::get_maximum_range() const noexcept
   return this->get_maximum_range(0, (unsigned int)this->usage[0].size());
 }
 
+template <bool support_it>
+size_t
+ArraySkyLineBase<support_it>::get_maximum_range_version() const noexcept
+{
+  return this->maximum_range_version;
+}
+
 template <bool support_it>
 typename ArraySkyLineBase<support_it>::iterator
 ArraySkyLineBase<support_it>::begin() noexcept
@@ -648,7 +659,8 @@ TreeSkyLineBase<ranged, single_resource>::JobNodeTraits::get_value(
 template <bool ranged, bool single_resource>
 TreeSkyLineBase<ranged, single_resource>::TreeSkyLineBase(
     const Instance * instance_in)
-    : instance(instance_in), nodes(this->instance->job_count())
+    : instance(instance_in), nodes(this->instance->job_count()),
+      nodes_in_tree(0), maximum_range_version(0), tracked_maximum_range(0, 0)
 {
   for (size_t jid = 0; jid < this->instance->job_count(); ++jid) {
     if constexpr (!single_resource) {
@@ -679,16 +691,65 @@ void
 TreeSkyLineBase<ranged, single_resource>::set_pos(Job::JobId jid,
                                                   unsigned int pos) noexcept
 {
-  this->remove_job(jid);
-  this->insert_job(jid, pos);
+  // Only the final state counts - the range may well move back and forth
+  // between removal and insertion.
+  this->remove_node(jid);
+  this->insert_node(jid, pos);
+  this->track_maximum_range();
 }
 
 template <bool ranged, bool single_resource>
 void
-TreeSkyLineBase<ranged, single_resource>::remove_job(Job::JobId jid) noexcept
+TreeSkyLineBase<ranged, single_resource>::remove_node(Job::JobId jid) noexcept
 {
   Node & n = this->nodes[jid];
   this->t.remove(n);
+  this->nodes_in_tree--;
+}
+
+template <bool ranged, bool single_resource>
+void
+TreeSkyLineBase<ranged, single_resource>::insert_node(Job::JobId jid,
+                                                      unsigned int pos) noexcept
+{
+  Node & n = this->nodes[jid];
+  n.start = pos;
+  this->t.insert(n);
+  this->nodes_in_tree++;
+}
+
+template <bool ranged, bool single_resource>
+void
+TreeSkyLineBase<ranged, single_resource>::track_maximum_range() noexcept
+{
+  if constexpr (ranged) {
+    MaxRange range{0, 0};
+    if (this->nodes_in_tree > 0) {
+      range = this->get_maximum_range();
+    }
+    if (range != this->tracked_maximum_range) {
+      this->tracked_maximum_range = range;
+      this->maximum_range_version++;
+    }
+  } else {
+    this->maximum_range_version++;
+  }
+}
+
+template <bool ranged, bool single_resource>
+size_t
+TreeSkyLineBase<ranged, single_resource>::get_maximum_range_version() const
+    noexcept
+{
+  return this->maximum_range_version;
+}
+
+template <bool ranged, bool single_resource>
+void
+TreeSkyLineBase<ranged, single_resource>::remove_job(Job::JobId jid) noexcept
+{
+  this->remove_node(jid);
+  this->track_maximum_range();
 }
 
 template <bool ranged, bool single_resource>
@@ -703,9 +764,8 @@ void
 TreeSkyLineBase<ranged, single_resource>::insert_job(Job::JobId jid,
                                                      unsigned int pos) noexcept
 {
-  Node & n = this->nodes[jid];
-  n.start = pos;
-  this->t.insert(n);
+  this->insert_node(jid, pos);
+  this->track_maximum_range();
 }
 
 template <bool ranged, bool single_resource>
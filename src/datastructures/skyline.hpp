@@ -133,6 +133,10 @@ public:
 	MaxRange get_maximum_range() const noexcept;
 	MaxRange get_maximum_range(unsigned int l, unsigned int r) const noexcept;
 
+	/* Changes whenever the maximum range might have changed. Finding the range
+	 * is linear here, so this is bumped on every modification. */
+	size_t get_maximum_range_version() const noexcept;
+
 	iterator begin() noexcept;
 	iterator end() noexcept;
 
@@ -142,6 +146,8 @@ public:
 private:
 	const Instance * const instance;
 
+	size_t maximum_range_version;
+
 	// TODO outer vector should be a small_vector
 	// usage[rid][timepoint]
 	std::vector<std::vector<double>> usage;
@@ -295,6 +301,13 @@ public:
 	MaxRange get_maximum_range() const noexcept;
 	MaxRange get_maximum_range(unsigned int l, unsigned int r) const noexcept;
 
+	/* Changes whenever the maximum range might have changed. For ranged
+	 * skylines, the range is checked after every modification and this only
+	 * changes if the range actually moved, so callers can compare versions
+	 * instead of polling get_maximum_range(). Skylines that can't tell the
+	 * range bump this on every modification. */
+	size_t get_maximum_range_version() const noexcept;
+
 	iterator begin();
 	iterator end();
 
@@ -302,8 +315,16 @@ public:
 	iterator upper_bound(unsigned int x);
 
 private:
+	void remove_node(Job::JobId jid) noexcept;
+	void insert_node(Job::JobId jid, unsigned int pos) noexcept;
+	void track_maximum_range() noexcept;
+
 	const Instance * const instance;
 	std::vector<Node> nodes;
+
+	size_t nodes_in_tree;
+	size_t maximum_range_version;
+	MaxRange tracked_maximum_range;
 };
 } // namespace ds
 
@@ -53,6 +53,7 @@ struct SkyLineInterface
           "get_maximum_range__unbounded"_s = dyno::method<MaxRange() const>,
           "get_maximum_range__bounded"_s =
               dyno::method<MaxRange(unsigned int, unsigned int) const>,
+          "get_maximum_range_version"_s = dyno::method<size_t() const>,
 
           "begin"_s = dyno::method<SkyLineIterator()>,
           "end"_s = dyno::method<SkyLineIterator()>,
@@ -122,6 +123,8 @@ auto const
             [](const T & self, unsigned int lb, unsigned int ub) {
 	            return self.get_maximum_range(lb, ub);
             },
+        "get_maximum_range_version"_s =
+            [](const T & self) { return self.get_maximum_range_version(); },
         "begin"_s = [](T & self) { return ds::SkyLineIterator(self.begin()); },
         "end"_s = [](T & self) { return ds::SkyLineIterator(self.end()); },
         "lower_bound"_s = [](T & self,
@@ -282,6 +285,12 @@ public:
 		return poly_.virtual_("get_maximum_range__bounded"_s)(lb, ub);
 	}
 
+	size_t
+	get_maximum_range_version() const noexcept
+	{
+		return poly_.virtual_("get_maximum_range_version"_s)();
+	}
+
 	SkyLineIterator
 	begin() noexcept
 	{
@@ -14,6 +14,7 @@
 #include "db_objects-odb.hxx"
 #include "generated_config.hpp"
 
+#include <algorithm>
 #include <boost/asio/ip/host_name.hpp>
 #include <chrono>
 #include <ctime>
@@ -193,8 +194,12 @@ Storage::insert(const Solution & sol, const std::string & run_id,
 #else
 				odb::nullable<size_t> malloc_count;
 				odb::nullable<size_t> malloc_max_size;
-				odb::nullable<size_t> rss_bytes_max(mem_info->get_rss_bytes_max());
-				odb::nullable<size_t> data_bytes_max(mem_info->get_data_bytes_max());
+				odb::nullable<size_t> rss_bytes_max;
+				odb::nullable<size_t> data_bytes_max;
+				if (mem_info->has_process_data()) {
+					rss_bytes_max = mem_info->get_rss_bytes_max();
+					data_bytes_max = mem_info->get_data_bytes_max();
+				}
 #endif
 
 				std::shared_ptr<DBResourcesInfo> res_info(new DBResourcesInfo(
@@ -260,6 +265,15 @@ Storage::insert_intermediate_result(
 	                               intermediate.costs, intermediate.bound,
 	                               solution);
 	this->db->persist(db_intermediate);
+
+	// The intermediates table has no column for the source, so it is stored as
+	// an extended measure with the same time / iteration.
+	if (intermediate.source.valid()) {
+		this->insert_extended_measure(
+		    res, {"INTERMEDIATE_SOURCE", intermediate.iteration, intermediate.time,
+		          AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+		          {static_cast<int>(intermediate.source.value())}});
+	}
 }
 
 void
@@ -593,6 +607,107 @@ Storage::get_results_for_config(const SolverConfig & sc)
 	return {};
 }
 
+Maybe<double>
+Storage::get_mean_elapsed(const std::string & config_name,
+                          unsigned int max_samples)
+{
+	for (unsigned int trial = 0; trial < this->retry_count; ++trial) {
+		try {
+			odb::transaction t(this->db->begin());
+			odb::session s;
+
+			using query = odb::query<DBResult>;
+			auto r = this->db->query<DBResult>(
+			    (query::config == query::_val(config_name)) + "ORDER BY" +
+			    query::time + "DESC LIMIT" + query::_val(max_samples));
+
+			double elapsed_sum = 0;
+			unsigned int count = 0;
+			for (auto i = r.begin(); i != r.end(); ++i) {
+				elapsed_sum += i->elapsed;
+				count++;
+			}
+
+			if (count == 0) {
+				return Maybe<double>();
+			}
+			return Maybe<double>(elapsed_sum / count);
+		} catch (odb::recoverable & recoverable) {
+			BOOST_LOG(l.w()) << "Database get_mean_elapsed() operation failed. Try "
+			                 << (trial + 1) << "...";
+			BOOST_LOG(l.w()) << "Error message: " << recoverable.what();
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			continue;
+		}
+	}
+	BOOST_LOG(l.e()) << "Too many database failures. Assuming no history.";
+	return Maybe<double>();
+}
+
+Maybe<size_t>
+Storage::get_peak_memory(const std::string & config_name,
+                         unsigned int max_samples)
+{
+	for (unsigned int trial = 0; trial < this->retry_count; ++trial) {
+		try {
+			odb::transaction t(this->db->begin());
+			odb::session s;
+
+			using query = odb::query<DBResourcesInfo>;
+			auto r = this->db->query<DBResourcesInfo>(
+			    (query::res->config == query::_val(config_name)) + "ORDER BY" +
+			    query::res->time + "DESC LIMIT" + query::_val(max_samples));
+
+			std::vector<MemorySample> samples;
+			for (auto i = r.begin(); i != r.end(); ++i) {
+				MemorySample sample;
+				if (!i->max_rss_size.null()) {
+					sample.rss_bytes_max = i->max_rss_size.get();
+				}
+				if (!i->max_data_size.null()) {
+					sample.data_bytes_max = i->max_data_size.get();
+				}
+				if (!i->malloc_max_size.null()) {
+					sample.malloc_max_size = i->malloc_max_size.get();
+				}
+				samples.push_back(sample);
+			}
+
+			return Storage::get_peak(samples);
+		} catch (odb::recoverable & recoverable) {
+			BOOST_LOG(l.w()) << "Database get_peak_memory() operation failed. Try "
+			                 << (trial + 1) << "...";
+			BOOST_LOG(l.w()) << "Error message: " << recoverable.what();
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			continue;
+		}
+	}
+	BOOST_LOG(l.e()) << "Too many database failures. Assuming no history.";
+	return Maybe<size_t>();
+}
+
+Maybe<size_t>
+Storage::get_peak(const std::vector<MemorySample> & samples)
+{
+	size_t peak = 0;
+	bool found = false;
+	for (const MemorySample & sample : samples) {
+		if (sample.rss_bytes_max.valid() && sample.data_bytes_max.valid()) {
+			peak = std::max(peak, sample.rss_bytes_max.value());
+			found = true;
+		}
+		if (sample.malloc_max_size.valid()) {
+			peak = std::max(peak, sample.malloc_max_size.value());
+			found = true;
+		}
+	}
+
+	if (!found) {
+		return Maybe<size_t>();
+	}
+	return Maybe<size_t>(peak);
+}
+
 std::shared_ptr<DBConfig>
 Storage::get_or_insert_solverconfig(const SolverConfig & sc)
 {
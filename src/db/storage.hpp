@@ -35,11 +35,16 @@ public:
 	struct IntermediateResult
 	{
 	public:
+		// Which solver produced the result if several ran concurrently
+		constexpr static unsigned int SOURCE_MIP = 1;
+		constexpr static unsigned int SOURCE_HEURISTIC = 2;
+
 		Maybe<double> time;
 		Maybe<unsigned int> iteration;
 		Maybe<double> costs;
 		Maybe<double> bound;
 		Maybe<Solution> solution;
+		Maybe<unsigned int> source;
 	};
 
 	struct ExtendedMeasure
@@ -101,6 +106,35 @@ public:
 	std::vector<std::shared_ptr<DBResult>>
 	get_results_for_config(const SolverConfig & sc);
 
+	/* Returns the mean elapsed time over the (at most max_samples) most recent
+	 * results stored for the given config name, regardless of instance and
+	 * run. Invalid if no such results exist. */
+	Maybe<double> get_mean_elapsed(const std::string & config_name,
+	                               unsigned int max_samples = 100);
+
+	/* Returns the largest peak memory usage (in bytes) among the (at most
+	 * max_samples) most recent resource measurements stored for the given
+	 * config name, regardless of instance, see get_peak(). Invalid if no
+	 * usable measurements exist. */
+	Maybe<size_t> get_peak_memory(const std::string & config_name,
+	                              unsigned int max_samples = 100);
+
+	/* The memory columns of one stored resource measurement */
+	struct MemorySample
+	{
+		Maybe<size_t> rss_bytes_max;
+		Maybe<size_t> data_bytes_max;
+		Maybe<size_t> malloc_max_size;
+	};
+
+	/* The largest peak among the samples, taking the RSS or the malloc()
+	 * peak, whichever is larger. The RSS is only taken from samples that
+	 * measured the whole process, recognizable by the DATA size being
+	 * present. Runs measured per thread used to store page faults there,
+	 * which can be far above the real peak. Invalid if no sample has a
+	 * usable figure. */
+	static Maybe<size_t> get_peak(const std::vector<MemorySample> & samples);
+
 	std::shared_ptr<DBConfig>
 	find_equivalent_config(std::shared_ptr<DBConfig> src);
 
@@ -1,5 +1,10 @@
 #include "grasp.hpp"
 
+#include "../manager/checkpoint.hpp"
+#include "../manager/errors.hpp"
+#include "../manager/incumbentexchange.hpp"
+#include "../util/fault_codes.hpp"
+
 #include <algorithm>
 #include <numeric>
 #include <queue>
@@ -28,6 +33,42 @@ detail::GraspRandom::getName()
 	return "random";
 }
 
+void
+detail::GraspRandom::save(manager::CheckpointWriter & out) const
+{
+	out.write(random);
+	// The shuffles build on each other
+	std::vector<unsigned int> order;
+	for (const Job * job : jobs) {
+		order.push_back(job->get_jid());
+	}
+	out.write(order);
+}
+
+void
+detail::GraspRandom::load(manager::CheckpointReader & in)
+{
+	std::vector<unsigned int> order;
+	in.read(random);
+	in.read(order);
+	if (!in.good() || (order.size() != jobs.size())) {
+		in.fail();
+		return;
+	}
+
+	std::vector<const Job *> byJid(jobs.size(), nullptr);
+	for (const Job * job : jobs) {
+		byJid[job->get_jid()] = job;
+	}
+	for (size_t i = 0; i < order.size(); ++i) {
+		if (order[i] >= byJid.size()) {
+			in.fail();
+			return;
+		}
+		jobs[i] = byJid[order[i]];
+	}
+}
+
 detail::GraspSorted::GraspSorted(const Instance & instance,
                                  const SolverConfig & sconf)
 {
@@ -52,6 +93,19 @@ detail::GraspSorted::getName()
 	return "sorted";
 }
 
+void
+detail::GraspSorted::save(manager::CheckpointWriter & out) const
+{
+	// Stateless
+	(void)out;
+}
+
+void
+detail::GraspSorted::load(manager::CheckpointReader & in)
+{
+	(void)in;
+}
+
 implementation::GraspArray::GraspArray(const Instance & in,
                                        const SolverConfig & sconf,
                                        const Timer & timer_in)
@@ -194,6 +248,19 @@ implementation::GraspArray::getName()
 	return "array";
 }
 
+void
+implementation::GraspArray::save(manager::CheckpointWriter & out) const
+{
+	// The usage is rebuilt from the start times on every call
+	out.write(random);
+}
+
+void
+implementation::GraspArray::load(manager::CheckpointReader & in)
+{
+	in.read(random);
+}
+
 implementation::GraspSkyline::GraspSkyline(const Instance & in,
                                            const SolverConfig & sconf,
                                            const Timer & timer_in)
@@ -306,6 +373,19 @@ implementation::GraspSkyline::getName()
 	return "skyline";
 }
 
+void
+implementation::GraspSkyline::save(manager::CheckpointWriter & out) const
+{
+	// The usage is rebuilt from the start times on every call
+	out.write(random);
+}
+
+void
+implementation::GraspSkyline::load(manager::CheckpointReader & in)
+{
+	in.read(random);
+}
+
 void
 implementation::GraspSkyline::updateUsage(std::vector<unsigned int> & s)
 {
@@ -338,8 +418,10 @@ GRASP<GraspAlgorithm, GraspImplementation>::GRASP(
               : 0),
       lastIntermediateTime(0),
       writeTempResult(!sconf.has_config("writeTemp") || sconf["writeTemp"]),
+      seed(sconf.get_seed()),
       random(sconf.was_seed_set() ? (unsigned long)sconf.get_seed() : 42ul),
-      permutation(instance_in.job_count())
+      permutation(instance_in.job_count()), exchange(nullptr),
+      exchangeVersion(0), checkpoint(nullptr)
 {
 	(void)additional;
 	if (!sconf.get_time_limit().valid()) {
@@ -360,6 +442,9 @@ GRASP<GraspAlgorithm, GraspImplementation>::run()
 	unsigned int iteration = 0;
 	double graspTime = 0;
 	double hillClimberTime = 0;
+	if ((this->checkpoint != nullptr) && this->checkpoint->can_resume()) {
+		resumeFromCheckpoint(iteration, graspTime, hillClimberTime);
+	}
 	while (this->timer.get() < this->timelimit) {
 		iteration++;
 		double start;
@@ -377,7 +462,7 @@ GRASP<GraspAlgorithm, GraspImplementation>::run()
 				storage.intermediate_results.push_back(
 				    {Maybe<double>(time), Maybe<unsigned int>(iteration),
 				     Maybe<double>(this->bestCosts), Maybe<double>(),
-				     Maybe<Solution>()});
+				     Maybe<Solution>(), Maybe<unsigned int>()});
 				this->lastIntermediateTime = time;
 			}
 		}
@@ -385,12 +470,19 @@ GRASP<GraspAlgorithm, GraspImplementation>::run()
 		if (writeTempResult) {
 			storage.intermediate_results.push_back(
 			    {Maybe<double>(timer.get()), Maybe<unsigned int>(iteration),
-			     Maybe<double>(costs), Maybe<double>(), Maybe<Solution>()});
+			     Maybe<double>(costs), Maybe<double>(), Maybe<Solution>(),
+			     Maybe<unsigned int>()});
 		}
 		if (costs < bestCosts) {
 			bestStarts = starts;
 			bestCosts = costs;
 			nextReset = resetCount;
+			if (this->exchange != nullptr) {
+				this->exchange->offer(
+				    bestStarts,
+				    AdditionalResultStorage::IntermediateResult::SOURCE_HEURISTIC,
+				    Maybe<unsigned int>(iteration));
+			}
 		} else {
 			nextReset--;
 			if (resetCount != 0 && nextReset == 0) {
@@ -399,6 +491,18 @@ GRASP<GraspAlgorithm, GraspImplementation>::run()
 				nextReset = resetCount;
 			}
 		}
+
+		if (this->exchange != nullptr) {
+			this->synchronize();
+			if (this->exchange->should_stop()) {
+				break;
+			}
+		}
+
+		if ((this->checkpoint != nullptr) &&
+		    this->checkpoint->is_due(timer.get())) {
+			saveCheckpoint(iteration, graspTime, hillClimberTime);
+		}
 	}
 	storage.extended_measures.push_back(
 	    {"iterations", iteration, this->timelimit,
@@ -442,6 +546,104 @@ GRASP<GraspAlgorithm, GraspImplementation>::get_requirements()
 	return required_traits;
 }
 
+template <typename GraspAlgorithm, typename GraspImplementation>
+void
+GRASP<GraspAlgorithm, GraspImplementation>::set_incumbent_exchange(
+    manager::IncumbentExchange * exchange_in)
+{
+	this->exchange = exchange_in;
+}
+
+template <typename GraspAlgorithm, typename GraspImplementation>
+void
+GRASP<GraspAlgorithm, GraspImplementation>::set_checkpoint(
+    manager::Checkpoint * checkpoint_in)
+{
+	this->checkpoint = checkpoint_in;
+}
+
+template <typename GraspAlgorithm, typename GraspImplementation>
+void
+GRASP<GraspAlgorithm, GraspImplementation>::saveCheckpoint(
+    unsigned int iteration, double graspTime, double hillClimberTime)
+{
+	manager::CheckpointWriter out;
+	out.write(iteration);
+	out.write(graspTime);
+	out.write(hillClimberTime);
+	out.write(bestCosts);
+	out.write(bestStarts);
+	out.write(starts);
+	out.write(nextReset);
+	out.write(lastIntermediateTime);
+	out.write(random);
+	out.write(permutation);
+	graspAlgorithm.save(out);
+	graspImplementation.save(out);
+
+	this->checkpoint->write(out, timer.get());
+}
+
+template <typename GraspAlgorithm, typename GraspImplementation>
+void
+GRASP<GraspAlgorithm, GraspImplementation>::resumeFromCheckpoint(
+    unsigned int & iteration, double & graspTime, double & hillClimberTime)
+{
+	manager::CheckpointReader in = this->checkpoint->resume();
+	in.read(iteration);
+	in.read(graspTime);
+	in.read(hillClimberTime);
+	in.read(bestCosts);
+	in.read(bestStarts);
+	in.read(starts);
+	in.read(nextReset);
+	in.read(lastIntermediateTime);
+	in.read(random);
+	in.read(permutation);
+	graspAlgorithm.load(in);
+	graspImplementation.load(in);
+
+	if (!in.good() || !in.at_end() ||
+	    (bestStarts.size() != instance.job_count()) ||
+	    (starts.size() != instance.job_count()) ||
+	    (permutation.size() != instance.job_count())) {
+		BOOST_LOG(l.e()) << "Checkpoint " << this->checkpoint->get_path()
+		                 << " does not fit this instance and configuration.";
+		throw IOError(instance, this->seed, FAULT_CHECKPOINT_FAILED,
+		              "Could not resume GRASP from checkpoint " +
+		                  this->checkpoint->get_path());
+	}
+
+	// Continue the clock where the interrupted run stopped. The
+	// implementations share this timer.
+	this->timer.start_at(this->checkpoint->get_previous_elapsed());
+
+	BOOST_LOG(l.i()) << "Resumed at iteration " << iteration
+	                 << " with costs " << bestCosts;
+}
+
+template <typename GraspAlgorithm, typename GraspImplementation>
+void
+GRASP<GraspAlgorithm, GraspImplementation>::synchronize()
+{
+	std::vector<unsigned int> incumbent;
+	double incumbentCosts;
+	if (!this->exchange->fetch(
+	        AdditionalResultStorage::IntermediateResult::SOURCE_HEURISTIC,
+	        this->exchangeVersion, incumbent, incumbentCosts)) {
+		return;
+	}
+
+	// The exchange only keeps improvements, so this beats everything we have
+	// found so far. Restart the search from it.
+	BOOST_LOG(l.d(2)) << "Restarting from external incumbent with costs "
+	                  << incumbentCosts;
+	bestStarts = incumbent;
+	starts = std::move(incumbent);
+	bestCosts = instance.calculate_max_costs(bestStarts);
+	nextReset = resetCount;
+}
+
 template <typename GraspAlgorithm, typename GraspImplementation>
 void
 GRASP<GraspAlgorithm, GraspImplementation>::grasp()
@@ -18,6 +18,13 @@
 
 #include <typeinfo>
 
+namespace manager {
+class IncumbentExchange;
+class Checkpoint;
+class CheckpointWriter;
+class CheckpointReader;
+}
+
 namespace grasp {
   namespace detail {
     class GraspRandom {
@@ -27,6 +34,9 @@ namespace grasp {
       std::vector<const Job*> operator()();
 
       static std::string getName();
+
+      void save(manager::CheckpointWriter& out) const;
+      void load(manager::CheckpointReader& in);
       
     private:
       std::mt19937 random;
@@ -40,6 +50,9 @@ namespace grasp {
       std::vector<const Job*> operator()();
 
       static std::string getName();
+
+      void save(manager::CheckpointWriter& out) const;
+      void load(manager::CheckpointReader& in);
       
     private:
       std::vector<const Job*> jobs;
@@ -55,6 +68,9 @@ namespace grasp {
 
       static std::string getName();
 
+      void save(manager::CheckpointWriter& out) const;
+      void load(manager::CheckpointReader& in);
+
     private:
       const Instance& instance;
 	    const Timer & timer;
@@ -77,6 +93,9 @@ namespace grasp {
 
       static std::string getName();
 
+      void save(manager::CheckpointWriter& out) const;
+      void load(manager::CheckpointReader& in);
+
     private:
       const Instance& instance;
 	    const Timer & timer;
@@ -125,9 +144,18 @@ namespace grasp {
 	  double lastIntermediateTime;
     const bool writeTempResult;
     
+    // The configured seed, for error reports
+    const int seed;
     std::mt19937 random;
     std::vector<unsigned int> permutation;
 
+    /* Sharing incumbents with a concurrently running MIP */
+    manager::IncumbentExchange * exchange;
+    size_t exchangeVersion;
+
+    /* Saving and resuming long runs */
+    manager::Checkpoint * checkpoint;
+
   public:
     /**
      * Constructs a new solver
@@ -179,8 +207,29 @@ namespace grasp {
      */
     static const Traits &get_requirements();
 
+    /**
+     * Shares incumbents with other solvers running concurrently. Improvements
+     * are offered to the exchange, better incumbents found by others replace
+     * the current (and best) solution, and the run ends as soon as the
+     * exchange asks to stop.
+     *
+     * @param exchange_in  The exchange, must outlive run()
+     */
+    void set_incumbent_exchange(manager::IncumbentExchange * exchange_in);
+
+    /**
+     * Periodically saves the search state to the checkpoint, and continues
+     * from the state stored in it if there is one.
+     *
+     * @param checkpoint_in  The checkpoint, must outlive run()
+     */
+    void set_checkpoint(manager::Checkpoint * checkpoint_in);
+
   private:
   
+    void synchronize();
+    void saveCheckpoint(unsigned int iteration, double graspTime, double hillClimberTime);
+    void resumeFromCheckpoint(unsigned int& iteration, double& graspTime, double& hillClimberTime);
     void grasp();
     double hillClimber();    
     std::vector<ResVec> resourceUsage(std::vector<unsigned int>& s);
@@ -4,16 +4,21 @@
 
 #include "dtilp.hpp"
 
+#include "../baselines/earlyscheduler.hpp"
 #include "../db/storage.hpp"
 #include "../instance/instance.hpp" // IWYU pragma: keep
 #include "../instance/job.hpp"
 #include "../instance/laggraph.hpp"
 #include "../instance/resource.hpp"
+#include "../instance/solution.hpp"
 #include "../manager/errors.hpp"   // for Inconsisten...
 #include "../util/fault_codes.hpp" // for FAULT_INVAL...
 #include "../util/solverconfig.hpp"
 #include "generated_config.hpp"
 
+#include <algorithm> // for fill, min
+#include <chrono>    // for high_resolution_clock
+#include <cmath>     // for round
 #include <limits>
 
 #if defined(GUROBI_FOUND)
@@ -24,6 +29,10 @@
 #include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
 #endif
 
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
 #include <boost/progress.hpp>
 
 template <class SolverT>
@@ -34,6 +43,11 @@ DTILP<SolverT>::DTILP(const Instance & instance_in,
 {
 	this->use_sos1_for_starts = this->sconf.has_config("use_sos1_for_starts") &&
 	                            this->sconf.as_bool("use_sos1_for_starts");
+	this->lazy_resource_constraints =
+	    this->sconf.has_config("lazy_resource_constraints") &&
+	    this->sconf.as_bool("lazy_resource_constraints");
+	// Separating resource constraints needs the switch-on variables
+	this->model_cacheable = !this->lazy_resource_constraints;
 }
 
 template <class SolverT>
@@ -48,14 +62,17 @@ template <class SolverT>
 void
 DTILP<SolverT>::prepare_start_point_constraints()
 {
+	typename Base::RowBuffer rows;
 	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
-		Expression expr = this->env.create_expression();
+		// sum_t t * x_t - start = 0
 		for (unsigned int t = 0; t < this->time_step_bounds[jid].second; ++t) {
-			expr += (this->time_step_bounds[jid].first + t) * this->variables[jid][t];
+			rows.add(this->variables[jid][t],
+			         (double)(this->time_step_bounds[jid].first + t));
 		}
-
-		this->model.add_constraint(expr, this->start_points[jid], expr);
+		rows.add(this->start_points[jid], -1.0);
+		rows.finish_row(0, 0);
 	}
+	this->add_rows(rows);
 }
 
 template <class SolverT>
@@ -68,6 +85,10 @@ DTILP<SolverT>::prepare_overshoot_costs()
 		const Resource & res = this->instance.get_resource(i);
 		// Overshoot costs
 		for (unsigned int t = 0; t <= this->latest_deadline; ++t) {
+			if (!this->time_step_active[i][t]) {
+				continue;
+			}
+
 			polynomial overshoot_costs = res.get_overshoot_costs(t);
 			for (poly_term term : overshoot_costs) {
 				double coefficient = std::get<0>(term);
@@ -104,21 +125,10 @@ DTILP<SolverT>::prepare_variables()
 	std::vector<double> sos1_weights;
 
 	for (unsigned int i = 0; i < this->instance.job_count(); i++) {
-		const Job & job = this->instance.get_job(i);
-		int earliest_start_with_extension =
-		    std::max(((int)job.get_release() -
-		              (int)this->instance.get_window_extension_limit()),
-		             0);
-		int latest_finish_with_extension =
-		    std::min((int)job.get_deadline() +
-		                 (int)this->instance.get_window_extension_limit(),
-		             (int)this->instance.get_window_extension_hard_deadline()
-		                 .value_or_default(std::numeric_limits<int>::max()));
-
-		this->time_step_bounds[i] = {earliest_start_with_extension,
-		                             latest_finish_with_extension -
-		                                 earliest_start_with_extension -
-		                                 (int)job.get_duration() + 1};
+		// Only time steps inside the (propagated) start window get a variable
+		this->time_step_bounds[i] = {this->start_windows[i].first,
+		                             this->start_windows[i].second -
+		                                 this->start_windows[i].first + 1};
 
 		this->variables[i].resize(this->time_step_bounds[i].second);
 		for (unsigned int j = 0; j < this->time_step_bounds[i].second; j++) {
@@ -206,11 +216,37 @@ DTILP<SolverT>::prepare_variables()
 		}
 	}
 
+	/* A time step needs overshoot variables and resource constraints only if
+	 * some job using the resource can run at that time. */
+	this->time_step_active.assign(
+	    this->instance.resource_count(),
+	    std::vector<bool>((size_t)this->latest_deadline + 1, false));
+	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+		const Job & job = this->instance.get_job(jid);
+		unsigned int first = this->time_step_bounds[jid].first;
+		unsigned int last = std::min(
+		    first + this->time_step_bounds[jid].second + job.get_duration() +
+		        (unsigned int)this->overduration_variables[jid].size(),
+		    this->latest_deadline + 1);
+
+		for (unsigned int rid = 0; rid < this->instance.resource_count(); ++rid) {
+			if (job.get_resource_usage(rid) <= 0) {
+				continue;
+			}
+			for (unsigned int t = first; t < last; ++t) {
+				this->time_step_active[rid][t] = true;
+			}
+		}
+	}
+
 	this->overshoot_variables.resize(this->instance.resource_count());
 	for (unsigned int i = 0; i < this->instance.resource_count(); i++) {
 		this->overshoot_variables[i].resize((unsigned int)this->latest_deadline +
 		                                    1);
 		for (unsigned int j = 0; j <= this->latest_deadline; j++) {
+			if (!this->time_step_active[i][j]) {
+				continue;
+			}
 			this->overshoot_variables[i][j] = this->model.add_var(
 			    ilpabstraction::VariableType::CONTINUOUS, 0, MIPSolver::INFTY,
 			    std::string("res_") + std::to_string(i) + std::string("_timestep_") +
@@ -225,11 +261,15 @@ DTILP<SolverT>::prepare_variables()
 	this->right_extension_var.resize(this->instance.job_count());
 	this->window_not_modified_var.resize(this->instance.job_count());
 	for (unsigned int i = 0; i < this->instance.job_count(); i++) {
+		// No job can be extended by more than the extension limit anyways (see
+		// the start point bounds). The explicit bound keeps SOS1 linearizable.
 		this->left_extension_var[i] = this->model.add_var(
-		    ilpabstraction::VariableType::INTEGER, 0, MIPSolver::INFTY,
+		    ilpabstraction::VariableType::INTEGER, 0,
+		    this->instance.get_window_extension_limit(),
 		    std::string("left_extension_") + std::to_string(i));
 		this->right_extension_var[i] = this->model.add_var(
-		    ilpabstraction::VariableType::INTEGER, 0, MIPSolver::INFTY,
+		    ilpabstraction::VariableType::INTEGER, 0,
+		    this->instance.get_window_extension_limit(),
 		    std::string("right_extension_") + std::to_string(i));
 		this->window_not_modified_var[i] = this->model.add_var(
 		    ilpabstraction::VariableType::BINARY, 0, 1,
@@ -287,69 +327,292 @@ template <class SolverT>
 void
 DTILP<SolverT>::prepare_resource_constraints()
 {
-	std::vector<std::vector<Expression>> usages;
-	usages.resize(this->instance.resource_count());
-	for (unsigned int rid = 0; rid < this->instance.resource_count(); ++rid) {
-		usages[rid].resize(this->latest_deadline);
-		for (unsigned int i = 0; i < this->latest_deadline; ++i) {
-			usages[rid][i] = this->env.create_expression();
+	/* The usage of every (resource, time step) pair is collected into flat
+	 * arrays in two passes (count, then fill) instead of building one
+	 * Expression per time step. */
+	const size_t steps = (size_t)this->latest_deadline + 1;
+	const unsigned int resource_count = this->instance.resource_count();
+
+	this->usage_offsets.assign(resource_count, std::vector<size_t>(steps + 1, 0));
+	this->usage_vars.assign(resource_count, {});
+	this->usage_coefs.assign(resource_count, {});
+	this->availability.assign(resource_count, std::vector<double>(steps, 0));
+	this->resource_row_added.assign(resource_count,
+	                                std::vector<bool>(steps, false));
+
+	std::vector<size_t> fill(steps);
+
+	for (unsigned int rid = 0; rid < resource_count; ++rid) {
+		auto for_each_usage = [&](auto && callback) {
+			for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+				const Job & job = this->instance.get_job(jid);
+				double usage = job.get_resource_usage(rid);
+				if (usage <= 0) {
+					continue;
+				}
+
+				for (unsigned int t = 0; t < this->time_step_bounds[jid].second; ++t) {
+					unsigned int start = this->time_step_bounds[jid].first + t;
+
+					// Handle normal duration of the job if started at t
+					for (unsigned int t_offset = 0; t_offset < job.get_duration();
+					     ++t_offset) {
+						callback(start + t_offset, this->variables[jid][t], usage);
+					}
+
+					// Handle overduration
+					for (unsigned int od_length = 0;
+					     od_length < this->overduration_variables[jid].size();
+					     ++od_length) {
+						callback(start + job.get_duration() + od_length,
+						         this->overduration_and_swon_variables[jid][t][od_length],
+						         usage);
+					}
+				}
+			}
+		};
+
+		std::vector<size_t> & offsets = this->usage_offsets[rid];
+		for_each_usage([&](unsigned int t, const Variable &, double) {
+			if (t < steps) {
+				offsets[t + 1]++;
+			}
+		});
+		for (size_t t = 0; t < steps; ++t) {
+			offsets[t + 1] += offsets[t];
+			fill[t] = offsets[t];
 		}
-	}
 
-	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
-		const Job & job = this->instance.get_job(jid);
+		this->usage_vars[rid].resize(offsets[steps]);
+		this->usage_coefs[rid].resize(offsets[steps]);
+		for_each_usage([&](unsigned int t, const Variable & var, double usage) {
+			if (t < steps) {
+				this->usage_vars[rid][fill[t]] = var;
+				this->usage_coefs[rid][fill[t]] = usage;
+				fill[t]++;
+			}
+		});
 
-		for (unsigned int rid = 0; rid < this->instance.resource_count(); ++rid) {
+		const Resource & res = this->instance.get_resource(rid);
+		auto availability_it = res.get_availability().begin();
+		for (unsigned int t = 0; t < steps; ++t) {
+			if ((availability_it + 1) != (res.get_availability().end()) &&
+			    (availability_it + 1)->first <= t) {
+				availability_it++;
+			}
+			this->availability[rid][t] = availability_it->second;
+		}
+	}
 
-			if (job.get_resource_usage(rid) <= 0) {
+	std::vector<bool> initial_steps;
+	if (this->lazy_resource_constraints) {
+		initial_steps = this->get_initial_resource_steps();
+	}
+
+	typename Base::RowBuffer rows;
+	size_t row_count = 0;
+	for (unsigned int rid = 0; rid < resource_count; ++rid) {
+		for (unsigned int t = 0; t < this->latest_deadline; ++t) {
+			if (!this->time_step_active[rid][t]) {
+				continue;
+			}
+			if (this->lazy_resource_constraints && !initial_steps[t]) {
 				continue;
 			}
+			this->add_resource_rows(rid, t, rows);
+			row_count++;
+		}
 
-			for (unsigned int t = 0; t < this->time_step_bounds[jid].second; ++t) {
+		// Keep the buffer from growing over all resources
+		this->add_rows(rows);
+	}
 
-				// Handle normal duration of the job if started at t
-				for (unsigned int t_offset = 0; t_offset < job.get_duration();
-				     ++t_offset) {
-					usages[rid][this->time_step_bounds[jid].first + t + t_offset] +=
-					    this->variables[jid][t] * job.get_resource_usage(rid);
-				}
+	if (this->lazy_resource_constraints) {
+		BOOST_LOG(l.d(1)) << "Starting with resource constraints at " << row_count
+		                  << " (resource, time step) pairs.";
+	} else {
+		// Only needed to add rows later on
+		this->usage_offsets.clear();
+		this->usage_vars.clear();
+		this->usage_coefs.clear();
+	}
+}
 
-				// Handle overduration
-				for (unsigned int od_length = 0;
-				     od_length < this->overduration_variables[jid].size();
-				     ++od_length) {
-					usages[rid][this->time_step_bounds[jid].first + t +
-					            job.get_duration() + od_length] +=
-					    this->overduration_and_swon_variables[jid][t][od_length] *
-					    job.get_resource_usage(rid);
-				}
-			}
+template <class SolverT>
+void
+DTILP<SolverT>::add_resource_rows(unsigned int rid, unsigned int t,
+                                  typename Base::RowBuffer & rows)
+{
+	const std::vector<size_t> & offsets = this->usage_offsets[rid];
+	double available = this->availability[rid][t];
+
+	// overshoot - usage >= -available
+	rows.add(this->overshoot_variables[rid][t], 1.0);
+	for (size_t k = offsets[t]; k < offsets[t + 1]; ++k) {
+		rows.add(this->usage_vars[rid][k], -this->usage_coefs[rid][k]);
+	}
+	rows.finish_row(-available, MIPSolver::INFTY,
+	                std::string("res_") + std::to_string(rid) + "_at_" +
+	                    std::to_string(t) + std::string("_overshoot"));
+
+	// capacity - usage >= -available
+	rows.add(this->max_usage_variables[rid], 1.0);
+	for (size_t k = offsets[t]; k < offsets[t + 1]; ++k) {
+		rows.add(this->usage_vars[rid][k], -this->usage_coefs[rid][k]);
+	}
+	rows.finish_row(-available, MIPSolver::INFTY,
+	                std::string("res_") + std::to_string(rid) + "_at_" +
+	                    std::to_string(t) + std::string("_investment"));
+
+	this->resource_row_added[rid][t] = true;
+}
+
+template <class SolverT>
+std::vector<bool>
+DTILP<SolverT>::get_initial_resource_steps() const
+{
+	/* The usage profile of a schedule only changes at the start and end times
+	 * of its jobs. Starting with constraints at the event points of the
+	 * EarlyScheduler solution covers the peaks of that schedule. */
+	std::vector<bool> steps((size_t)this->latest_deadline + 1, false);
+
+	AdditionalResultStorage dummy_storage;
+	EarlyScheduler es(this->instance, dummy_storage,
+	                  SolverConfig("DUMMY", "DUMMY", {}, Maybe<unsigned int>(),
+	                               false, 1, {},
+	                               Maybe<int>(this->sconf.get_seed())));
+	es.run();
+	Solution es_sol = es.get_solution();
+
+	for (const Job & job : this->instance.get_jobs()) {
+		unsigned int start = es_sol.get_start_time(job.get_jid());
+		unsigned int end = start + job.get_duration();
+		if (start < steps.size()) {
+			steps[start] = true;
+		}
+		if (end < steps.size()) {
+			steps[end] = true;
 		}
 	}
 
+	return steps;
+}
+
+template <class SolverT>
+size_t
+DTILP<SolverT>::separate_resource_constraints(
+    std::vector<unsigned int> & start_times)
+{
+	const size_t steps = (size_t)this->latest_deadline + 1;
+
+	start_times.resize(this->instance.job_count());
+	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+		start_times[jid] = (unsigned int)std::round(
+		    this->model.get_variable_assignment(this->start_points[jid]));
+	}
+
+	// Difference array of the usage profile of the current solution
+	std::vector<double> profile(steps + 1);
+	typename Base::RowBuffer rows;
+	size_t added = 0;
+
 	for (unsigned int rid = 0; rid < this->instance.resource_count(); ++rid) {
-		Variable capacity = this->max_usage_variables[rid];
-		const Resource & res = this->instance.get_resource(rid);
-		auto availability_it = res.get_availability().begin();
+		std::fill(profile.begin(), profile.end(), 0.0);
+		for (const Job & job : this->instance.get_jobs()) {
+			double usage = job.get_resource_usage(rid);
+			if (usage <= 0) {
+				continue;
+			}
+			unsigned int jid = job.get_jid();
+			size_t duration = (size_t)std::round(
+			    this->model.get_variable_assignment(this->duration_variables[jid]));
+			size_t start = std::min((size_t)start_times[jid], steps);
+			size_t end = std::min(start + duration, steps);
+			profile[start] += usage;
+			profile[end] -= usage;
+		}
 
+		double capacity =
+		    this->model.get_variable_assignment(this->max_usage_variables[rid]);
+		double usage = 0;
 		for (unsigned int t = 0; t < this->latest_deadline; ++t) {
-			if ((availability_it + 1) != (res.get_availability().end()) &&
-			    (availability_it + 1)->first <= t) {
-				availability_it++;
+			usage += profile[t];
+			if (!this->time_step_active[rid][t] || this->resource_row_added[rid][t]) {
+				continue;
 			}
-			double available = availability_it->second;
-
-			this->model.add_constraint(
-			    usages[rid][t] - available, this->overshoot_variables[rid][t],
-			    MIPSolver::INFTY,
-			    std::string("res_") + std::to_string(rid) + "_at_" +
-			        std::to_string(t) + std::string("_overshoot"));
-			this->model.add_constraint(
-			    usages[rid][t] - available, capacity, MIPSolver::INFTY,
-			    std::string("res_") + std::to_string(rid) + "_at_" +
-			        std::to_string(t) + std::string("_investment"));
+
+			double excess = usage - this->availability[rid][t];
+			double overshoot = this->model.get_variable_assignment(
+			    this->overshoot_variables[rid][t]);
+			if ((excess > overshoot + DOUBLE_DELTA) ||
+			    (excess > capacity + DOUBLE_DELTA)) {
+				this->add_resource_rows(rid, t, rows);
+				added++;
+			}
+		}
+
+		this->add_rows(rows);
+	}
+
+	return added;
+}
+
+template <class SolverT>
+void
+DTILP<SolverT>::solve_lazily(Maybe<unsigned int> time_limit,
+                             const Timer & started)
+{
+	if (!this->lazy_resource_constraints) {
+		return;
+	}
+
+	unsigned int rounds = 0;
+	size_t total_added = 0;
+	std::vector<unsigned int> start_times;
+
+	while (this->model.has_feasible()) {
+		size_t added = this->separate_resource_constraints(start_times);
+		if (added == 0) {
+			break;
+		}
+
+		// The solution we report is feasible, but was optimized on a relaxation
+		this->optimized = false;
+		rounds++;
+		total_added += added;
+		BOOST_LOG(l.d(1)) << "Round " << rounds << ": added resource constraints "
+		                  << "at " << added << " violated time steps.";
+
+		Maybe<unsigned int> remaining;
+		if (time_limit.valid()) {
+			double left = (double)time_limit.value() - started.get();
+			if (left < 1.0) {
+				BOOST_LOG(l.w()) << "Time limit reached while resource constraints "
+				                    "were still being added.";
+				break;
+			}
+			remaining = Maybe<unsigned int>((unsigned int)left);
+		}
+
+		// The previous schedule is still feasible for the extended model
+		for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+			this->model.set_start(this->start_points[jid], start_times[jid]);
 		}
+		this->solve(remaining, false);
 	}
+
+	this->additional_storage.extended_measures.push_back(
+	    {"LAZY_ROUNDS",
+	     Maybe<unsigned int>(),
+	     Maybe<double>(),
+	     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+	     {(int)rounds}});
+	this->additional_storage.extended_measures.push_back(
+	    {"LAZY_RESOURCE_STEPS_ADDED",
+	     Maybe<unsigned int>(),
+	     Maybe<double>(),
+	     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+	     {(int)total_added}});
 }
 
 template <class SolverT>
@@ -397,21 +660,29 @@ DTILP<SolverT>::prepare()
 {
 	this->prepare_pre();
 
+	auto phase_start = std::chrono::high_resolution_clock::now();
 	BOOST_LOG(l.d()) << "Preparing Variables";
 	this->prepare_variables();
+	phase_start = this->record_build_phase("VARIABLES", phase_start);
 	BOOST_LOG(l.d()) << "Preparing Start Point Constraints";
 	this->prepare_start_point_constraints();
+	phase_start = this->record_build_phase("START_POINT_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing Job Constraints";
 	this->prepare_job_constraints();
+	phase_start = this->record_build_phase("JOB_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing Duration Constraints";
 	this->prepare_duration_constraint();
+	phase_start = this->record_build_phase("DURATION_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing Resource Constraints";
 	// BOOST_LOG(l.d()) << std::flush;
 	this->prepare_resource_constraints();
+	phase_start = this->record_build_phase("RESOURCE_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing Extension Constraints";
 	this->prepare_extension_constraints();
+	phase_start = this->record_build_phase("EXTENSION_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing overshoot costs";
 	this->prepare_overshoot_costs();
+	this->record_build_phase("OVERSHOOT_COSTS", phase_start);
 
 	this->prepare_post();
 }
@@ -504,6 +775,9 @@ DTILP<SolverT>::print_profile() const
 	for (unsigned int t = 0; t < this->latest_deadline; t++) {
 		BOOST_LOG(l.d(2)) << "====> Step " << t;
 		for (unsigned int r = 0; r < this->instance.resource_count(); ++r) {
+			if (!this->time_step_active[r][t]) {
+				continue;
+			}
 			double overshoot =
 			    this->model.get_variable_assignment(this->overshoot_variables[r][t]);
 			// double overshoot =
@@ -529,15 +803,16 @@ DTILP<SolverT>::warmstart_with_fixed(
     Maybe<unsigned int> extension_time_limit,
     Maybe<unsigned int> extension_job_limit)
 {
-	BOOST_LOG(l.i()) << "Warm-starting.";
+	BOOST_LOG(l.d(1)) << "Warm-starting.";
 
 	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
 		this->model.set_start(this->start_points[jid], start_pos[jid]);
 		// TODO also set start-indicators?
 
-		if (fixed_jobs[jid] && !this->job_is_fixed[jid]) {
+		// Always re-fix, the position might have changed since the last call
+		if (fixed_jobs[jid]) {
 			this->fix_job(jid, start_pos[jid]);
-		} else if (!fixed_jobs[jid] && this->job_is_fixed[jid]) {
+		} else if (this->job_is_fixed[jid]) {
 			this->unfix_job(jid);
 		}
 	}
@@ -577,7 +852,11 @@ DTILP<SolverT>::warmstart_with_fixed(
 		//                                this->instance.get_window_extension_job_limit());
 	}
 
-	this->solve(time_limit);
+	// We have set the start ourselves
+	Timer started;
+	started.start();
+	this->solve(time_limit, false);
+	this->solve_lazily(time_limit, started);
 }
 
 template <class SolverT>
@@ -585,6 +864,7 @@ void
 DTILP<SolverT>::fix_job(unsigned int jid, unsigned int time)
 {
 	this->model.change_var_bounds(this->start_points[jid], time, time);
+	this->job_is_fixed[jid] = true;
 	// TODO also change derived variables?
 }
 
@@ -592,9 +872,12 @@ template <class SolverT>
 void
 DTILP<SolverT>::unfix_job(unsigned int jid)
 {
-	this->model.change_var_bounds(
-	    this->start_points[jid], this->time_step_bounds[jid].first,
-	    this->time_step_bounds[jid].first + this->time_step_bounds[jid].second);
+	// .second is the number of possible start positions
+	this->model.change_var_bounds(this->start_points[jid],
+	                              this->time_step_bounds[jid].first,
+	                              this->time_step_bounds[jid].first +
+	                                  this->time_step_bounds[jid].second - 1);
+	this->job_is_fixed[jid] = false;
 	// TODO also change derived variables?
 }
 
@@ -602,8 +885,20 @@ template <class SolverT>
 void
 DTILP<SolverT>::run()
 {
-	this->prepare();
+	Timer started;
+	started.start();
+
+	if (!this->load_cached_model(get_id())) {
+		this->prepare();
+		this->store_cached_model(get_id());
+	}
 	this->base_run();
+
+	Maybe<unsigned int> time_limit;
+	if (this->timelimit > 0) {
+		time_limit = Maybe<unsigned int>((unsigned int)this->timelimit);
+	}
+	this->solve_lazily(time_limit, started);
 }
 
 template <class SolverT>
@@ -622,3 +917,7 @@ template class DTILP<ilpabstraction::GurobiInterface>;
 #if defined(CPLEX_FOUND)
 template class DTILP<ilpabstraction::CPLEXInterface>;
 #endif
+
+#if defined(HIGHS_FOUND)
+template class DTILP<ilpabstraction::HighsInterface>;
+#endif
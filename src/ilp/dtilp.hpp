@@ -12,6 +12,10 @@
 #include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
 #endif
 
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
 template <class MIPSolverT>
 class DTILP : public ILPBase<MIPSolverT> {
 public:
@@ -62,6 +66,10 @@ private:
 	// Overshoot of each resource in every timestep
 	std::vector<std::vector<Variable>> overshoot_variables;
 
+	/* Whether any job using the resource can run at the time step. Inactive
+	 * time steps have neither overshoot variables nor resource constraints. */
+	std::vector<std::vector<bool>> time_step_active;
+
 	// Overduration / switch-on ANDing
 	// overduration_and_swon_variables[i][x][y] will indicate whether:
 	// job i
@@ -78,6 +86,32 @@ private:
 	// by a value but by a variable
 	void prepare_resource_constraints();
 
+	/*
+	 * Lazy resource constraints
+	 *
+	 * With 'lazy_resource_constraints', the model initially only contains the
+	 * resource constraints at the event points of the EarlyScheduler solution.
+	 * After each solve, the constraints violated by the solution are added and
+	 * the model is re-solved, until no constraint is violated.
+	 */
+	void add_resource_rows(unsigned int rid, unsigned int t,
+	                       typename Base::RowBuffer & rows);
+	std::vector<bool> get_initial_resource_steps() const;
+	/* Adds the resource constraints violated by the current solution and
+	 * returns how many (resource, time step) pairs were added. start_times is
+	 * set to the current solution. */
+	size_t separate_resource_constraints(std::vector<unsigned int> & start_times);
+	void solve_lazily(Maybe<unsigned int> time_limit, const Timer & started);
+
+	/* Usage of resource r at time step t: the entries
+	 * [usage_offsets[r][t], usage_offsets[r][t + 1]) of usage_vars[r] /
+	 * usage_coefs[r]. Only kept with lazy resource constraints. */
+	std::vector<std::vector<size_t>> usage_offsets;
+	std::vector<std::vector<Variable>> usage_vars;
+	std::vector<std::vector<double>> usage_coefs;
+	std::vector<std::vector<double>> availability;
+	std::vector<std::vector<bool>> resource_row_added;
+
 	// constraint (6)
 	void prepare_job_constraints();
 
@@ -111,6 +145,7 @@ private:
 	 * Options
 	 */
 	bool use_sos1_for_starts;
+	bool lazy_resource_constraints;
 
 	void print_profile() const;
 };
@@ -150,6 +185,23 @@ struct registry_hook<
 	}
 };
 #endif
+
+#if defined(HIGHS_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<DTILP<ilpabstraction::HighsInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<DTILP<ilpabstraction::HighsInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<DTILP<ilpabstraction::HighsInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
 } // namespace solvers
 
 #endif // TCPSPSUITE_DTILP_HPP
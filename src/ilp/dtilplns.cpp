@@ -0,0 +1,330 @@
+#include "dtilplns.hpp"
+
+#include "../baselines/earlyscheduler.hpp"
+#include "../datastructures/skyline.hpp"
+#include "../db/storage.hpp"
+#include "../instance/instance.hpp"
+#include "../instance/job.hpp"
+#include "../instance/laggraph.hpp"
+#include "../instance/solution.hpp"
+#include "../manager/errors.hpp"
+#include "../util/fault_codes.hpp" // for FAULT_TIME_LIMIT_NEEDED
+#include "../util/solverconfig.hpp"
+#include "generated_config.hpp" // for DOUBLE_DELTA
+
+#include <algorithm> // for max, min, shuffle
+#include <limits>    // for numeric_limits
+
+#if defined(GUROBI_FOUND)
+#include "../contrib/ilpabstraction/src/ilpa_gurobi.hpp"
+#endif
+
+#if defined(CPLEX_FOUND)
+#include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
+#endif
+
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
+template <class SolverT>
+DTILPLNS<SolverT>::DTILPLNS(const Instance & instance_in,
+                            AdditionalResultStorage & additional_in,
+                            const SolverConfig & sconf_in)
+    : instance(instance_in), additional(additional_in), sconf(sconf_in),
+      ilp(instance_in, additional_in, sconf_in), iteration_time(10), window(0),
+      max_window(0), max_free_jobs(50), max_stagnation(10),
+      incumbent_costs(std::numeric_limits<double>::max()),
+      free_jobs(instance_in.job_count(), false),
+      rnd((unsigned long)sconf_in.get_seed()), l("DTILP-LNS")
+{
+	if (!this->sconf.get_time_limit().valid()) {
+		BOOST_LOG(l.e()) << "DTILP-LNS needs a time limit!";
+		throw ConfigurationError(instance_in, sconf.get_seed(),
+		                         FAULT_TIME_LIMIT_NEEDED,
+		                         "DTILP-LNS needs a time limit!");
+	}
+	this->timelimit = this->sconf.get_time_limit();
+
+	for (const Job & job : this->instance.get_jobs()) {
+		this->window = std::max(this->window, job.get_duration());
+		this->max_window = std::max(this->max_window, job.get_deadline());
+	}
+
+	if (this->sconf.has_config("lns_iteration_time")) {
+		this->iteration_time = (unsigned int)this->sconf["lns_iteration_time"];
+	}
+	if (this->sconf.has_config("lns_window")) {
+		this->window = (unsigned int)this->sconf["lns_window"];
+	}
+	if (this->sconf.has_config("lns_max_free_jobs")) {
+		this->max_free_jobs = (size_t)this->sconf["lns_max_free_jobs"];
+	}
+	if (this->sconf.has_config("lns_max_stagnation")) {
+		this->max_stagnation = (size_t)this->sconf["lns_max_stagnation"];
+	}
+
+	this->window = std::max(this->window, 1u);
+	this->iteration_time = std::max(this->iteration_time, 1u);
+}
+
+template <class SolverT>
+void
+DTILPLNS<SolverT>::initialize_incumbent()
+{
+	AdditionalResultStorage dummy_storage;
+	EarlyScheduler es(this->instance, dummy_storage,
+	                  SolverConfig("DUMMY", "DUMMY", {}, Maybe<unsigned int>(),
+	                               false, 1, {},
+	                               Maybe<int>(this->sconf.get_seed())));
+	es.run();
+	Solution es_sol = es.get_solution();
+
+	this->incumbent.resize(this->instance.job_count());
+	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+		this->incumbent[jid] = es_sol.get_start_time(jid);
+	}
+	this->incumbent_costs = es_sol.get_costs();
+
+	BOOST_LOG(l.d(1)) << "Initial solution costs: " << this->incumbent_costs;
+}
+
+template <class SolverT>
+void
+DTILPLNS<SolverT>::select_window(std::pair<unsigned int, unsigned int> range,
+                                 unsigned int width)
+{
+	unsigned int from = range.first - std::min(range.first, width);
+	unsigned int to = range.second + width;
+
+	for (const Job & job : this->instance.get_jobs()) {
+		unsigned int start = this->incumbent[job.get_jid()];
+		if ((start < to) && (start + job.get_duration() > from)) {
+			this->free_jobs_buf.push_back(job.get_jid());
+		}
+	}
+}
+
+template <class SolverT>
+void
+DTILPLNS<SolverT>::select_cluster(std::pair<unsigned int, unsigned int> range)
+{
+	const LagGraph & laggraph = this->instance.get_laggraph();
+
+	for (const Job & job : this->instance.get_jobs()) {
+		unsigned int start = this->incumbent[job.get_jid()];
+		if ((start < range.second) && (start + job.get_duration() > range.first)) {
+			this->free_jobs_buf.push_back(job.get_jid());
+		}
+	}
+
+	// Moving a peak job usually means moving the jobs it is tied to
+	size_t peak_jobs = this->free_jobs_buf.size();
+	for (size_t i = 0; i < peak_jobs; ++i) {
+		for (const auto & edge : laggraph.neighbors(this->free_jobs_buf[i])) {
+			this->free_jobs_buf.push_back(edge.t);
+		}
+		for (const auto & edge : laggraph.reverse_neighbors(this->free_jobs_buf[i])) {
+			this->free_jobs_buf.push_back(edge.t);
+		}
+	}
+
+	std::sort(this->free_jobs_buf.begin(), this->free_jobs_buf.end());
+	this->free_jobs_buf.erase(
+	    std::unique(this->free_jobs_buf.begin(), this->free_jobs_buf.end()),
+	    this->free_jobs_buf.end());
+}
+
+template <class SolverT>
+void
+DTILPLNS<SolverT>::limit_free_jobs()
+{
+	if (this->free_jobs_buf.size() > this->max_free_jobs) {
+		std::shuffle(this->free_jobs_buf.begin(), this->free_jobs_buf.end(),
+		             this->rnd);
+		this->free_jobs_buf.resize(this->max_free_jobs);
+	}
+
+	std::fill(this->free_jobs.begin(), this->free_jobs.end(), false);
+	for (unsigned int jid : this->free_jobs_buf) {
+		this->free_jobs[jid] = true;
+	}
+}
+
+template <class SolverT>
+void
+DTILPLNS<SolverT>::run()
+{
+	this->timer.start();
+
+	BOOST_LOG(l.d(1)) << "Building the model";
+	this->ilp.prepare_warmstart();
+	this->initialize_incumbent();
+
+	// Must be ranged, otherwise there is no maximum range to look at
+	ds::SkyLine skyline(
+	    (this->instance.resource_count() > 1)
+	        ? ds::SkyLine{ds::RangedTreeSkyLine{&this->instance}}
+	        : ds::SkyLine{ds::SingleRangedTreeSkyLine{&this->instance}});
+	for (const Job & job : this->instance.get_jobs()) {
+		skyline.insert_job(job, this->incumbent[job.get_jid()]);
+	}
+
+	unsigned int latest_deadline = this->instance.get_latest_deadline();
+	std::uniform_int_distribution<unsigned int> random_point(0, latest_deadline);
+
+	unsigned int iteration = 0;
+	unsigned int improvements = 0;
+	unsigned int empty_neighbourhoods = 0;
+	size_t stagnation = 0;
+
+	this->additional.intermediate_results.push_back(
+	    {Maybe<double>(this->timer.get()), Maybe<unsigned int>(0u),
+	     Maybe<double>(this->incumbent_costs), Maybe<double>(),
+	     Maybe<Solution>(), Maybe<unsigned int>()});
+
+	while (this->timer.get() < this->timelimit) {
+		iteration++;
+
+		/* Neighbourhood selection. After too many iterations without
+		 * improvement, we look somewhere else than at the peak. */
+		std::pair<unsigned int, unsigned int> range;
+		if (stagnation >= this->max_stagnation) {
+			unsigned int point = random_point(this->rnd);
+			range = {point, point + 1};
+			stagnation = 0;
+		} else {
+			range = skyline.get_maximum_range();
+		}
+
+		this->free_jobs_buf.clear();
+		if ((iteration % 2) == 0) {
+			this->select_cluster(range);
+		} else {
+			this->select_window(range, this->window);
+		}
+		this->limit_free_jobs();
+
+		if (this->free_jobs_buf.empty()) {
+			// Nothing runs there (only possible at a random point)
+			empty_neighbourhoods++;
+			stagnation++;
+			continue;
+		}
+
+		std::vector<bool> fixed_jobs(this->instance.job_count());
+		for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+			fixed_jobs[jid] = !this->free_jobs[jid];
+		}
+
+		unsigned int remaining = static_cast<unsigned int>(
+		    std::max(1.0, this->timelimit - this->timer.get()));
+		unsigned int sub_limit = std::min(this->iteration_time, remaining);
+
+		BOOST_LOG(l.d(2)) << "Iteration " << iteration << ": re-optimizing "
+		                  << this->free_jobs_buf.size() << " jobs around ["
+		                  << range.first << ", " << range.second << ")";
+
+		this->ilp.warmstart_with_fixed(fixed_jobs, this->incumbent, sub_limit, {},
+		                               {}, {}, {});
+		Solution sol = this->ilp.get_solution();
+
+		if (sol.is_feasible() &&
+		    (sol.get_costs() < this->incumbent_costs - DOUBLE_DELTA)) {
+			BOOST_LOG(l.d(1)) << "Improved from " << this->incumbent_costs << " to "
+			                  << sol.get_costs();
+			for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
+				if (this->incumbent[jid] != sol.get_start_time(jid)) {
+					this->incumbent[jid] = sol.get_start_time(jid);
+					skyline.set_pos(jid, (int)this->incumbent[jid]);
+				}
+			}
+			this->incumbent_costs = sol.get_costs();
+			improvements++;
+			stagnation = 0;
+
+			this->additional.intermediate_results.push_back(
+			    {Maybe<double>(this->timer.get()), Maybe<unsigned int>(iteration),
+			     Maybe<double>(this->incumbent_costs), Maybe<double>(),
+			     Maybe<Solution>(), Maybe<unsigned int>()});
+		} else {
+			stagnation++;
+			if (sol.is_optimal()) {
+				// The neighbourhood is exhausted, look further
+				this->window = std::min(2 * this->window, this->max_window);
+			} else {
+				// Sub-MIP too hard for the time limit
+				this->window = std::max(this->window / 2, 1u);
+			}
+		}
+	}
+
+	this->additional.extended_measures.push_back(
+	    {"LNS_ITERATIONS",
+	     {},
+	     {},
+	     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+	     {(int)iteration}});
+	this->additional.extended_measures.push_back(
+	    {"LNS_IMPROVEMENTS",
+	     {},
+	     {},
+	     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+	     {(int)improvements}});
+	this->additional.extended_measures.push_back(
+	    {"LNS_EMPTY_NEIGHBOURHOODS",
+	     {},
+	     {},
+	     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+	     {(int)empty_neighbourhoods}});
+}
+
+template <class SolverT>
+Solution
+DTILPLNS<SolverT>::get_solution()
+{
+	return Solution(this->instance, false, this->incumbent, Maybe<double>());
+}
+
+template <class SolverT>
+Maybe<double>
+DTILPLNS<SolverT>::get_lower_bound()
+{
+	// Bounds of the sub-MIPs are not valid for the whole instance
+	return Maybe<double>();
+}
+
+template <class SolverT>
+bool
+DTILPLNS<SolverT>::runs_foreign_threads() const
+{
+	return this->ilp.runs_foreign_threads();
+}
+
+template <class SolverT>
+std::string
+DTILPLNS<SolverT>::get_id()
+{
+	return "DTILP-LNS v1.0 (" + std::string(SolverT::NAME) + ")";
+}
+
+template <class SolverT>
+const Traits &
+DTILPLNS<SolverT>::get_requirements()
+{
+	return DTILP<SolverT>::get_requirements();
+}
+
+// explicit instantiation
+
+#if defined(GUROBI_FOUND)
+template class DTILPLNS<ilpabstraction::GurobiInterface>;
+#endif
+
+#if defined(CPLEX_FOUND)
+template class DTILPLNS<ilpabstraction::CPLEXInterface>;
+#endif
+
+#if defined(HIGHS_FOUND)
+template class DTILPLNS<ilpabstraction::HighsInterface>;
+#endif
@@ -0,0 +1,136 @@
+#ifndef TCPSPSUITE_DTILPLNS_HPP
+#define TCPSPSUITE_DTILPLNS_HPP
+
+#include "../datastructures/maybe.hpp" // for Maybe
+#include "../manager/solvers.hpp"
+#include "../manager/timer.hpp" // for Timer
+#include "../util/log.hpp"      // for Log
+#include "dtilp.hpp"
+
+#include <random> // for mt19937
+#include <string> // for string
+#include <vector> // for vector
+
+class AdditionalResultStorage;
+class Instance;
+class SolverConfig;
+class Traits;
+
+/* A large neighbourhood search on top of the DTILP.
+ *
+ * A single DTILP model is built once and kept alive. Every iteration fixes
+ * all jobs to their position in the incumbent except for a neighbourhood
+ * around the current peak of the resource profile, which is re-optimized
+ * with a short time limit. Improvements are accepted.
+ *
+ * Two neighbourhoods are used in turn:
+ *   * window: all jobs running in a time window around the peak
+ *   * cluster: all jobs running during the peak plus their lag-graph
+ *     neighbours
+ *
+ * The window grows whenever a sub-MIP is solved to optimality without
+ * improvement, and shrinks whenever a sub-MIP runs into its time limit.
+ */
+template <class MIPSolverT>
+class DTILPLNS {
+public:
+	DTILPLNS(const Instance & instance, AdditionalResultStorage & additional,
+	         const SolverConfig & sconf);
+
+	void run();
+	Solution get_solution();
+	Maybe<double> get_lower_bound();
+	bool runs_foreign_threads() const;
+	static std::string get_id();
+	static const Traits & get_requirements();
+
+private:
+	void initialize_incumbent();
+	void select_window(std::pair<unsigned int, unsigned int> range,
+	                   unsigned int width);
+	void select_cluster(std::pair<unsigned int, unsigned int> range);
+	void limit_free_jobs();
+
+	const Instance & instance;
+	AdditionalResultStorage & additional;
+	const SolverConfig & sconf;
+
+	DTILP<MIPSolverT> ilp;
+
+	/*
+	 * Options
+	 */
+	double timelimit;
+	unsigned int iteration_time;
+	unsigned int window;
+	unsigned int max_window;
+	size_t max_free_jobs;
+	size_t max_stagnation;
+
+	std::vector<unsigned int> incumbent;
+	double incumbent_costs;
+
+	// Which jobs are re-optimized in the current iteration
+	std::vector<bool> free_jobs;
+	std::vector<unsigned int> free_jobs_buf;
+
+	std::mt19937 rnd;
+	Timer timer;
+	Log l;
+};
+
+// Register the solver
+namespace solvers {
+#if defined(GUROBI_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<DTILPLNS<ilpabstraction::GurobiInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<DTILPLNS<ilpabstraction::GurobiInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<DTILPLNS<ilpabstraction::GurobiInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
+
+#if defined(CPLEX_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<DTILPLNS<ilpabstraction::CPLEXInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<DTILPLNS<ilpabstraction::CPLEXInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<DTILPLNS<ilpabstraction::CPLEXInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
+
+#if defined(HIGHS_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<DTILPLNS<ilpabstraction::HighsInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<DTILPLNS<ilpabstraction::HighsInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<DTILPLNS<ilpabstraction::HighsInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
+} // namespace solvers
+
+#endif // TCPSPSUITE_DTILPLNS_HPP
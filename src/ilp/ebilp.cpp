@@ -15,6 +15,7 @@
 
 #include <boost/log/core/record.hpp>            // for record
 #include <boost/log/sources/record_ostream.hpp> // for BOOST_LOG
+#include <chrono>                             // for high_resolution_clock
 #include <iostream>                             // for operator<<, cout
 #include <math.h>                               // for round
 #include <stddef.h>                             // for size_t
@@ -36,6 +37,8 @@ EBILP<SolverT>::EBILP(const Instance & instance_in,
 	if (this->sconf.has_config("use_start_points")) {
 		this->start_point_mode = (bool)this->sconf["use_start_points"];
 	}
+	// Without start points, the solution is read from the event variables
+	this->model_cacheable = this->start_point_mode;
 	if (this->sconf.has_config("enforce_order_by_sum")) {
 		this->enforce_end_after_start_via_sum =
 		    (bool)this->sconf["enforce_order_by_sum"];
@@ -433,19 +436,26 @@ EBILP<SolverT>::prepare()
 {
 	this->prepare_pre();
 
+	auto phase_start = std::chrono::high_resolution_clock::now();
 	BOOST_LOG(l.d()) << "Preparing variables...";
 	this->compute_skip_numbers();
 	this->prepare_variables();
+	phase_start = this->record_build_phase("VARIABLES", phase_start);
 	BOOST_LOG(l.d()) << "Preparing duration constraints...";
 	this->prepare_duration_constraint();
+	phase_start = this->record_build_phase("DURATION_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing event order constraints...";
 	this->prepare_event_constraints();
+	phase_start = this->record_build_phase("EVENT_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing job / event linking constraints...";
 	this->prepare_job_event_constraints();
+	phase_start = this->record_build_phase("JOB_EVENT_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing time between event constraints...";
 	this->prepare_time_constraints();
+	phase_start = this->record_build_phase("TIME_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing usage constraints...";
 	this->prepare_usage_expressions();
+	phase_start = this->record_build_phase("USAGE_CONSTRAINTS", phase_start);
 
 	if (this->start_point_mode) {
 		BOOST_LOG(l.d()) << "Preparing start time constraints...";
@@ -456,6 +466,7 @@ EBILP<SolverT>::prepare()
 		BOOST_LOG(l.d()) << "Preparing dependency constraints...";
 		this->prepare_dependency_constraints();
 	}
+	this->record_build_phase("TIMING_CONSTRAINTS", phase_start);
 
 	this->prepare_post();
 }
@@ -464,7 +475,10 @@ template <class SolverT>
 void
 EBILP<SolverT>::run()
 {
-	this->prepare();
+	if (!this->load_cached_model(get_id())) {
+		this->prepare();
+		this->store_cached_model(get_id());
+	}
 	this->base_run();
 
 	if (!this->start_point_mode) {
@@ -481,3 +495,7 @@ template class EBILP<ilpabstraction::GurobiInterface>;
 #if defined(CPLEX_FOUND)
 template class EBILP<ilpabstraction::CPLEXInterface>;
 #endif
+
+#if defined(HIGHS_FOUND)
+template class EBILP<ilpabstraction::HighsInterface>;
+#endif
@@ -28,6 +28,10 @@ struct registry_hook;
 #include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
 #endif
 
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
 template <class SolverT>
 class EBILP : public ILPBase<SolverT> {
 public:
@@ -181,6 +185,23 @@ struct registry_hook<
 	}
 };
 #endif
+
+#if defined(HIGHS_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<EBILP<ilpabstraction::HighsInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<EBILP<ilpabstraction::HighsInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<EBILP<ilpabstraction::HighsInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
 } // namespace solvers
 
 #endif // TCPSPSUITE_EBILP_HPP
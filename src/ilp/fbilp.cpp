@@ -5,6 +5,7 @@
 #include "../instance/job.hpp"
 #include "../src/util/solverconfig.hpp"
 
+#include <chrono> // for high_resolution_clock
 #include <cstddef>
 
 template <class SolverT>
@@ -25,7 +26,10 @@ FBILP<SolverT>::run()
 	if (this->proxy_flow) {
 		BOOST_LOG(l.i()) << "Flow-proxying enabled.";
 	}
-	this->prepare();
+	if (!this->load_cached_model(get_id())) {
+		this->prepare();
+		this->store_cached_model(get_id());
+	}
 	this->base_run();
 }
 
@@ -35,14 +39,19 @@ FBILP<SolverT>::prepare()
 {
 	this->prepare_pre();
 
+	auto phase_start = std::chrono::high_resolution_clock::now();
 	BOOST_LOG(l.d()) << "Preparing variables.";
 	this->prepare_variables();
+	phase_start = this->record_build_phase("VARIABLES", phase_start);
 	BOOST_LOG(l.d()) << "Preparing sequence constraints";
 	this->prepare_sequence_constraints();
+	phase_start = this->record_build_phase("SEQUENCE_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing flow constraints";
 	this->prepare_flow_constraints();
+	phase_start = this->record_build_phase("FLOW_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing objective";
 	this->prepare_objective();
+	this->record_build_phase("FLOW_OBJECTIVE", phase_start);
 
 	this->prepare_post();
 }
@@ -414,3 +423,7 @@ template class FBILP<ilpabstraction::GurobiInterface>;
 #if defined(CPLEX_FOUND)
 template class FBILP<ilpabstraction::CPLEXInterface>;
 #endif
+
+#if defined(HIGHS_FOUND)
+template class FBILP<ilpabstraction::HighsInterface>;
+#endif
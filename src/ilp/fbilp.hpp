@@ -23,6 +23,10 @@ struct registry_hook;
 #include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
 #endif
 
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
 template <class SolverT>
 class FBILP : public ILPBase<SolverT> {
 public:
@@ -103,6 +107,23 @@ struct registry_hook<
 	}
 };
 #endif
+
+#if defined(HIGHS_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<FBILP<ilpabstraction::HighsInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<FBILP<ilpabstraction::HighsInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<FBILP<ilpabstraction::HighsInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
 } // namespace solvers
 
 #endif
@@ -4,24 +4,36 @@
 #include "../baselines/earlyscheduler.hpp"
 #include "../contrib/ilpabstraction/src/common.hpp" // for ObjectiveType
 #include "../db/storage.hpp"
+#include "../grasp/grasp.hpp"
 #include "../instance/instance.hpp"
 #include "../instance/laggraph.hpp" // for LagGraph
 #include "../instance/resource.hpp"
 #include "../instance/traits.hpp" // for Traits, Tra...
 #include "../manager/errors.hpp"  // for Inconsisten...
+#include "../manager/incumbentexchange.hpp"
+#include "../swag/swag.hpp"
 #include "../util/configuration.hpp"
 #include "../util/fault_codes.hpp" // for FAULT_INVAL...
 #include "../util/log.hpp"         // for Log
 #include "../util/solverconfig.hpp"
-#include "generated_config.hpp" // for DOUBLE_DELTA
+#include "../util/threadgroup.hpp" // for ThreadGroup
+#include "generated_config.hpp"    // for DOUBLE_DELTA
 
 #include <algorithm> // for max, min
 #include <assert.h>  // for assert
 #include <chrono>
+#include <cmath> // for floor
+#include <cstdint> // for uint64_t
+#include <cstdio>  // for rename
 #include <ext/alloc_traits.h> // for __alloc_tra...
+#include <fstream>            // for ifstream, ofstream
 #include <functional>         // for function
 #include <limits>             // for numeric_limits
+#include <map>                // for map
 #include <memory>             // for allocator
+#include <sstream>            // for ostringstream
+#include <thread>             // for thread
+#include <unordered_set>      // for unordered_set
 
 #if defined(GUROBI_FOUND)
 #include "../contrib/ilpabstraction/src/ilpa_gurobi.hpp"
@@ -31,13 +43,18 @@
 #include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
 #endif
 
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
 template <class SolverT>
 ILPBase<SolverT>::ILPBase(const Instance & instance_in,
                           AdditionalResultStorage & additional,
                           const SolverConfig & sconf_in)
     : instance(instance_in), env(false), model(env.create_model()),
       start_points_set(false), earliest_release(0), latest_deadline(0),
-      timelimit(-1), seed(0), optimized(false), collect_kappa_stats(false),
+      propagate_windows(true), timelimit(-1), seed(0), optimized(false), collect_kappa_stats(false),
+      warmstart_heuristic_done(false), model_cacheable(true),
       additional_storage(additional), sconf(sconf_in),
       cb(this->timer, this->additional_storage, this->l), l("ILPBase")
 {
@@ -57,6 +74,36 @@ ILPBase<SolverT>::ILPBase(const Instance & instance_in,
 		this->collect_kappa_stats = sconf.as_bool("collect_kappa_stats");
 	}
 
+	if (sconf.has_config("propagate_windows")) {
+		this->propagate_windows = sconf.as_bool("propagate_windows");
+	}
+
+	if (sconf.has_config("warmstart_heuristic")) {
+		std::string heuristic = sconf["warmstart_heuristic"];
+		if ((heuristic.compare("swag") == 0) || (heuristic.compare("grasp") == 0)) {
+			this->warmstart_heuristic = heuristic;
+		} else {
+			BOOST_LOG(l.e()) << "Unknown warm start heuristic: " << heuristic;
+		}
+	}
+
+	if (sconf.has_config("portfolio_heuristic")) {
+		std::string heuristic = sconf["portfolio_heuristic"];
+		if ((heuristic.compare("swag") == 0) || (heuristic.compare("grasp") == 0)) {
+			this->portfolio_heuristic = heuristic;
+		} else {
+			BOOST_LOG(l.e()) << "Unknown portfolio heuristic: " << heuristic;
+		}
+	}
+
+	if (sconf.has_config("model_cache_dir")) {
+		if constexpr (ilp_detail::supports_model_io<SolverT>::value) {
+			this->model_cache_dir = std::string(sconf["model_cache_dir"]);
+		} else {
+			BOOST_LOG(l.w()) << "The MIP solver can not read models. Not caching.";
+		}
+	}
+
 	// FIXME Require: flat-resource-availability, linear-costs
 
 	// Actually, why shouldn't it be possible to do negative lags?
@@ -88,6 +135,15 @@ ILPBase<SolverT>::get_lower_bound()
 	return Maybe<double>(this->model.get_bound());
 }
 
+template <class SolverT>
+bool
+ILPBase<SolverT>::runs_foreign_threads() const
+{
+	// Without a limit, MIP solvers use all cores
+	return !Configuration::get()->get_threads().valid() ||
+	       (Configuration::get()->get_threads().value() > 1);
+}
+
 template <class SolverT>
 void
 ILPBase<SolverT>::compute_values()
@@ -109,6 +165,86 @@ ILPBase<SolverT>::compute_values()
 	this->earliest_release = (unsigned int)std::max(
 	    0, static_cast<int>(this->earliest_release) -
 	           static_cast<int>(this->instance.get_window_extension_limit()));
+
+	this->compute_start_windows();
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::compute_start_windows()
+{
+	const unsigned int job_count = this->instance.job_count();
+	const int extension =
+	    static_cast<int>(this->instance.get_window_extension_limit());
+	const int hard_deadline =
+	    this->instance.get_window_extension_hard_deadline().value_or_default(
+	        std::numeric_limits<int>::max());
+
+	this->start_windows.resize(job_count);
+	for (unsigned int jid = 0; jid < job_count; ++jid) {
+		const Job & job = this->instance.get_job(jid);
+		int earliest = std::max(static_cast<int>(job.get_release()) - extension, 0);
+		int latest_finish =
+		    std::min(static_cast<int>(job.get_deadline()) + extension, hard_deadline);
+		int latest = std::max(latest_finish - static_cast<int>(job.get_duration()),
+		                      0);
+		this->start_windows[jid] = {static_cast<unsigned int>(earliest),
+		                            static_cast<unsigned int>(latest)};
+	}
+
+	if (!this->propagate_windows) {
+		return;
+	}
+
+	// Propagate the extended windows along the lag graph
+	std::vector<unsigned int> earliest_starts;
+	std::vector<unsigned int> latest_finishs;
+	try {
+		CriticalPathComputer cpc(this->instance, static_cast<unsigned int>(extension),
+		                         static_cast<unsigned int>(hard_deadline));
+		earliest_starts = cpc.get_forward();
+		latest_finishs = cpc.get_reverse();
+	} catch (const InconsistentDataError &) {
+		BOOST_LOG(l.w()) << "Window propagation found a negative latest finish "
+		                    "time. The instance is infeasible, not propagating.";
+		return;
+	}
+
+	for (unsigned int jid = 0; jid < job_count; ++jid) {
+		int latest = std::max(static_cast<int>(latest_finishs[jid]) -
+		                          static_cast<int>(this->instance.get_job(jid)
+		                                               .get_duration()),
+		                      0);
+		this->start_windows[jid] = {earliest_starts[jid],
+		                            static_cast<unsigned int>(latest)};
+	}
+
+	size_t removed = 0;
+	for (unsigned int jid = 0; jid < job_count; ++jid) {
+		auto & window = this->start_windows[jid];
+		if (window.first > window.second) {
+			BOOST_LOG(l.w()) << "Job " << jid << " has an empty start window ["
+			                 << window.first << ", " << window.second
+			                 << "]. The instance is infeasible.";
+			window.second = window.first;
+		}
+
+		const Job & job = this->instance.get_job(jid);
+		int unpropagated_earliest =
+		    std::max(static_cast<int>(job.get_release()) - extension, 0);
+		int unpropagated_latest =
+		    std::max(std::min(static_cast<int>(job.get_deadline()) + extension,
+		                      hard_deadline) -
+		                 static_cast<int>(job.get_duration()),
+		             0);
+		removed += static_cast<size_t>(std::max(
+		    (unpropagated_latest - unpropagated_earliest) -
+		        (static_cast<int>(window.second) - static_cast<int>(window.first)),
+		    0));
+	}
+
+	BOOST_LOG(l.d(1)) << "Window propagation removed " << removed
+	                  << " possible start times.";
 }
 
 template <class SolverT>
@@ -121,13 +257,103 @@ ILPBase<SolverT>::prepare_edge_constraints()
 		return;
 	}
 
+	RowBuffer rows;
 	for (const auto & edge : this->instance.get_laggraph().edges()) {
 		LagGraph::vertex from = edge.s, to = edge.t;
 		double lag = edge.lag;
 
-		this->model.add_constraint(this->start_points[from] + lag,
-		                           this->start_points[to], MIPSolver::INFTY);
+		// start[to] - start[from] >= lag
+		rows.add(this->start_points[to], 1.0);
+		rows.add(this->start_points[from], -1.0);
+		rows.finish_row(lag, MIPSolver::INFTY);
+	}
+	this->add_rows(rows);
+}
+
+template <class SolverT>
+ILPBase<SolverT>::RowBuffer::RowBuffer() : starts{0}
+{}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::RowBuffer::add(Variable var, double coef)
+{
+	this->vars.push_back(var);
+	this->coefs.push_back(coef);
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::RowBuffer::finish_row(double lower_in, double upper_in,
+                                        std::string name)
+{
+	this->lower.push_back(lower_in);
+	this->upper.push_back(upper_in);
+	this->names.push_back(std::move(name));
+	this->starts.push_back(this->vars.size());
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::RowBuffer::clear()
+{
+	this->lower.clear();
+	this->upper.clear();
+	this->starts.clear();
+	this->starts.push_back(0);
+	this->vars.clear();
+	this->coefs.clear();
+	this->names.clear();
+}
+
+template <class SolverT>
+size_t
+ILPBase<SolverT>::RowBuffer::size() const
+{
+	return this->lower.size();
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::add_rows(RowBuffer & rows)
+{
+	if constexpr (ilp_detail::supports_bulk_constraints<SolverT>::value) {
+		this->model.add_constraints(rows.lower, rows.upper, rows.starts, rows.vars,
+		                            rows.coefs, rows.names);
+	} else {
+		for (size_t row = 0; row < rows.size(); ++row) {
+			Expression expr = this->env.create_expression();
+			for (size_t k = rows.starts[row]; k < rows.starts[row + 1]; ++k) {
+				expr += rows.coefs[k] * rows.vars[k];
+			}
+			this->model.add_constraint(rows.lower[row], expr, rows.upper[row],
+			                           rows.names[row]);
+		}
 	}
+
+	rows.clear();
+}
+
+template <class SolverT>
+std::chrono::high_resolution_clock::time_point
+ILPBase<SolverT>::record_build_phase(
+    const std::string & phase,
+    std::chrono::high_resolution_clock::time_point started)
+{
+	auto now = std::chrono::high_resolution_clock::now();
+	double ms =
+	    std::chrono::duration<double, std::milli>(now - started).count();
+
+	BOOST_LOG(l.d(2)) << "Model build phase " << phase << " took " << ms
+	                  << "ms";
+	this->additional_storage.extended_measures.push_back(
+	    {std::string("MODEL_BUILD_") + phase + std::string("_ms"),
+	     Maybe<unsigned int>(),
+	     Maybe<double>(),
+	     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
+	     {ms}});
+
+	return now;
 }
 
 template <class SolverT>
@@ -309,7 +535,7 @@ ILPBase<SolverT>::base_run()
 
 template <class SolverT>
 void
-ILPBase<SolverT>::prepare_pre()
+ILPBase<SolverT>::prepare_params()
 {
 	this->model.set_param(ParamType::LOG_TO_CONSOLE, false);
 	this->model.add_callback(&this->cb);
@@ -352,13 +578,23 @@ ILPBase<SolverT>::prepare_pre()
 			BOOST_LOG(l.e()) << "Could not parse 'focus' parameter";
 		}
 	}
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::prepare_pre()
+{
+	this->prepare_params();
 
 	this->prepare_started = std::chrono::high_resolution_clock::now();
 
 	BOOST_LOG(l.d()) << "Preparing Base Variables";
 	this->prepare_base_variables();
+	auto phase_start =
+	    this->record_build_phase("BASE_VARIABLES", this->prepare_started);
 
 	this->compute_values();
+	this->record_build_phase("START_WINDOWS", phase_start);
 }
 
 template <class SolverT>
@@ -371,18 +607,10 @@ ILPBase<SolverT>::generate_vars_start_points()
 	this->start_points.resize(this->instance.job_count());
 
 	for (unsigned int i = 0; i < this->instance.job_count(); i++) {
-		const Job & job = this->instance.get_job(i);
-		int earliest_start_with_extension = std::max(
-		    (static_cast<int>(job.get_release()) -
-		     static_cast<int>(this->instance.get_window_extension_limit())),
-		    0);
-		unsigned int latest_finish_with_extension =
-		    job.get_deadline() + this->instance.get_window_extension_limit();
-
 		// Start points
 		this->start_points[i] = this->model.add_var(
-		    ilpabstraction::VariableType::INTEGER, earliest_start_with_extension,
-		    latest_finish_with_extension - job.get_duration(),
+		    ilpabstraction::VariableType::INTEGER, this->start_windows[i].first,
+		    this->start_windows[i].second,
 		    std::string("start_point_" + std::to_string(i)));
 	}
 
@@ -435,14 +663,184 @@ ILPBase<SolverT>::prepare_base_variables()
 	                        MIPSolver::INFTY, std::string("investment_costs"));
 }
 
+template <class SolverT>
+std::string
+ILPBase<SolverT>::get_model_cache_key(const std::string & formulation) const
+{
+	// Keys that do not change the built model
+	static const std::unordered_set<std::string> ignored_keys = {
+	    "model_cache_dir",     "dump_path",          "dump_solution_path",
+	    "focus",               "collect_kappa_stats", "initialize_with_early",
+	    "warmstart_heuristic", "warmstart_time",     "warmstart_config",
+	    "portfolio_heuristic", "portfolio_config"};
+
+	std::ostringstream key;
+	key << this->instance.get_id() << "|" << formulation << "|"
+	    << this->instance.get_window_extension_limit() << "|"
+	    << this->instance.get_window_extension_job_limit() << "|";
+	if (this->instance.get_window_extension_hard_deadline().valid()) {
+		key << this->instance.get_window_extension_hard_deadline().value();
+	}
+
+	// std::map, so the order is stable
+	for (const auto & kv : this->sconf.get_kvs()) {
+		if (ignored_keys.find(kv.first) == ignored_keys.end()) {
+			key << "|" << kv.first << "=" << kv.second.dump();
+		}
+	}
+
+	return key.str();
+}
+
+template <class SolverT>
+std::string
+ILPBase<SolverT>::get_model_cache_path(const std::string & formulation) const
+{
+	// FNV-1a, std::hash is not guaranteed to be stable across builds
+	std::string key = this->get_model_cache_key(formulation);
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : key) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+
+	std::ostringstream path;
+	path << this->model_cache_dir.value() << "/" << std::hex << std::setw(16)
+	     << std::setfill('0') << hash;
+	return path.str();
+}
+
+template <class SolverT>
+bool
+ILPBase<SolverT>::load_cached_model(const std::string & formulation)
+{
+	if (!this->model_cache_dir.valid() || !this->model_cacheable) {
+		return false;
+	}
+
+	if constexpr (ilp_detail::supports_model_io<SolverT>::value) {
+		std::string path = this->get_model_cache_path(formulation);
+		std::ifstream index_file(path + ".json");
+		if (!index_file.good()) {
+			BOOST_LOG(l.d(1)) << "Model cache miss for " << path;
+			return false;
+		}
+
+		std::string key;
+		std::vector<unsigned int> columns;
+		try {
+			json index;
+			index_file >> index;
+			key = index.at("key").get<std::string>();
+			columns = index.at("start_points").get<std::vector<unsigned int>>();
+		} catch (const json::exception & e) {
+			BOOST_LOG(l.w()) << "Corrupt model cache index " << path << ".json";
+			return false;
+		}
+
+		// Guards against hash collisions
+		if (key != this->get_model_cache_key(formulation)) {
+			BOOST_LOG(l.w()) << "Model cache key collision at " << path;
+			return false;
+		}
+
+		if (columns.size() != this->instance.job_count()) {
+			BOOST_LOG(l.w()) << "Model cache index " << path
+			                 << ".json does not match the instance";
+			return false;
+		}
+
+		this->prepare_started = std::chrono::high_resolution_clock::now();
+		if (!this->model.read(path + ".mps")) {
+			BOOST_LOG(l.w()) << "Could not read cached model " << path << ".mps";
+			return false;
+		}
+		this->prepare_params();
+		this->compute_values();
+
+		this->start_points.resize(columns.size());
+		for (size_t jid = 0; jid < columns.size(); ++jid) {
+			this->start_points[jid] = this->model.variable_at(columns[jid]);
+		}
+		this->start_points_set = true;
+
+		this->prepare_finished = std::chrono::high_resolution_clock::now();
+		BOOST_LOG(l.i()) << "Loaded model from cache " << path << ".mps";
+
+		this->additional_storage.extended_measures.push_back(
+		    {"MODEL_CACHE_HIT",
+		     Maybe<unsigned int>(),
+		     Maybe<double>(),
+		     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+		     {1}});
+
+		return true;
+	} else {
+		(void)formulation;
+		return false;
+	}
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::store_cached_model(const std::string & formulation)
+{
+	if (!this->model_cache_dir.valid() || !this->model_cacheable) {
+		return;
+	}
+	if (!this->start_points_set) {
+		BOOST_LOG(l.d(1)) << "No start point variables, not caching the model.";
+		return;
+	}
+
+	if constexpr (ilp_detail::supports_model_io<SolverT>::value) {
+		std::string path = this->get_model_cache_path(formulation);
+
+		json index;
+		index["key"] = this->get_model_cache_key(formulation);
+		std::vector<unsigned int> columns;
+		for (const Variable & var : this->start_points) {
+			columns.push_back(this->model.index_of(var));
+		}
+		index["start_points"] = columns;
+
+		/* Concurrent runs may store the same model. Write to temporary files
+		 * and rename, so nobody reads a half-written model. The index is
+		 * renamed last, it marks the model as complete. */
+		std::string tmp_suffix =
+		    ".tmp" + std::to_string(std::hash<std::thread::id>{}(
+		                 std::this_thread::get_id()));
+		this->model.write(path + tmp_suffix + ".mps");
+		{
+			std::ofstream index_file(path + tmp_suffix + ".json");
+			index_file << index.dump();
+		}
+
+		if ((std::rename((path + tmp_suffix + ".mps").c_str(),
+		                 (path + ".mps").c_str()) != 0) ||
+		    (std::rename((path + tmp_suffix + ".json").c_str(),
+		                 (path + ".json").c_str()) != 0)) {
+			BOOST_LOG(l.w()) << "Could not store model in cache at " << path;
+			return;
+		}
+
+		BOOST_LOG(l.d(1)) << "Stored model in cache at " << path << ".mps";
+	} else {
+		(void)formulation;
+	}
+}
+
 template <class SolverT>
 void
 ILPBase<SolverT>::prepare_post()
 {
+	auto phase_start = std::chrono::high_resolution_clock::now();
 	BOOST_LOG(l.d()) << "Preparing Edge Constraints";
 	this->prepare_edge_constraints();
+	phase_start = this->record_build_phase("EDGE_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing Objective";
 	this->prepare_objective();
+	this->record_build_phase("OBJECTIVE", phase_start);
 
 	this->prepare_finished = std::chrono::high_resolution_clock::now();
 }
@@ -457,6 +855,8 @@ ILPBase<SolverT>::do_initialization()
 		return;
 	}
 
+	Maybe<Solution> initial_sol;
+
 	if (this->initialize_with_early) {
 		BOOST_LOG(l.d(1)) << "Initializing with EarlyScheduler results";
 
@@ -468,10 +868,24 @@ ILPBase<SolverT>::do_initialization()
 		es.run();
 		Solution es_sol = es.get_solution();
 		BOOST_LOG(l.d(2)) << "ES Solution quality: " << es_sol.get_costs();
+		initial_sol = es_sol;
+	}
+
+	Maybe<Solution> heuristic_sol = this->run_warmstart_heuristic();
+	if (heuristic_sol.valid()) {
+		BOOST_LOG(l.d(2)) << "Heuristic solution quality: "
+		                  << heuristic_sol.value().get_costs();
+		if (!initial_sol.valid() ||
+		    (heuristic_sol.value().get_costs() < initial_sol.value().get_costs())) {
+			BOOST_LOG(l.d(1)) << "Initializing with heuristic results";
+			initial_sol = heuristic_sol;
+		}
+	}
 
+	if (initial_sol.valid()) {
 		for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
 			this->model.set_start(this->start_points[jid],
-			                      es_sol.get_start_time(jid));
+			                      initial_sol.value().get_start_time(jid));
 		}
 	}
 
@@ -489,26 +903,179 @@ ILPBase<SolverT>::do_initialization()
 	}
 }
 
+template <class SolverT>
+Maybe<Solution>
+ILPBase<SolverT>::run_warmstart_heuristic()
+{
+	if (!this->warmstart_heuristic.valid() || this->warmstart_heuristic_done) {
+		return this->warmstart_heuristic_solution;
+	}
+	this->warmstart_heuristic_done = true;
+
+	// By default, spend a tenth of the time limit on the heuristic
+	unsigned int budget = 10;
+	if (this->sconf.has_config("warmstart_time")) {
+		budget = this->sconf["warmstart_time"];
+	} else if (this->timelimit > 0) {
+		budget = static_cast<unsigned int>(std::max(1, this->timelimit / 10));
+	}
+
+	SolverConfig heuristic_conf =
+	    this->get_heuristic_config("warmstart_config", budget);
+
+	BOOST_LOG(l.d(1)) << "Running " << this->warmstart_heuristic.value()
+	                  << " for " << budget << "s to obtain a MIP start";
+
+	auto heuristic_started = std::chrono::steady_clock::now();
+	if (this->warmstart_heuristic.value().compare("swag") == 0) {
+		this->warmstart_heuristic_solution =
+		    this->run_heuristic<swag::SWAGSolver>(heuristic_conf);
+	} else {
+		this->warmstart_heuristic_solution = this->run_heuristic<
+		    grasp::GRASP<grasp::detail::GraspRandom,
+		                 grasp::implementation::GraspSkyline>>(heuristic_conf);
+	}
+	auto heuristic_time = std::chrono::steady_clock::now() - heuristic_started;
+
+	AdditionalResultStorage::ExtendedMeasure em_wst{
+	    "WARMSTART_TIME_ms",
+	    Maybe<unsigned int>(),
+	    Maybe<double>(),
+	    AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
+	    {static_cast<double>(
+	        std::chrono::duration_cast<std::chrono::milliseconds>(heuristic_time)
+	            .count())}};
+	this->additional_storage.extended_measures.push_back(em_wst);
+
+	if (this->warmstart_heuristic_solution.valid()) {
+		AdditionalResultStorage::ExtendedMeasure em_wsc{
+		    "WARMSTART_COSTS",
+		    Maybe<unsigned int>(),
+		    Maybe<double>(),
+		    AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
+		    {this->warmstart_heuristic_solution.value().get_costs()}};
+		this->additional_storage.extended_measures.push_back(em_wsc);
+	}
+
+	return this->warmstart_heuristic_solution;
+}
+
+template <class SolverT>
+SolverConfig
+ILPBase<SolverT>::get_heuristic_config(const std::string & key,
+                                       unsigned int budget) const
+{
+	std::map<std::string, json_entry> values;
+	if (this->sconf.has_config(key)) {
+		for (const auto & item : this->sconf[key].items()) {
+			values[item.key()] = item.value();
+		}
+	}
+
+	return SolverConfig("HEURISTIC", "HEURISTIC", values,
+	                    Maybe<unsigned int>(budget), false, 1, {},
+	                    Maybe<int>(this->sconf.get_seed()));
+}
+
 template <class SolverT>
 void
-ILPBase<SolverT>::solve(Maybe<unsigned int> time_limit)
+ILPBase<SolverT>::run_portfolio_heuristic(unsigned int budget)
+{
+	SolverConfig heuristic_conf =
+	    this->get_heuristic_config("portfolio_config", budget);
+
+	BOOST_LOG(l.d(1)) << "Running " << this->portfolio_heuristic.value()
+	                  << " concurrently to the MIP";
+
+	if (this->portfolio_heuristic.value().compare("swag") == 0) {
+		this->run_heuristic<swag::SWAGSolver>(heuristic_conf,
+		                                      this->exchange.get());
+	} else {
+		this->run_heuristic<grasp::GRASP<grasp::detail::GraspRandom,
+		                                 grasp::implementation::GraspSkyline>>(
+		    heuristic_conf, this->exchange.get());
+	}
+
+	BOOST_LOG(l.d(1)) << "Portfolio heuristic finished";
+}
+
+template <class SolverT>
+template <class HeuristicT>
+Maybe<Solution>
+ILPBase<SolverT>::run_heuristic(const SolverConfig & heuristic_conf,
+                                manager::IncumbentExchange * heuristic_exchange)
+{
+	if (!this->instance.get_traits().fulfills(HeuristicT::get_requirements())) {
+		BOOST_LOG(l.w()) << "Instance does not fulfill the requirements of "
+		                 << HeuristicT::get_id() << ". Not running it.";
+		return Maybe<Solution>();
+	}
+
+	// A failing heuristic should never take the MIP down with it
+	try {
+		AdditionalResultStorage dummy_storage;
+		HeuristicT heuristic(this->instance, dummy_storage, heuristic_conf);
+		if (heuristic_exchange != nullptr) {
+			heuristic.set_incumbent_exchange(heuristic_exchange);
+		}
+		heuristic.run();
+		return Maybe<Solution>(heuristic.get_solution());
+	} catch (const std::exception & e) {
+		BOOST_LOG(l.e()) << "Heuristic failed: " << e.what();
+		return Maybe<Solution>();
+	}
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::solve(Maybe<unsigned int> time_limit, bool initialize)
 {
 	this->optimized = false;
 	this->timer.start();
 
+	// Initialization (possibly running a heuristic) counts against the limit
+	if (initialize) {
+		this->do_initialization();
+	}
+
+	int remaining = std::numeric_limits<int>::max();
 	if (time_limit.valid()) {
-		BOOST_LOG(l.d(3)) << "Setting time limit: " << time_limit.value();
-		this->model.set_param(ParamType::TIME_LIMIT,
-		                      static_cast<int>(time_limit.value()));
+		remaining = std::max(1, static_cast<int>(time_limit.value()) -
+		                            static_cast<int>(std::floor(this->timer.get())));
+		BOOST_LOG(l.d(3)) << "Setting time limit: " << remaining;
+		this->model.set_param(ParamType::TIME_LIMIT, remaining);
 	} else {
 		BOOST_LOG(l.d(3)) << "Running without time limit.";
 		// this->model.set_param(ParamType::TIME_LIMIT,
 		// std::numeric_limits<int>::max());
 	}
 
-	this->do_initialization();
+	std::thread portfolio_thread;
+	if (this->portfolio_heuristic.valid()) {
+		if constexpr (!ilp_detail::supports_incumbent_exchange<SolverT>::value) {
+			BOOST_LOG(l.w()) << "The MIP solver can not exchange incumbents during "
+			                    "the solve. Only sharing the bound.";
+		}
+		this->exchange = std::make_unique<manager::IncumbentExchange>(
+		    this->instance, this->additional_storage, this->timer);
+		this->cb.set_exchange(this->exchange.get(), this->start_points_set
+		                                                ? &this->start_points
+		                                                : nullptr);
+		portfolio_thread = std::thread(
+		    [this, remaining, group = util::ThreadGroup::current()]() {
+			    util::ThreadGroup::Membership membership(group);
+			    this->run_portfolio_heuristic(static_cast<unsigned int>(remaining));
+		    });
+	}
+
 	this->model.solve();
 
+	if (portfolio_thread.joinable()) {
+		this->exchange->stop();
+		portfolio_thread.join();
+		this->cb.set_exchange(nullptr, nullptr);
+	}
+
 	switch (this->model.get_status()) {
 	case ModelStatus::OPTIMAL:
 		BOOST_LOG(l.i()) << "Model optimized.";
@@ -539,13 +1106,27 @@ template <class SolverT>
 Solution
 ILPBase<SolverT>::get_solution()
 {
-	if (this->start_points_set) {
-		return this->get_solution_by_start_vars();
-	} else {
-		return Solution(this->instance, this->optimized,
-		                this->computed_solution_start_times,
-		                this->get_lower_bound());
+	Solution sol = this->start_points_set
+	                   ? this->get_solution_by_start_vars()
+	                   : Solution(this->instance, this->optimized,
+	                              this->computed_solution_start_times,
+	                              this->get_lower_bound());
+
+	// In portfolio mode, the heuristic might have found something better
+	if (this->exchange) {
+		Maybe<double> exchange_costs = this->exchange->get_costs();
+		if (exchange_costs.valid() &&
+		    (!sol.is_feasible() ||
+		     (exchange_costs.value() < sol.get_costs() - DOUBLE_DELTA))) {
+			BOOST_LOG(l.d(1)) << "Reporting the portfolio incumbent";
+			std::vector<unsigned int> start_times =
+			    this->exchange->get_start_times();
+			return Solution(this->instance, false, start_times,
+			                this->get_lower_bound());
+		}
 	}
+
+	return sol;
 }
 
 template <class SolverT>
@@ -620,10 +1201,66 @@ template <class SolverT>
 ILPBase<SolverT>::Callback::Callback(
     const Timer & timer_in, AdditionalResultStorage & additional_storage_in,
     Log & l_in)
-    : timer(timer_in), additional_storage(additional_storage_in), last_log(0),
+    : exchange(nullptr), exchange_start_points(nullptr), exchange_version(0),
+      timer(timer_in), additional_storage(additional_storage_in), last_log(0),
       lines_before_header(0), l(l_in)
 {}
 
+template <class SolverT>
+void
+ILPBase<SolverT>::Callback::set_exchange(
+    manager::IncumbentExchange * exchange_in,
+    const std::vector<Variable> * start_points)
+{
+	this->exchange = exchange_in;
+	this->exchange_start_points = start_points;
+	this->exchange_version = 0;
+}
+
+template <class SolverT>
+void
+ILPBase<SolverT>::Callback::exchange_incumbents(
+    typename MIPSolver::Callback::Context & ctx)
+{
+	// Lets the heuristic terminate early if it matches the bound
+	this->exchange->offer_bound(this->get_bound(ctx));
+
+	if constexpr (ilp_detail::supports_incumbent_exchange<SolverT>::value) {
+		if (this->exchange_start_points == nullptr) {
+			return;
+		}
+		const std::vector<Variable> & vars = *this->exchange_start_points;
+
+		if (this->has_incumbent(ctx)) {
+			std::vector<unsigned int> start_times(vars.size());
+			for (size_t jid = 0; jid < vars.size(); ++jid) {
+				start_times[jid] = static_cast<unsigned int>(
+				    std::round(this->get_incumbent_value(ctx, vars[jid])));
+			}
+			this->exchange->offer(
+			    start_times, AdditionalResultStorage::IntermediateResult::SOURCE_MIP);
+		}
+
+		if (this->can_set_solution(ctx)) {
+			std::vector<unsigned int> incumbent;
+			double incumbent_costs;
+			if (this->exchange->fetch(
+			        AdditionalResultStorage::IntermediateResult::SOURCE_MIP,
+			        this->exchange_version, incumbent, incumbent_costs)) {
+				BOOST_LOG(l.d(2)) << "Injecting heuristic incumbent with costs "
+				                  << incumbent_costs;
+				// Only the start points are set, the solver completes the rest
+				std::vector<double> values(incumbent.begin(), incumbent.end());
+				this->set_solution(ctx, vars, values);
+			}
+		}
+
+		if (this->exchange->should_stop()) {
+			this->request_interrupt(ctx);
+		}
+	}
+}
+
 template <class SolverT>
 void
 ILPBase<SolverT>::Callback::log_intermediate()
@@ -671,6 +1308,10 @@ template <class SolverT>
 void
 ILPBase<SolverT>::Callback::on_poll(typename MIPSolver::Callback::Context & ctx)
 {
+	if (this->exchange != nullptr) {
+		this->exchange_incumbents(ctx);
+	}
+
 	if (this->timer.get() > this->last_log + LOG_INTERVAL) {
 		double obj_val = this->get_objective_value(ctx);
 		double obj_bound = this->get_bound(ctx);
@@ -720,3 +1361,7 @@ template class ILPBase<ilpabstraction::GurobiInterface>;
 #if defined(CPLEX_FOUND)
 template class ILPBase<ilpabstraction::CPLEXInterface>;
 #endif
+
+#if defined(HIGHS_FOUND)
+template class ILPBase<ilpabstraction::HighsInterface>;
+#endif
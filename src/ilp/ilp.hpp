@@ -8,13 +8,67 @@
 #include "../util/log.hpp"                          // for Log
 
 #include <chrono>
-#include <iomanip> // for operator<<
-#include <string>  // for string
-#include <vector>  // for vector
+#include <iomanip>     // for operator<<
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+#include <type_traits> // for false_type, true_type, void_t
+#include <utility>     // for pair
+#include <vector>      // for vector
 class AdditionalResultStorage;
 class Instance;
 class SolverConfig;
 class Traits;
+namespace manager {
+class IncumbentExchange;
+}
+
+namespace ilp_detail {
+/* Whether the MIP solver's callbacks can read and inject incumbents. Only
+ * interfaces that set Callback::SUPPORTS_INCUMBENT_EXCHANGE do. */
+template <class MIPSolverT, class = void>
+struct supports_incumbent_exchange : std::false_type
+{
+};
+
+template <class MIPSolverT>
+struct supports_incumbent_exchange<
+    MIPSolverT,
+    std::void_t<decltype(MIPSolverT::Callback::SUPPORTS_INCUMBENT_EXCHANGE)>>
+    : std::integral_constant<bool,
+                             MIPSolverT::Callback::SUPPORTS_INCUMBENT_EXCHANGE>
+{
+};
+
+/* Whether the MIP solver's models accept rows in bulk via add_constraints().
+ * Only interfaces that set Model::SUPPORTS_BULK_CONSTRAINTS do. */
+template <class MIPSolverT, class = void>
+struct supports_bulk_constraints : std::false_type
+{
+};
+
+template <class MIPSolverT>
+struct supports_bulk_constraints<
+    MIPSolverT,
+    std::void_t<decltype(MIPSolverT::Model::SUPPORTS_BULK_CONSTRAINTS)>>
+    : std::integral_constant<bool,
+                             MIPSolverT::Model::SUPPORTS_BULK_CONSTRAINTS>
+{
+};
+
+/* Whether the MIP solver's models can be read back from a file written by
+ * write(). Only interfaces that set Model::SUPPORTS_MODEL_IO do. */
+template <class MIPSolverT, class = void>
+struct supports_model_io : std::false_type
+{
+};
+
+template <class MIPSolverT>
+struct supports_model_io<
+    MIPSolverT, std::void_t<decltype(MIPSolverT::Model::SUPPORTS_MODEL_IO)>>
+    : std::integral_constant<bool, MIPSolverT::Model::SUPPORTS_MODEL_IO>
+{
+};
+} // namespace ilp_detail
 
 /* This is the basic discrete-time formulation of Kone et al. taken from
  * 10.1016/j.cor.2009.12.011
@@ -43,6 +97,10 @@ public:
 
 	Maybe<double> get_lower_bound();
 
+	/* Whether the MIP solver may start threads of its own. Per-thread
+	 * resource measurements can not count those. */
+	bool runs_foreign_threads() const;
+
 	static const Traits & get_requirements();
 
 	Solution get_solution();
@@ -57,7 +115,17 @@ protected:
 		virtual void on_message(typename MIPSolver::Callback::Context & ctx,
 		                        std::string & message) override;
 
+		/* Portfolio mode: share incumbents (as values of the start point
+		 * variables) and bounds with the heuristic via the exchange. */
+		void set_exchange(manager::IncumbentExchange * exchange,
+		                  const std::vector<Variable> * start_points);
+
 	private:
+		void exchange_incumbents(typename MIPSolver::Callback::Context & ctx);
+		manager::IncumbentExchange * exchange;
+		const std::vector<Variable> * exchange_start_points;
+		size_t exchange_version;
+
 		const double LOG_INTERVAL = 10; // seconds
 		const int REPEAT_HEADER = 30;
 
@@ -72,10 +140,54 @@ protected:
 		Log & l;
 	};
 
+	/* Rows collected for insertion via add_rows(). Row i consists of the
+	 * entries [starts[i], starts[i + 1]). */
+	class RowBuffer {
+	public:
+		RowBuffer();
+		void add(Variable var, double coef);
+		void finish_row(double lower, double upper, std::string name = "");
+		void clear();
+		size_t size() const;
+
+		std::vector<double> lower;
+		std::vector<double> upper;
+		std::vector<size_t> starts;
+		std::vector<Variable> vars;
+		std::vector<double> coefs;
+		std::vector<std::string> names;
+	};
+
+	/* Adds all rows at once if the MIP solver supports it, otherwise one
+	 * Expression per row. Clears the buffer. */
+	void add_rows(RowBuffer & rows);
+
+	/* Records the time since 'started' as extended measure
+	 * MODEL_BUILD_<phase>_ms. Returns the current time, so that consecutive
+	 * phases can be chained. */
+	std::chrono::high_resolution_clock::time_point
+	record_build_phase(const std::string & phase,
+	                   std::chrono::high_resolution_clock::time_point started);
+
 	void prepare_base_variables();
+	void prepare_params();
 	void prepare_pre();
 	void prepare_post();
 
+	/* Model cache ('model_cache_dir'). The built model is stored together
+	 * with the indices of the start point variables, keyed by the instance,
+	 * the formulation and all configuration keys that influence the model.
+	 * A loaded model only knows its start point variables, so formulations
+	 * that need any other variable after building must set model_cacheable
+	 * to false.
+	 *
+	 * load_cached_model() replaces prepare() and returns false on a cache
+	 * miss. store_cached_model() is called after prepare(). */
+	bool load_cached_model(const std::string & formulation);
+	void store_cached_model(const std::string & formulation);
+	std::string get_model_cache_key(const std::string & formulation) const;
+	std::string get_model_cache_path(const std::string & formulation) const;
+
 	void base_run();
 
 	// constraint (4)
@@ -87,9 +199,33 @@ protected:
 	void prepare_objective();
 
 	void do_initialization();
-	void solve(Maybe<unsigned int> time_limit);
+	/* If initialize is false, the caller is responsible for the MIP start and
+	 * neither the EarlyScheduler nor the warm start heuristic are run. */
+	void solve(Maybe<unsigned int> time_limit, bool initialize = true);
+
+	/* Pipeline mode: runs the configured heuristic ('warmstart_heuristic') for
+	 * a short budget before the MIP and returns its best solution. The result
+	 * is cached, subsequent calls do not run the heuristic again. */
+	Maybe<Solution> run_warmstart_heuristic();
+	/* Builds the configuration for a heuristic from the object stored at key
+	 * in our configuration. */
+	SolverConfig get_heuristic_config(const std::string & key,
+	                                  unsigned int budget) const;
+	template <class HeuristicT>
+	Maybe<Solution>
+	run_heuristic(const SolverConfig & heuristic_conf,
+	              manager::IncumbentExchange * heuristic_exchange = nullptr);
+
+	/* Portfolio mode: runs the configured heuristic ('portfolio_heuristic')
+	 * concurrently to the MIP. Both share their incumbents and the MIP's bound
+	 * via an IncumbentExchange. */
+	void run_portfolio_heuristic(unsigned int budget);
 	void compute_values();
 
+	/* Computes start_windows by propagating the (extended) release / deadline
+	 * windows along the lag graph. */
+	void compute_start_windows();
+
 	Solution get_solution_by_start_vars();
 
 	MIPSolver env;
@@ -130,6 +266,12 @@ protected:
 	unsigned int earliest_release;
 	unsigned int latest_deadline;
 
+	/* [earliest start, latest start] of every job, taking window extensions
+	 * and the lag graph into account. Every feasible solution starts its jobs
+	 * within these windows, so formulations only need variables inside them. */
+	std::vector<std::pair<unsigned int, unsigned int>> start_windows;
+	bool propagate_windows;
+
 	int timelimit;
 	int seed;
 	bool optimized;
@@ -137,6 +279,16 @@ protected:
 	bool initialize_with_early;
 	bool collect_kappa_stats;
 
+	Maybe<std::string> warmstart_heuristic;
+	bool warmstart_heuristic_done;
+	Maybe<Solution> warmstart_heuristic_solution;
+
+	Maybe<std::string> portfolio_heuristic;
+	std::unique_ptr<manager::IncumbentExchange> exchange;
+
+	Maybe<std::string> model_cache_dir;
+	bool model_cacheable;
+
 	decltype(std::chrono::high_resolution_clock::now()) prepare_started;
 	decltype(std::chrono::high_resolution_clock::now()) prepare_finished;
 
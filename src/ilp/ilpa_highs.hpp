@@ -0,0 +1,907 @@
+#ifndef TCPSPSUITE_ILPA_HIGHS_HPP
+#define TCPSPSUITE_ILPA_HIGHS_HPP
+
+#include "../contrib/ilpabstraction/src/common.hpp" // for ParamType, ...
+
+#include <Highs.h>
+
+#include <algorithm>   // for any_of, sort
+#include <limits>      // for numeric_limits
+#include <memory>      // for unique_ptr
+#include <stdexcept>   // for invalid_argument
+#include <string>      // for string
+#include <type_traits> // for is_same
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+namespace ilpabstraction {
+
+/* An ilpabstraction-style interface to the open-source HiGHS MIP solver.
+ *
+ * ilpabstraction itself only ships interfaces for the commercial solvers, so
+ * this lives in-tree. It mirrors the subset of the Model / Variable /
+ * Expression / Callback surface that ILPBase and its formulations use.
+ *
+ * Variables and constraints are buffered on our side and handed to HiGHS in
+ * bulk (addCols / addRows) right before solving or writing. Adding them one
+ * at a time would make HiGHS re-shape its constraint matrix on every call.
+ */
+class HighsInterface {
+public:
+	class Variable;
+	class Constraint;
+	class Expression;
+	class Callback;
+	class Model;
+
+	static constexpr const char * NAME = "HiGHS";
+	static constexpr double INFTY = std::numeric_limits<double>::infinity();
+	static constexpr double NEGATIVE_INFTY =
+	    -std::numeric_limits<double>::infinity();
+
+	struct FeatureSet
+	{
+		template <Features F>
+		constexpr bool
+		has_feature() const
+		{
+			// Neither kappa statistics nor IIS computation are exposed by HiGHS
+			return false;
+		}
+	};
+
+	static constexpr FeatureSet
+	features()
+	{
+		return FeatureSet{};
+	}
+
+	class Variable {
+	public:
+		Variable() : col(-1) {}
+
+	private:
+		explicit Variable(HighsInt col_in) : col(col_in) {}
+		HighsInt col;
+
+		friend class Model;
+		friend class Expression;
+		friend class Callback;
+	};
+
+	class Constraint {
+	public:
+		Constraint() : row(-1) {}
+
+	private:
+		explicit Constraint(HighsInt row_in) : row(row_in) {}
+		HighsInt row;
+
+		friend class Model;
+	};
+
+	class Expression {
+	public:
+		Expression() : constant(0) {}
+		Expression(double constant_in) : constant(constant_in) {}
+		Expression(const Variable & var) : constant(0)
+		{
+			this->cols.push_back(var.col);
+			this->coefs.push_back(1.0);
+		}
+
+		Expression &
+		operator+=(const Expression & other)
+		{
+			this->cols.insert(this->cols.end(), other.cols.begin(), other.cols.end());
+			this->coefs.insert(this->coefs.end(), other.coefs.begin(),
+			                   other.coefs.end());
+			this->constant += other.constant;
+			return *this;
+		}
+
+		Expression &
+		operator-=(const Expression & other)
+		{
+			this->cols.insert(this->cols.end(), other.cols.begin(), other.cols.end());
+			for (double coef : other.coefs) {
+				this->coefs.push_back(-coef);
+			}
+			this->constant -= other.constant;
+			return *this;
+		}
+
+		Expression &
+		operator*=(double factor)
+		{
+			for (double & coef : this->coefs) {
+				coef *= factor;
+			}
+			this->constant *= factor;
+			return *this;
+		}
+
+		Expression &
+		operator/=(double divisor)
+		{
+			return (*this) *= (1.0 / divisor);
+		}
+
+		bool
+		is_constant() const
+		{
+			return this->cols.empty();
+		}
+
+	private:
+		// Sorts the terms by column and merges duplicate columns
+		void
+		normalize()
+		{
+			std::vector<std::pair<HighsInt, double>> terms;
+			terms.reserve(this->cols.size());
+			for (size_t i = 0; i < this->cols.size(); ++i) {
+				terms.emplace_back(this->cols[i], this->coefs[i]);
+			}
+			std::sort(terms.begin(), terms.end(),
+			          [](const auto & lhs, const auto & rhs) {
+				          return lhs.first < rhs.first;
+			          });
+
+			this->cols.clear();
+			this->coefs.clear();
+			for (const auto & [col, coef] : terms) {
+				if (!this->cols.empty() && this->cols.back() == col) {
+					this->coefs.back() += coef;
+				} else {
+					this->cols.push_back(col);
+					this->coefs.push_back(coef);
+				}
+			}
+		}
+
+		std::vector<HighsInt> cols;
+		std::vector<double> coefs;
+		double constant;
+
+		friend class Model;
+	};
+
+	class Callback {
+	public:
+		class Context {
+		private:
+			Context(int callback_type_in, const HighsCallbackDataOut * data_out_in,
+			        HighsCallbackDataIn * data_in_in)
+			    : callback_type(callback_type_in), data_out(data_out_in),
+			      data_in(data_in_in)
+			{}
+
+			int callback_type;
+			const HighsCallbackDataOut * data_out;
+			HighsCallbackDataIn * data_in;
+
+			friend class Callback;
+			friend class Model;
+		};
+
+		/* Incumbents can be read from and injected into a running solve, see
+		 * has_incumbent() / can_set_solution(). */
+		static constexpr bool SUPPORTS_INCUMBENT_EXCHANGE = true;
+
+		virtual ~Callback() = default;
+
+		virtual void
+		on_poll(Context & ctx)
+		{
+			(void)ctx;
+		}
+
+		virtual void
+		on_message(Context & ctx, std::string & message)
+		{
+			(void)ctx;
+			(void)message;
+		}
+
+	protected:
+		double
+		get_objective_value(Context & ctx) const
+		{
+			return ctx.data_out->mip_primal_bound;
+		}
+
+		double
+		get_bound(Context & ctx) const
+		{
+			return ctx.data_out->mip_dual_bound;
+		}
+
+		int
+		get_processed_nodes(Context & ctx) const
+		{
+			return static_cast<int>(ctx.data_out->mip_node_count);
+		}
+
+		int
+		get_open_nodes(Context & ctx) const
+		{
+			// HiGHS does not report the size of its node queue to callbacks.
+			(void)ctx;
+			return 0;
+		}
+
+		double
+		get_gap(Context & ctx) const
+		{
+			return ctx.data_out->mip_gap;
+		}
+
+		/* Whether the context carries a new incumbent, which can then be read
+		 * via get_incumbent_value(). */
+		bool
+		has_incumbent(Context & ctx) const
+		{
+			return (ctx.callback_type == kCallbackMipImprovingSolution) &&
+			       (ctx.data_out->mip_solution != nullptr);
+		}
+
+		double
+		get_incumbent_value(Context & ctx, const Variable & var) const
+		{
+			return ctx.data_out->mip_solution[var.col];
+		}
+
+		/* Whether HiGHS accepts a (possibly partial) solution in this context.
+		 * Unset variables are completed by HiGHS. Requires HiGHS >= 1.10. */
+		bool
+		can_set_solution(Context & ctx) const
+		{
+			return ctx.callback_type == kCallbackMipUserSolution;
+		}
+
+		void
+		set_solution(Context & ctx, const std::vector<Variable> & vars,
+		             const std::vector<double> & values) const
+		{
+			std::vector<HighsInt> cols;
+			cols.reserve(vars.size());
+			for (const auto & var : vars) {
+				cols.push_back(var.col);
+			}
+			ctx.data_in->setSolution(static_cast<HighsInt>(cols.size()), cols.data(),
+			                         values.data());
+		}
+
+		void
+		request_interrupt(Context & ctx) const
+		{
+			if (ctx.callback_type == kCallbackMipInterrupt) {
+				ctx.data_in->user_interrupt = 1;
+			}
+		}
+	};
+
+	class Model {
+	public:
+		Model()
+		    : highs(std::make_unique<Highs>()), flushed_cols(0), flushed_rows(0),
+		      objective_offset(0), has_integers(false), solved(false)
+		{
+			this->pending_row_starts.push_back(0);
+		}
+
+		Variable
+		add_var(VariableType type, double lower, double upper,
+		        std::string name = "")
+		{
+			HighsInt col = static_cast<HighsInt>(this->col_lower.size());
+
+			if (type == VariableType::BINARY) {
+				lower = std::max(lower, 0.0);
+				upper = std::min(upper, 1.0);
+			}
+
+			this->col_lower.push_back(lower);
+			this->col_upper.push_back(upper);
+			this->col_cost.push_back(0.0);
+			if (type == VariableType::CONTINUOUS) {
+				this->col_integrality.push_back(HighsVarType::kContinuous);
+			} else {
+				this->col_integrality.push_back(HighsVarType::kInteger);
+				this->has_integers = true;
+			}
+			this->col_names.push_back(std::move(name));
+
+			return Variable(col);
+		}
+
+		/* Adds the constraint lower <= expr <= upper. Any of the three parts may
+		 * contain variables. If lower and upper are both constant, a single row
+		 * is created, otherwise one row per finite side. The returned handle
+		 * refers to the first row created. */
+		Constraint
+		add_constraint(Expression lower, Expression expr, Expression upper,
+		               std::string name = "")
+		{
+			if (lower.is_constant() && upper.is_constant()) {
+				return this->add_row(lower.constant - expr.constant, expr,
+				                     upper.constant - expr.constant, std::move(name));
+			}
+
+			Constraint first;
+			bool have_first = false;
+			if (!lower.is_constant() || (lower.constant > NEGATIVE_INFTY)) {
+				Expression diff = expr;
+				diff -= lower;
+				first = this->add_row(-diff.constant, diff, INFTY, name);
+				have_first = true;
+			}
+			if (!upper.is_constant() || (upper.constant < INFTY)) {
+				Expression diff = upper;
+				diff -= expr;
+				Constraint upper_row = this->add_row(
+				    -diff.constant, diff, INFTY,
+				    name.empty() ? name : (name + std::string("_ub")));
+				if (!have_first) {
+					first = upper_row;
+				}
+			}
+
+			return first;
+		}
+
+		/* Bulk insertion of rows, bypassing Expression. Row i is
+		 *   lower[i] <= sum_k coefs[k] * vars[k] <= upper[i]
+		 * for k in [starts[i], starts[i + 1]). Variables must not repeat within a
+		 * row. names may be empty. */
+		static constexpr bool SUPPORTS_BULK_CONSTRAINTS = true;
+
+		void
+		add_constraints(const std::vector<double> & lower,
+		                const std::vector<double> & upper,
+		                const std::vector<size_t> & starts,
+		                const std::vector<Variable> & vars,
+		                const std::vector<double> & coefs,
+		                const std::vector<std::string> & names)
+		{
+			this->row_lower.insert(this->row_lower.end(), lower.begin(), lower.end());
+			this->row_upper.insert(this->row_upper.end(), upper.begin(), upper.end());
+
+			HighsInt offset = static_cast<HighsInt>(this->pending_row_index.size());
+			for (size_t row = 0; row < lower.size(); ++row) {
+				for (size_t k = starts[row]; k < starts[row + 1]; ++k) {
+					this->pending_row_index.push_back(vars[k].col);
+					this->pending_row_value.push_back(coefs[k]);
+				}
+				this->pending_row_starts.push_back(
+				    offset + static_cast<HighsInt>(starts[row + 1]));
+				this->pending_row_names.push_back(names.empty() ? std::string()
+				                                                : names[row]);
+			}
+		}
+
+		/* HiGHS has no SOS constraints, so this is linearized: Every non-binary
+		 * member gets a binary indicator that must be set for the member to be
+		 * non-zero, and at most one member (or indicator) may be set. This needs
+		 * finite bounds on all non-binary members. The weights only guide
+		 * branching in the other solvers and are ignored. */
+		void
+		add_sos1_constraint(const std::vector<Variable> & vars,
+		                    const std::vector<double> & weights,
+		                    std::string name = "")
+		{
+			(void)weights;
+
+			Expression indicator_sum;
+			for (const Variable & var : vars) {
+				size_t col = static_cast<size_t>(var.col);
+				double lower = this->col_lower[col];
+				double upper = this->col_upper[col];
+
+				if ((this->col_integrality[col] == HighsVarType::kInteger) &&
+				    (lower >= 0) && (upper <= 1)) {
+					indicator_sum += var;
+					continue;
+				}
+
+				if ((lower <= NEGATIVE_INFTY) || (upper >= INFTY)) {
+					throw std::invalid_argument(
+					    "SOS1 members must have finite bounds with HiGHS");
+				}
+
+				Variable indicator = this->add_var(VariableType::BINARY, 0, 1);
+				Expression scaled_indicator(indicator);
+
+				// var <= upper * indicator and var >= lower * indicator
+				Expression upper_diff(var);
+				upper_diff -= (Expression(scaled_indicator) *= upper);
+				this->add_constraint(NEGATIVE_INFTY, upper_diff, 0);
+				Expression lower_diff(var);
+				lower_diff -= (scaled_indicator *= lower);
+				this->add_constraint(0, lower_diff, INFTY);
+
+				indicator_sum += indicator;
+			}
+
+			this->add_constraint(NEGATIVE_INFTY, indicator_sum, 1, std::move(name));
+		}
+
+		void
+		set_objective(Expression expr, ObjectiveType type)
+		{
+			expr.normalize();
+
+			std::fill(this->col_cost.begin(), this->col_cost.end(), 0.0);
+			for (size_t i = 0; i < expr.cols.size(); ++i) {
+				this->col_cost[static_cast<size_t>(expr.cols[i])] = expr.coefs[i];
+			}
+			this->objective_offset = expr.constant;
+
+			if (this->flushed_cols > 0) {
+				this->highs->changeColsCost(0, this->flushed_cols - 1,
+				                            this->col_cost.data());
+				this->highs->changeObjectiveOffset(this->objective_offset);
+			}
+
+			if (type == ObjectiveType::MINIMIZE) {
+				this->highs->changeObjectiveSense(ObjSense::kMinimize);
+			} else {
+				this->highs->changeObjectiveSense(ObjSense::kMaximize);
+			}
+		}
+
+		template <class T>
+		void
+		set_param(ParamType type, T value)
+		{
+			if constexpr (std::is_same<T, ParamMIPFocus>::value) {
+				if (type != ParamType::MIP_FOCUS) {
+					return;
+				}
+
+				// HiGHS has no single "focus" switch. The closest knob is how much
+				// effort goes into primal heuristics.
+				switch (value) {
+				case ParamMIPFocus::QUALITY:
+					this->highs->setOptionValue("mip_heuristic_effort", 0.3);
+					break;
+				case ParamMIPFocus::BOUND:
+				case ParamMIPFocus::OPTIMALITY:
+					this->highs->setOptionValue("mip_heuristic_effort", 0.01);
+					break;
+				case ParamMIPFocus::BALANCED:
+				default:
+					this->highs->setOptionValue("mip_heuristic_effort", 0.05);
+				}
+			} else {
+				switch (type) {
+				case ParamType::LOG_TO_CONSOLE:
+					this->highs->setOptionValue("log_to_console",
+					                            static_cast<bool>(value));
+					break;
+				case ParamType::THREADS:
+					// Note that HiGHS sizes its (process-wide) scheduler on first use.
+					this->highs->setOptionValue("threads", static_cast<HighsInt>(value));
+					break;
+				case ParamType::TIME_LIMIT:
+					this->highs->setOptionValue("time_limit", static_cast<double>(value));
+					break;
+				case ParamType::SEED:
+					this->highs->setOptionValue("random_seed",
+					                            static_cast<HighsInt>(value));
+					break;
+				default:
+					// Not supported by HiGHS, silently ignored like the other
+					// interfaces do for unsupported parameters.
+					break;
+				}
+			}
+		}
+
+		void
+		add_callback(Callback * cb_in)
+		{
+			this->cb = cb_in;
+			this->highs->setCallback(&Model::dispatch_callback,
+			                         static_cast<void *>(this));
+			this->highs->startCallback(kCallbackMipInterrupt);
+			this->highs->startCallback(kCallbackMipImprovingSolution);
+			this->highs->startCallback(kCallbackMipUserSolution);
+			this->highs->startCallback(kCallbackLogging);
+		}
+
+		void
+		commit_variables()
+		{
+			this->flush();
+		}
+
+		unsigned int
+		get_variable_count() const
+		{
+			return static_cast<unsigned int>(this->col_lower.size());
+		}
+
+		unsigned int
+		get_constraint_count() const
+		{
+			return static_cast<unsigned int>(this->row_lower.size());
+		}
+
+		unsigned int
+		get_nonzero_count()
+		{
+			this->flush();
+			return static_cast<unsigned int>(
+			    this->highs->getLp().a_matrix_.numNz());
+		}
+
+		void
+		write(const std::string & path)
+		{
+			this->flush();
+			this->highs->writeModel(path);
+		}
+
+		/* Replaces the model by the one stored at path, in any format HiGHS can
+		 * read. Columns and rows keep the order in which they were written, see
+		 * variable_at(). Returns false if the file could not be read. */
+		static constexpr bool SUPPORTS_MODEL_IO = true;
+
+		bool
+		read(const std::string & path)
+		{
+			if (this->highs->readModel(path) == HighsStatus::kError) {
+				return false;
+			}
+
+			const HighsLp & lp = this->highs->getLp();
+			size_t num_cols = static_cast<size_t>(lp.num_col_);
+
+			this->col_lower = lp.col_lower_;
+			this->col_upper = lp.col_upper_;
+			this->col_cost = lp.col_cost_;
+			this->col_integrality = lp.integrality_;
+			this->col_integrality.resize(num_cols, HighsVarType::kContinuous);
+			this->col_names = lp.col_names_;
+			this->col_names.resize(num_cols);
+			this->has_integers =
+			    std::any_of(this->col_integrality.begin(),
+			                this->col_integrality.end(), [](HighsVarType type) {
+				                return type != HighsVarType::kContinuous;
+			                });
+			this->flushed_cols = lp.num_col_;
+
+			this->row_lower = lp.row_lower_;
+			this->row_upper = lp.row_upper_;
+			this->pending_row_starts.clear();
+			this->pending_row_starts.push_back(0);
+			this->pending_row_index.clear();
+			this->pending_row_value.clear();
+			this->pending_row_names.clear();
+			this->flushed_rows = lp.num_row_;
+
+			this->objective_offset = lp.offset_;
+			this->start_cols.clear();
+			this->start_values.clear();
+			this->solved = false;
+
+			return true;
+		}
+
+		// Variables are numbered in the order in which they were added
+		Variable
+		variable_at(unsigned int index) const
+		{
+			return Variable(static_cast<HighsInt>(index));
+		}
+
+		unsigned int
+		index_of(const Variable & var) const
+		{
+			return static_cast<unsigned int>(var.col);
+		}
+
+		void
+		write_solution(const std::string & path)
+		{
+			this->highs->writeSolution(path, kSolutionStylePretty);
+		}
+
+		void
+		set_start(const Variable & var, double value)
+		{
+			this->start_cols.push_back(var.col);
+			this->start_values.push_back(value);
+		}
+
+		void
+		change_var_bounds(const Variable & var, double lower, double upper)
+		{
+			size_t col = static_cast<size_t>(var.col);
+			this->col_lower[col] = lower;
+			this->col_upper[col] = upper;
+			if (var.col < this->flushed_cols) {
+				this->highs->changeColBounds(var.col, lower, upper);
+			}
+		}
+
+		void
+		change_constraint_ub(const Constraint & constr, double upper)
+		{
+			size_t row = static_cast<size_t>(constr.row);
+			this->row_upper[row] = upper;
+			if (constr.row < this->flushed_rows) {
+				this->highs->changeRowBounds(constr.row, this->row_lower[row], upper);
+			}
+		}
+
+		void
+		change_objective_coefficient(const Variable & var, double coef)
+		{
+			this->col_cost[static_cast<size_t>(var.col)] = coef;
+			if (var.col < this->flushed_cols) {
+				this->highs->changeColCost(var.col, coef);
+			}
+		}
+
+		void
+		solve()
+		{
+			this->flush();
+
+			if (!this->start_cols.empty()) {
+				this->highs->setSolution(
+				    static_cast<HighsInt>(this->start_cols.size()),
+				    this->start_cols.data(), this->start_values.data());
+				this->start_cols.clear();
+				this->start_values.clear();
+			}
+
+			this->highs->run();
+			this->solved = true;
+		}
+
+		ModelStatus
+		get_status() const
+		{
+			if (!this->solved) {
+				return ModelStatus::READY;
+			}
+
+			switch (this->highs->getModelStatus()) {
+			case HighsModelStatus::kOptimal:
+				return ModelStatus::OPTIMAL;
+			case HighsModelStatus::kInfeasible:
+			case HighsModelStatus::kUnboundedOrInfeasible:
+				return ModelStatus::INFEASIBLE;
+			case HighsModelStatus::kUnbounded:
+				return ModelStatus::UNBOUNDED;
+			case HighsModelStatus::kTimeLimit:
+			case HighsModelStatus::kIterationLimit:
+			case HighsModelStatus::kSolutionLimit:
+			case HighsModelStatus::kObjectiveBound:
+			case HighsModelStatus::kObjectiveTarget:
+			case HighsModelStatus::kInterrupt:
+				return ModelStatus::STOPPED;
+			default:
+				return ModelStatus::READY;
+			}
+		}
+
+		bool
+		has_feasible() const
+		{
+			return this->solved && (this->highs->getInfo().primal_solution_status ==
+			                        kSolutionStatusFeasible);
+		}
+
+		double
+		get_variable_assignment(const Variable & var) const
+		{
+			return this->highs->getSolution()
+			    .col_value[static_cast<size_t>(var.col)];
+		}
+
+		double
+		get_objective_value() const
+		{
+			return this->highs->getInfo().objective_function_value;
+		}
+
+		double
+		get_bound() const
+		{
+			if (!this->has_integers) {
+				return this->get_objective_value();
+			}
+			return this->highs->getInfo().mip_dual_bound;
+		}
+
+	private:
+		Constraint
+		add_row(double lower, Expression & expr, double upper, std::string name)
+		{
+			expr.normalize();
+
+			HighsInt row = static_cast<HighsInt>(this->row_lower.size());
+			this->row_lower.push_back(lower);
+			this->row_upper.push_back(upper);
+
+			this->pending_row_index.insert(this->pending_row_index.end(),
+			                               expr.cols.begin(), expr.cols.end());
+			this->pending_row_value.insert(this->pending_row_value.end(),
+			                               expr.coefs.begin(), expr.coefs.end());
+			this->pending_row_starts.push_back(
+			    static_cast<HighsInt>(this->pending_row_index.size()));
+			this->pending_row_names.push_back(std::move(name));
+
+			return Constraint(row);
+		}
+
+		// Hands all buffered columns and rows to HiGHS
+		void
+		flush()
+		{
+			HighsInt num_cols = static_cast<HighsInt>(this->col_lower.size());
+			if (num_cols > this->flushed_cols) {
+				HighsInt first = this->flushed_cols;
+				this->highs->addCols(num_cols - first, &this->col_cost[first],
+				                     &this->col_lower[first], &this->col_upper[first],
+				                     0, nullptr, nullptr, nullptr);
+				this->highs->changeColsIntegrality(first, num_cols - 1,
+				                                   &this->col_integrality[first]);
+				for (HighsInt col = first; col < num_cols; ++col) {
+					if (!this->col_names[static_cast<size_t>(col)].empty()) {
+						this->highs->passColName(col,
+						                         this->col_names[static_cast<size_t>(col)]);
+					}
+				}
+				if (first == 0) {
+					this->highs->changeObjectiveOffset(this->objective_offset);
+				}
+				this->flushed_cols = num_cols;
+			}
+
+			HighsInt num_rows = static_cast<HighsInt>(this->row_lower.size());
+			if (num_rows > this->flushed_rows) {
+				HighsInt first = this->flushed_rows;
+				this->highs->addRows(
+				    num_rows - first, &this->row_lower[first], &this->row_upper[first],
+				    static_cast<HighsInt>(this->pending_row_index.size()),
+				    this->pending_row_starts.data(), this->pending_row_index.data(),
+				    this->pending_row_value.data());
+				for (HighsInt row = first; row < num_rows; ++row) {
+					const std::string & row_name =
+					    this->pending_row_names[static_cast<size_t>(row - first)];
+					if (!row_name.empty()) {
+						this->highs->passRowName(row, row_name);
+					}
+				}
+
+				this->pending_row_starts.clear();
+				this->pending_row_starts.push_back(0);
+				this->pending_row_index.clear();
+				this->pending_row_value.clear();
+				this->pending_row_names.clear();
+				this->flushed_rows = num_rows;
+			}
+		}
+
+		static void
+		dispatch_callback(const int callback_type, const std::string & message,
+		                  const HighsCallbackDataOut * data_out,
+		                  HighsCallbackDataIn * data_in, void * user_data)
+		{
+			Model * model = static_cast<Model *>(user_data);
+			if (model->cb == nullptr) {
+				return;
+			}
+
+			Callback::Context ctx(callback_type, data_out, data_in);
+			if ((callback_type == kCallbackMipInterrupt) ||
+			    (callback_type == kCallbackMipImprovingSolution) ||
+			    (callback_type == kCallbackMipUserSolution)) {
+				model->cb->on_poll(ctx);
+			} else if (callback_type == kCallbackLogging) {
+				std::string msg = message;
+				model->cb->on_message(ctx, msg);
+			}
+		}
+
+		std::unique_ptr<Highs> highs;
+		Callback * cb = nullptr;
+
+		// Column data is mirrored for all columns, HiGHS sees [0, flushed_cols)
+		std::vector<double> col_lower;
+		std::vector<double> col_upper;
+		std::vector<double> col_cost;
+		std::vector<HighsVarType> col_integrality;
+		std::vector<std::string> col_names;
+		HighsInt flushed_cols;
+
+		// Row bounds are mirrored for all rows, the matrix (CSR) only for the
+		// rows HiGHS has not seen yet.
+		std::vector<double> row_lower;
+		std::vector<double> row_upper;
+		std::vector<HighsInt> pending_row_starts;
+		std::vector<HighsInt> pending_row_index;
+		std::vector<double> pending_row_value;
+		std::vector<std::string> pending_row_names;
+		HighsInt flushed_rows;
+
+		std::vector<HighsInt> start_cols;
+		std::vector<double> start_values;
+
+		double objective_offset;
+		bool has_integers;
+		bool solved;
+	};
+
+	explicit HighsInterface(bool auto_commit_variables)
+	{
+		// Variables are buffered until the model is solved anyways
+		(void)auto_commit_variables;
+	}
+
+	Model
+	create_model()
+	{
+		return Model();
+	}
+
+	Expression
+	create_expression()
+	{
+		return Expression();
+	}
+};
+
+inline HighsInterface::Expression
+operator+(HighsInterface::Expression lhs,
+          const HighsInterface::Expression & rhs)
+{
+	lhs += rhs;
+	return lhs;
+}
+
+inline HighsInterface::Expression
+operator-(HighsInterface::Expression lhs,
+          const HighsInterface::Expression & rhs)
+{
+	lhs -= rhs;
+	return lhs;
+}
+
+inline HighsInterface::Expression
+operator-(HighsInterface::Expression expr)
+{
+	expr *= -1.0;
+	return expr;
+}
+
+inline HighsInterface::Expression
+operator*(HighsInterface::Expression expr, double factor)
+{
+	expr *= factor;
+	return expr;
+}
+
+inline HighsInterface::Expression
+operator*(double factor, HighsInterface::Expression expr)
+{
+	expr *= factor;
+	return expr;
+}
+
+inline HighsInterface::Expression
+operator/(HighsInterface::Expression expr, double divisor)
+{
+	expr /= divisor;
+	return expr;
+}
+
+} // namespace ilpabstraction
+
+#endif // TCPSPSUITE_ILPA_HIGHS_HPP
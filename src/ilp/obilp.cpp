@@ -4,10 +4,10 @@
 #include "../contrib/ilpabstraction/src/common.hpp" // for VariableType, Varia...
 #include "../instance/instance.hpp"                 // IWYU pragma: keep
 #include "../instance/job.hpp"                      // for Job
-#include "gurobi_c++.h"
 #include "ilp.hpp" // for ILPBase
 
 #include <unordered_set>
+#include <chrono> // for high_resolution_clock
 
 class AdditionalResultStorage;
 class SolverConfig;
@@ -367,16 +367,22 @@ void
 OBILP<SolverT>::prepare()
 {
 	this->prepare_pre();
+	auto phase_start = std::chrono::high_resolution_clock::now();
 	this->generate_events();
+	phase_start = this->record_build_phase("EVENTS", phase_start);
 
 	BOOST_LOG(l.d()) << "Preparing variables...";
 	this->prepare_variables();
+	phase_start = this->record_build_phase("VARIABLES", phase_start);
 	BOOST_LOG(l.d()) << "Preparing after-constraints...";
 	this->prepare_after_constraints();
+	phase_start = this->record_build_phase("AFTER_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing before-constraints...";
 	this->prepare_before_constraints();
+	phase_start = this->record_build_phase("BEFORE_CONSTRAINTS", phase_start);
 	BOOST_LOG(l.d()) << "Preparing usage expressions...";
 	this->prepare_start_usage_exprs();
+	this->record_build_phase("USAGE_CONSTRAINTS", phase_start);
 
 	this->prepare_post();
 }
@@ -385,7 +391,10 @@ template <class SolverT>
 void
 OBILP<SolverT>::run()
 {
-	this->prepare();
+	if (!this->load_cached_model(get_id())) {
+		this->prepare();
+		this->store_cached_model(get_id());
+	}
 	this->base_run();
 
 	// TODO DEBUG REMOVE
@@ -458,3 +467,7 @@ template class OBILP<ilpabstraction::GurobiInterface>;
 #if defined(CPLEX_FOUND)
 template class OBILP<ilpabstraction::CPLEXInterface>;
 #endif
+
+#if defined(HIGHS_FOUND)
+template class OBILP<ilpabstraction::HighsInterface>;
+#endif
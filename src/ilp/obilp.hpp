@@ -24,6 +24,10 @@ struct registry_hook;
 #include "../contrib/ilpabstraction/src/ilpa_cplex.hpp"
 #endif
 
+#if defined(HIGHS_FOUND)
+#include "ilpa_highs.hpp"
+#endif
+
 template <class SolverT>
 class OBILP : public ILPBase<SolverT> {
 public:
@@ -140,6 +144,23 @@ struct registry_hook<
 	}
 };
 #endif
+
+#if defined(HIGHS_FOUND)
+template <>
+struct registry_hook<
+    solvers::get_free_N<OBILP<ilpabstraction::HighsInterface>>()>
+{
+	constexpr static unsigned int my_N =
+	    solvers::get_free_N<OBILP<ilpabstraction::HighsInterface>>();
+
+	auto
+	operator()()
+	{
+		return solvers::register_class<OBILP<ilpabstraction::HighsInterface>,
+		                               my_N>{}();
+	}
+};
+#endif
 } // namespace solvers
 
 #endif /* ILP_OBILP_HPP */
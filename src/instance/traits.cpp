@@ -319,7 +319,7 @@ TraitsBuilder::check_dummy_start_end()
 	// sink!
 	using vertex = LagGraph::vertex;
 
-	vertex source;
+	vertex source = LagGraph::no_vertex;
 	bool source_found = false;
 	bool sink_found = false;
 
@@ -349,26 +349,22 @@ TraitsBuilder::check_dummy_start_end()
 	std::vector<bool> visited(this->instance.job_count(), false);
 	unsigned int visit_count = 0;
 
-	std::function<bool(LagGraph::vertex, LagGraph::vertex)> visit =
-	    [&](LagGraph::vertex v, LagGraph::vertex from) {
-		    (void)from;
-
-		    if (!visited[v]) {
-			    visit_count++;
-		    }
-		    visited[v] = true;
-
-		    return true;
-	    };
-	std::function<void(LagGraph::vertex, LagGraph::vertex, int)> traverse =
-	    [&](LagGraph::vertex from, LagGraph::vertex to, int lag) {
-		    (void)from;
-		    (void)to;
-		    (void)lag;
-	    };
-	std::function<void(LagGraph::vertex)> backtrack = [&](unsigned int v) {
-		(void)v;
+	auto visit = [&](LagGraph::vertex v, LagGraph::vertex from) {
+		(void)from;
+
+		if (!visited[v]) {
+			visit_count++;
+		}
+		visited[v] = true;
+
+		return true;
+	};
+	auto traverse = [&](LagGraph::vertex from, LagGraph::vertex to, int lag) {
+		(void)from;
+		(void)to;
+		(void)lag;
 	};
+	auto backtrack = [&](unsigned int v) { (void)v; };
 
 	if (!source_found) {
 		return;
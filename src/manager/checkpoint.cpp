@@ -0,0 +1,210 @@
+#include "checkpoint.hpp"
+
+#include <cstdio>   // for rename, remove
+#include <fstream>  // for ifstream, ofstream
+#include <iomanip>  // for setw, setfill
+#include <iterator> // for istreambuf_iterator
+#include <sstream>  // for ostringstream, istringstream
+#include <thread>   // for this_thread
+#include <utility>  // for move
+
+namespace manager {
+
+void
+CheckpointWriter::write(const std::string & value)
+{
+	this->write((uint64_t)value.size());
+	this->data.append(value);
+}
+
+void
+CheckpointWriter::write(const std::mt19937 & rng)
+{
+	// The standard only guarantees the textual representation
+	std::ostringstream state;
+	state << rng;
+	this->write(state.str());
+}
+
+CheckpointReader::CheckpointReader(std::string data_in)
+    : data(std::move(data_in)), pos(0), failed(false)
+{}
+
+bool
+CheckpointReader::consume(size_t bytes) noexcept
+{
+	if (this->failed || (bytes > this->remaining())) {
+		this->failed = true;
+		return false;
+	}
+	this->pos += bytes;
+	return true;
+}
+
+void
+CheckpointReader::read(std::string & value)
+{
+	uint64_t size = 0;
+	this->read(size);
+	if (!this->good() || !this->consume(size)) {
+		this->failed = true;
+		return;
+	}
+	value.assign(this->data, this->pos - size, size);
+}
+
+void
+CheckpointReader::read(std::mt19937 & rng)
+{
+	std::string serialized;
+	this->read(serialized);
+	if (!this->good()) {
+		return;
+	}
+
+	std::istringstream state(serialized);
+	std::mt19937 restored;
+	state >> restored;
+	if (state.fail()) {
+		this->failed = true;
+		return;
+	}
+	rng = restored;
+}
+
+Checkpoint::Checkpoint(const std::string & directory, std::string key_in,
+                       double interval_in)
+    : key(std::move(key_in)), interval(interval_in), resumable(false),
+      previous_elapsed(0), last_written(0), l("CHECKPOINT")
+{
+	std::ostringstream path_buf;
+	path_buf << directory << "/" << std::hex << std::setw(16) << std::setfill('0')
+	         << hash(this->key.data(), this->key.size()) << ".ckpt";
+	this->path = path_buf.str();
+
+	this->load();
+}
+
+uint64_t
+Checkpoint::hash(const char * data, size_t size) noexcept
+{
+	// FNV-1a, std::hash is not guaranteed to be stable across builds
+	uint64_t value = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i) {
+		value ^= static_cast<unsigned char>(data[i]);
+		value *= 1099511628211ull;
+	}
+	return value;
+}
+
+void
+Checkpoint::load()
+{
+	std::ifstream in_stream(this->path, std::ios::binary);
+	if (!in_stream.good()) {
+		BOOST_LOG(l.d(1)) << "No checkpoint at " << this->path;
+		return;
+	}
+
+	std::string contents{std::istreambuf_iterator<char>(in_stream),
+	                     std::istreambuf_iterator<char>()};
+	CheckpointReader file(std::move(contents));
+
+	uint64_t magic = 0;
+	uint32_t version = 0;
+	std::string stored_key;
+	double elapsed = 0;
+	std::string stored_payload;
+	uint64_t checksum = 0;
+
+	file.read(magic);
+	file.read(version);
+	if (!file.good() || (magic != MAGIC) || (version != VERSION)) {
+		BOOST_LOG(l.w()) << "Ignoring checkpoint of unknown format at "
+		                 << this->path;
+		return;
+	}
+
+	file.read(stored_key);
+	file.read(elapsed);
+	file.read(stored_payload);
+	file.read(checksum);
+	if (!file.good() || !file.at_end() ||
+	    (checksum != hash(stored_payload.data(), stored_payload.size()))) {
+		BOOST_LOG(l.w()) << "Ignoring corrupt checkpoint at " << this->path;
+		return;
+	}
+
+	// Guards against hash collisions
+	if (stored_key != this->key) {
+		BOOST_LOG(l.w()) << "Checkpoint key collision at " << this->path;
+		return;
+	}
+
+	this->resumable = true;
+	this->previous_elapsed = elapsed;
+	this->last_written = elapsed;
+	this->payload = std::move(stored_payload);
+
+	BOOST_LOG(l.i()) << "Found checkpoint at " << this->path << " after "
+	                 << elapsed << " seconds";
+}
+
+CheckpointReader
+Checkpoint::resume() const
+{
+	return CheckpointReader(this->payload);
+}
+
+bool
+Checkpoint::write(const CheckpointWriter & state, double elapsed)
+{
+	this->last_written = elapsed;
+
+	CheckpointWriter file;
+	file.write(MAGIC);
+	file.write(VERSION);
+	file.write(this->key);
+	file.write(elapsed);
+	file.write(state.get_data());
+	file.write(hash(state.get_data().data(), state.get_data().size()));
+
+	// Write and rename, so that being interrupted never leaves us without a
+	// valid checkpoint
+	std::string tmp_path =
+	    this->path + ".tmp" +
+	    std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+	{
+		std::ofstream out_stream(tmp_path, std::ios::binary | std::ios::trunc);
+		out_stream.write(file.get_data().data(),
+		                 (std::streamsize)file.get_data().size());
+		out_stream.flush();
+		if (!out_stream.good()) {
+			BOOST_LOG(l.w()) << "Could not write checkpoint to " << tmp_path;
+			std::remove(tmp_path.c_str());
+			return false;
+		}
+	}
+
+	if (std::rename(tmp_path.c_str(), this->path.c_str()) != 0) {
+		BOOST_LOG(l.w()) << "Could not move checkpoint to " << this->path;
+		std::remove(tmp_path.c_str());
+		return false;
+	}
+
+	BOOST_LOG(l.d(2)) << "Wrote checkpoint of " << file.get_data().size()
+	                  << " bytes after " << elapsed << " seconds";
+	return true;
+}
+
+void
+Checkpoint::discard()
+{
+	this->resumable = false;
+	this->previous_elapsed = 0;
+	this->last_written = 0;
+	this->payload.clear();
+	std::remove(this->path.c_str());
+}
+
+} // namespace manager
@@ -0,0 +1,202 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include "../util/log.hpp" // for Log
+
+#include <cstdint>     // for uint64_t
+#include <cstring>     // for memcpy
+#include <random>      // for mt19937
+#include <string>      // for string
+#include <type_traits> // for is_trivially_copyable
+#include <vector>      // for vector
+
+namespace manager {
+
+/* Serializes solver state into a compact binary buffer. Plain values are
+ * copied byte by byte, vectors and strings are prefixed with their length.
+ * Checkpoints are only ever read back by the same binary on the same
+ * machine, so there is no need to care about endianness or padding. */
+class CheckpointWriter {
+public:
+	template <class T>
+	void
+	write(const T & value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "Only plain values can be written directly.");
+		this->data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template <class T>
+	void
+	write(const std::vector<T> & values)
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "Only vectors of plain values can be written directly.");
+		this->write((uint64_t)values.size());
+		this->data.append(reinterpret_cast<const char *>(values.data()),
+		                  values.size() * sizeof(T));
+	}
+
+	void write(const std::string & value);
+	void write(const std::mt19937 & rng);
+
+	const std::string &
+	get_data() const noexcept
+	{
+		return this->data;
+	}
+
+private:
+	std::string data;
+};
+
+/* Reads back what a CheckpointWriter wrote, in the same order. Reading past
+ * the end or a malformed length leaves the target untouched and makes good()
+ * return false, so callers can read everything and check once. */
+class CheckpointReader {
+public:
+	explicit CheckpointReader(std::string data);
+
+	template <class T>
+	void
+	read(T & value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "Only plain values can be read directly.");
+		if (!this->consume(sizeof(T))) {
+			return;
+		}
+		std::memcpy(&value, this->data.data() + this->pos - sizeof(T), sizeof(T));
+	}
+
+	template <class T>
+	void
+	read(std::vector<T> & values)
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "Only vectors of plain values can be read directly.");
+		uint64_t count = 0;
+		this->read(count);
+		if (!this->good() || (count > this->remaining() / sizeof(T)) ||
+		    !this->consume(count * sizeof(T))) {
+			this->failed = true;
+			return;
+		}
+		values.resize(count);
+		std::memcpy(values.data(), this->data.data() + this->pos - count * sizeof(T),
+		            count * sizeof(T));
+	}
+
+	void read(std::string & value);
+	void read(std::mt19937 & rng);
+
+	bool
+	good() const noexcept
+	{
+		return !this->failed;
+	}
+
+	/* For callers that find the values they read to be inconsistent. */
+	void
+	fail() noexcept
+	{
+		this->failed = true;
+	}
+
+	/* Whether everything has been read. Useful to detect layout mismatches. */
+	bool
+	at_end() const noexcept
+	{
+		return this->pos == this->data.size();
+	}
+
+private:
+	size_t
+	remaining() const noexcept
+	{
+		return this->data.size() - this->pos;
+	}
+
+	bool consume(size_t bytes) noexcept;
+
+	std::string data;
+	size_t pos;
+	bool failed;
+};
+
+/* The checkpoint of one solver run, i.e., one combination of run ID,
+ * instance, solver, configuration and seed.
+ *
+ * On construction, a checkpoint left over from an earlier, interrupted
+ * attempt of the same run is picked up. The solver can then resume from it
+ * (see can_resume() and resume()). While running, the solver periodically
+ * asks is_due() and hands its state to write(), together with the total time
+ * elapsed so far, counted across all attempts. Once the result is stored, the
+ * runner discards the checkpoint.
+ *
+ * Files are written to a temporary file and renamed, so that being killed
+ * while writing never destroys the previous checkpoint. The file stores the
+ * full run key and a checksum, so that hash collisions and corrupted files
+ * are detected and ignored.
+ */
+class Checkpoint {
+public:
+	Checkpoint(const std::string & directory, std::string key, double interval);
+
+	bool
+	can_resume() const noexcept
+	{
+		return this->resumable;
+	}
+
+	/* Time the earlier attempts had computed when the checkpoint was written. */
+	double
+	get_previous_elapsed() const noexcept
+	{
+		return this->previous_elapsed;
+	}
+
+	CheckpointReader resume() const;
+
+	bool
+	is_due(double elapsed) const noexcept
+	{
+		return (elapsed - this->last_written) >= this->interval;
+	}
+
+	/* Returns false (after logging) if the checkpoint could not be written. A
+	 * failed checkpoint should not end the run. */
+	bool write(const CheckpointWriter & state, double elapsed);
+
+	void discard();
+
+	const std::string &
+	get_path() const noexcept
+	{
+		return this->path;
+	}
+
+private:
+	static constexpr uint64_t MAGIC = 0x54504b4350435354ull; // "TSCPCKPT"
+	static constexpr uint32_t VERSION = 1;
+
+	static uint64_t hash(const char * data, size_t size) noexcept;
+	void load();
+
+	std::string path;
+	std::string key;
+	double interval;
+
+	bool resumable;
+	double previous_elapsed;
+	std::string payload;
+
+	double last_written;
+
+	Log l;
+};
+
+} // namespace manager
+
+#endif
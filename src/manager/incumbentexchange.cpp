@@ -0,0 +1,135 @@
+#include "incumbentexchange.hpp"
+
+#include "../db/storage.hpp"           // for AdditionalResultStorage
+#include "../instance/instance.hpp"    // for Instance
+#include "../instance/solution.hpp"    // for Solution
+#include "../manager/timer.hpp"        // for Timer
+#include "generated_config.hpp"        // for DOUBLE_DELTA
+
+#include <cmath> // for isfinite
+
+namespace manager {
+
+IncumbentExchange::IncumbentExchange(const Instance & instance_in,
+                                     AdditionalResultStorage & storage_in,
+                                     const Timer & timer_in)
+    : instance(instance_in), storage(storage_in), timer(timer_in),
+      incumbent_source(0), version(0), stopped(false), l("EXCHANGE")
+{}
+
+bool
+IncumbentExchange::offer(const std::vector<unsigned int> & start_times_in,
+                         unsigned int source, Maybe<unsigned int> iteration)
+{
+	// Evaluate outside of the lock, this is the expensive part.
+	std::vector<unsigned int> copy = start_times_in;
+	Solution sol(this->instance, false, copy, Maybe<double>());
+	double offered_costs = sol.get_costs();
+	if (!std::isfinite(offered_costs)) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(this->m);
+	if (this->costs.valid() &&
+	    (offered_costs >= this->costs.value() - DOUBLE_DELTA)) {
+		return false;
+	}
+
+	this->start_times = std::move(copy);
+	this->costs = offered_costs;
+	this->incumbent_source = source;
+	this->version.fetch_add(1, std::memory_order_release);
+
+	BOOST_LOG(l.d(2)) << "New incumbent with costs " << offered_costs << " from "
+	                  << ((source == AdditionalResultStorage::IntermediateResult::
+	                                     SOURCE_MIP)
+	                          ? "MIP"
+	                          : "heuristic");
+
+	this->storage.intermediate_results.push_back(
+	    {Maybe<double>(this->timer.get()), iteration, this->costs, this->bound,
+	     Maybe<Solution>(), Maybe<unsigned int>(source)});
+
+	this->check_optimality();
+
+	return true;
+}
+
+void
+IncumbentExchange::offer_bound(double offered_bound)
+{
+	if (!std::isfinite(offered_bound)) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(this->m);
+	if (this->bound.valid() && (offered_bound <= this->bound.value())) {
+		return;
+	}
+
+	this->bound = offered_bound;
+	this->check_optimality();
+}
+
+bool
+IncumbentExchange::fetch(unsigned int source, size_t & seen_version,
+                         std::vector<unsigned int> & start_times_out,
+                         double & costs_out) const
+{
+	// Cheap check first, this is called from hot loops
+	if (this->version.load(std::memory_order_acquire) == seen_version) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(this->m);
+	seen_version = this->version.load(std::memory_order_relaxed);
+	if (!this->costs.valid() || (this->incumbent_source == source)) {
+		return false;
+	}
+
+	start_times_out = this->start_times;
+	costs_out = this->costs.value();
+	return true;
+}
+
+Maybe<double>
+IncumbentExchange::get_costs() const
+{
+	std::lock_guard<std::mutex> lock(this->m);
+	return this->costs;
+}
+
+Maybe<double>
+IncumbentExchange::get_bound() const
+{
+	std::lock_guard<std::mutex> lock(this->m);
+	return this->bound;
+}
+
+std::vector<unsigned int>
+IncumbentExchange::get_start_times() const
+{
+	std::lock_guard<std::mutex> lock(this->m);
+	return this->start_times;
+}
+
+void
+IncumbentExchange::stop()
+{
+	this->stopped.store(true, std::memory_order_relaxed);
+}
+
+void
+IncumbentExchange::check_optimality()
+{
+	// Must be called with the lock held
+	if (this->costs.valid() && this->bound.valid() &&
+	    (this->costs.value() <= this->bound.value() + DOUBLE_DELTA)) {
+		if (!this->stopped.load(std::memory_order_relaxed)) {
+			BOOST_LOG(l.d(1)) << "Incumbent is optimal, stopping.";
+		}
+		this->stop();
+	}
+}
+
+} // namespace manager
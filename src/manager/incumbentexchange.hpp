@@ -0,0 +1,80 @@
+#ifndef TCPSPSUITE_INCUMBENTEXCHANGE_HPP
+#define TCPSPSUITE_INCUMBENTEXCHANGE_HPP
+
+#include "../datastructures/maybe.hpp" // for Maybe
+#include "../util/log.hpp"             // for Log
+
+#include <atomic> // for atomic
+#include <mutex>  // for mutex
+#include <vector> // for vector
+
+class AdditionalResultStorage;
+class Instance;
+class Timer;
+
+namespace manager {
+
+/* Shares incumbents and bounds between solvers that work concurrently on the
+ * same instance, i.e., the MIP and the heuristic of the ILP portfolio mode.
+ *
+ * Both sides offer every solution they find and fetch the ones the other side
+ * found. Only improvements are kept. Every improvement is recorded as an
+ * intermediate result, tagged with the side that produced it (see
+ * AdditionalResultStorage::IntermediateResult::SOURCE_*).
+ *
+ * All methods may be called from any thread.
+ */
+class IncumbentExchange {
+public:
+	IncumbentExchange(const Instance & instance, AdditionalResultStorage & storage,
+	                  const Timer & timer);
+
+	/* Offers a (complete) schedule. Returns true if it improved the incumbent.
+	 */
+	bool offer(const std::vector<unsigned int> & start_times, unsigned int source,
+	           Maybe<unsigned int> iteration = Maybe<unsigned int>());
+
+	/* Offers a lower bound on the costs. Only improvements are kept. */
+	void offer_bound(double bound);
+
+	/* Copies the incumbent to start_times if it was found by anyone but the
+	 * given source and has changed since seen_version, which is updated.
+	 * Returns false if there is nothing new. */
+	bool fetch(unsigned int source, size_t & seen_version,
+	           std::vector<unsigned int> & start_times, double & costs) const;
+
+	Maybe<double> get_costs() const;
+	Maybe<double> get_bound() const;
+	std::vector<unsigned int> get_start_times() const;
+
+	/* Tells everybody to wrap up. Also happens automatically as soon as the
+	 * incumbent is proven to be optimal by the bound. */
+	void stop();
+	bool
+	should_stop() const
+	{
+		return this->stopped.load(std::memory_order_relaxed);
+	}
+
+private:
+	void check_optimality();
+
+	const Instance & instance;
+	AdditionalResultStorage & storage;
+	const Timer & timer;
+
+	mutable std::mutex m;
+	std::vector<unsigned int> start_times;
+	Maybe<double> costs;
+	Maybe<double> bound;
+	unsigned int incumbent_source;
+
+	std::atomic<size_t> version;
+	std::atomic<bool> stopped;
+
+	Log l;
+};
+
+} // namespace manager
+
+#endif
@@ -20,6 +20,7 @@ using namespace std::chrono_literals;
 
 #ifdef PAPI_FOUND
 #include <papi.h>
+#include <pthread.h>
 #endif
 
 #ifdef INSTRUMENT_MALLOC
@@ -37,18 +38,78 @@ namespace manager {
 #ifdef PAPI_FOUND
 PAPIPerformanceInfo::PAPIPerformanceInfo(
     const std::vector<std::string> & measurements_in) noexcept
-    : initialized(false), measurements(measurements_in), num_counters(0),
-      l("PAPIPI")
+    : initialized(false), event_set(PAPI_NULL), measurements(measurements_in),
+      num_counters(0), l("PAPIPI")
 {}
 
+PAPIPerformanceInfo::~PAPIPerformanceInfo() noexcept
+{
+	if (this->event_set != PAPI_NULL) {
+		PAPI_cleanup_eventset(this->event_set);
+		PAPI_destroy_eventset(&this->event_set);
+	}
+}
+
+static unsigned long
+papi_thread_id() noexcept
+{
+	return static_cast<unsigned long>(pthread_self());
+}
+
+bool
+PAPIPerformanceInfo::initialize_library() noexcept
+{
+	static std::once_flag once;
+	static bool success = false;
+
+	std::call_once(once, []() {
+		if (PAPI_library_init(PAPI_VER_CURRENT) != PAPI_VER_CURRENT) {
+			return;
+		}
+		if (PAPI_thread_init(&papi_thread_id) != PAPI_OK) {
+			return;
+		}
+		success = true;
+	});
+
+	return success;
+}
+
 void
 PAPIPerformanceInfo::initialize() noexcept
 {
-	this->num_counters = static_cast<size_t>(PAPI_num_counters());
+	this->initialized = true;
+
+	if (!PAPIPerformanceInfo::initialize_library()) {
+		BOOST_LOG(l.e()) << "Could not initialize the PAPI library.";
+		return;
+	}
+
+	PAPI_register_thread();
+
+	this->num_counters = static_cast<size_t>(PAPI_num_cmp_hwctrs(0));
 
 	BOOST_LOG(l.d(1)) << "Your system has " << this->num_counters
 	                  << " PAPI counters available.";
 
+	if (PAPI_create_eventset(&this->event_set) != PAPI_OK) {
+		BOOST_LOG(l.e()) << "Could not create PAPI event set.";
+		this->event_set = PAPI_NULL;
+		return;
+	}
+
+	// Count threads spawned by the solver, too.
+	if (PAPI_assign_eventset_component(this->event_set, 0) == PAPI_OK) {
+		PAPI_option_t opt;
+		memset(&opt, 0, sizeof(opt));
+		opt.inherit.eventset = this->event_set;
+		opt.inherit.inherit = PAPI_INHERIT_ALL;
+		if (PAPI_set_opt(PAPI_INHERIT, &opt) != PAPI_OK) {
+			BOOST_LOG(l.w()) << "PAPI counters are not inherited by child threads. "
+			                    "Only the runner thread is counted.";
+		}
+	}
+
 	int event_code;
 	event_code = 0 | PAPI_NATIVE_MASK;
 
@@ -61,14 +122,18 @@ PAPIPerformanceInfo::initialize() noexcept
 			continue;
 		}
 
+		if (PAPI_add_event(this->event_set, event_code) != PAPI_OK) {
+			BOOST_LOG(l.e()) << "PAPI event " << event_str
+			                 << " could not be added! Not measuring.";
+			continue;
+		}
+
 		this->selected_event_names.push_back(event_str);
 		this->selected_events.push_back(event_code);
 		BOOST_LOG(l.d(3)) << "Registering PAPI event " << event_str << " (ID "
 		                  << event_code << ")";
 	}
 	this->event_counts.resize(this->selected_events.size());
-
-	this->initialized = true;
 }
 
 void
@@ -78,8 +143,8 @@ PAPIPerformanceInfo::start() noexcept
 		this->initialize();
 	}
 
-	if (PAPI_start_counters(this->selected_events.data(),
-	                        (int)this->selected_events.size()) != PAPI_OK) {
+	if ((this->event_set == PAPI_NULL) ||
+	    (PAPI_start(this->event_set) != PAPI_OK)) {
 		BOOST_LOG(l.e()) << "Could not start PAPI measurements.";
 	}
 }
@@ -87,8 +152,8 @@ PAPIPerformanceInfo::start() noexcept
 void
 PAPIPerformanceInfo::stop() noexcept
 {
-	if (PAPI_stop_counters(this->event_counts.data(),
-	                       (int)this->event_counts.size()) != PAPI_OK) {
+	if ((this->event_set == PAPI_NULL) ||
+	    (PAPI_stop(this->event_set, this->event_counts.data()) != PAPI_OK)) {
 		BOOST_LOG(l.e()) << "Could not stop PAPI measurements.";
 	}
 }
@@ -110,11 +175,18 @@ PAPIPerformanceInfo::get_counts() const noexcept
  * End of PAPIPerformanceInfo
  **********************************************/
 
-LinuxMemoryInfo::LinuxMemoryInfo(unsigned int sampling_ms_in)
-    : sampling_ms(sampling_ms_in),
-      page_size(static_cast<size_t>(sysconf(_SC_PAGE_SIZE)))
+LinuxMemoryInfo::LinuxMemoryInfo(unsigned int sampling_ms_in,
+                                 bool per_thread_in)
+    : sampling_ms(sampling_ms_in), per_thread(per_thread_in),
+      page_size(static_cast<size_t>(sysconf(_SC_PAGE_SIZE))), l("MEMINFO")
 {}
 
+bool
+LinuxMemoryInfo::has_process_data() const noexcept
+{
+	return !this->per_thread;
+}
+
 size_t
 LinuxMemoryInfo::get_rss_bytes_max() const noexcept
 {
@@ -186,6 +258,14 @@ LinuxMemoryInfo::reset() noexcept
 void
 LinuxMemoryInfo::start() noexcept
 {
+	if (this->per_thread) {
+		// Threads the solver starts from here on join the group, too
+		this->group = std::make_shared<util::ThreadGroup>();
+		this->membership =
+		    std::make_unique<util::ThreadGroup::Membership>(this->group);
+		return;
+	}
+
 	this->reset();
 #ifdef INSTRUMENT_MALLOC
 	thrill::mem::malloc_tracker_reset_peak();
@@ -220,6 +300,9 @@ LinuxMemoryInfo::measure() noexcept
 {
 #ifdef INSTRUMENT_MALLOC
 #else
+	if (this->per_thread) {
+		return;
+	}
 	{
 		std::lock_guard<std::mutex> guard(this->m);
 		if (this->requested_action != ACTION_FINISH) {
@@ -233,6 +316,11 @@ LinuxMemoryInfo::measure() noexcept
 void
 LinuxMemoryInfo::stop() noexcept
 {
+	if (this->per_thread) {
+		this->stop_thread_group();
+		return;
+	}
+
 #ifdef INSTRUMENT_MALLOC
 	this->malloc_allocs_after = thrill::mem::malloc_tracker_total_allocs();
 	this->malloc_peak = thrill::mem::malloc_tracker_peak();
@@ -251,6 +339,43 @@ LinuxMemoryInfo::stop() noexcept
 	    &this->user_usecs_after, &this->system_usecs_after);
 }
 
+void
+LinuxMemoryInfo::stop_thread_group() noexcept
+{
+	this->membership.reset();
+
+	size_t still_running = this->group->get_member_count();
+	if (still_running > 0) {
+		BOOST_LOG(l.w()) << still_running
+		                 << " threads of the run are still running. Their "
+		                    "resource usage is not counted.";
+	}
+
+	util::ThreadGroup::Usage usage = this->group->get_usage();
+	this->group.reset();
+
+	this->minor_pagefaults_before = 0;
+	this->minor_pagefaults_after = usage.minor_pagefaults;
+	this->major_pagefaults_before = 0;
+	this->major_pagefaults_after = usage.major_pagefaults;
+	this->user_usecs_before = 0;
+	this->user_usecs_after = usage.user_usecs;
+	this->system_usecs_before = 0;
+	this->system_usecs_after = usage.system_usecs;
+
+#ifdef INSTRUMENT_MALLOC
+	this->malloc_allocs_before = 0;
+	this->malloc_allocs_after = usage.malloc_count;
+	this->malloc_peak = usage.malloc_peak;
+#endif
+	// Like the DATA size, the RSS belongs to the whole process. Page faults
+	// are no substitute, pages are faulted in again after being reclaimed.
+	this->rss_pages_before = 0;
+	this->rss_max_pages = 0;
+	this->data_pages_before = 0;
+	this->data_max_pages = 0;
+}
+
 void
 LinuxMemoryInfo::sample() noexcept
 {
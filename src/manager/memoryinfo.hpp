@@ -9,6 +9,7 @@
 #define SRC_MANAGER_MEMORYINFO_HPP_
 
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -18,24 +19,37 @@
 
 #include "generated_config.hpp"
 #include "../util/log.hpp"
+#include "../util/threadgroup.hpp"
 
 namespace manager {
 
 #ifdef PAPI_FOUND
+/* Counts the requested events for the thread that calls start() / stop(),
+ * including any threads it spawns in between (if the PAPI component supports
+ * inheritance, a warning is logged otherwise). Thus, concurrent runs in
+ * different threads do not interfere. Threads started before start() are not
+ * counted. */
 class PAPIPerformanceInfo {
 public:
 	PAPIPerformanceInfo(const std::vector<std::string> & measurements) noexcept;
+	~PAPIPerformanceInfo() noexcept;
 
 	void start() noexcept;
 	void stop() noexcept;
 
 	std::vector<std::pair<std::string, long long>> get_counts() const noexcept;
 
+	/* Initializes PAPI for multi-threaded use, once per process. Returns
+	 * whether PAPI can be used. */
+	static bool initialize_library() noexcept;
+
 private:
 	bool initialized;
 
 	void initialize() noexcept;
 
+	int event_set;
+
 	const std::vector<std::string> & measurements;
 
 	size_t num_counters;
@@ -50,15 +64,27 @@ private:
 class PAPIPerformanceInfo {};
 #endif
 
+/* If per_thread is set, all measurements are restricted to the threads of
+ * the run: the thread calling start() / stop() and every thread that joins its
+ * util::ThreadGroup in between (e.g., WorkerPool threads). Those threads must
+ * have ended before stop() to be counted. Page faults and CPU times are
+ * summed over the threads. With INSTRUMENT_MALLOC, the malloc() figures count
+ * only the threads' allocations, and the peak is the sum of the threads'
+ * peaks. The RSS and DATA sizes are properties of the whole process and are
+ * not available in that mode, see has_process_data().
+ *
+ * Threads that third-party libraries start (e.g., a MIP solver's) can not be
+ * counted. The runner does not measure such solvers per thread. */
 class LinuxMemoryInfo
 {
 public:
-	LinuxMemoryInfo(unsigned int sampling_ms);
+	LinuxMemoryInfo(unsigned int sampling_ms, bool per_thread = false);
 
 	void start() noexcept;
 	void stop() noexcept;
 	void measure() noexcept;
 
+	bool has_process_data() const noexcept;
 	size_t get_rss_bytes_max() const noexcept;
 	size_t get_data_bytes_max() const noexcept;
 
@@ -74,6 +100,7 @@ public:
 
 private:
 	void reset() noexcept;
+	void stop_thread_group() noexcept;
 
 	void run() noexcept;
 	void sample() noexcept;
@@ -81,6 +108,7 @@ private:
 	bool stop_requested = false;
 
 	unsigned int sampling_ms;
+	bool per_thread;
 
 	size_t rss_pages_before;
 	size_t rss_max_pages;
@@ -101,6 +129,9 @@ private:
 	size_t malloc_peak;
 #endif
 
+	std::shared_ptr<util::ThreadGroup> group;
+	std::unique_ptr<util::ThreadGroup::Membership> membership;
+
 	size_t page_size;
 
 	void get_mem_proc_data(size_t * rss_out, size_t * data_out) noexcept;
@@ -113,6 +144,8 @@ private:
 	constexpr static int ACTION_FINISH = 0;
 	constexpr static int ACTION_MEASURE = 1;
 	int requested_action;
+
+	Log l;
 };
 
 }
@@ -9,6 +9,7 @@
 #include "../instance/instance.hpp"  // for Instance
 #include "../io/jsonreader.hpp"      // for JsonReader
 #include "../util/configuration.hpp" // for Configuration
+#include "../util/fault_codes.hpp"   // for FAULT_WORKER_CRASHED
 #include "../util/git.hpp"           // for GIT_SHA1
 #include "../util/randomizer.hpp"    // for Randomizer
 #include "../util/solverconfig.hpp"  // for SolverConfig
@@ -16,30 +17,93 @@
 #include "selector.hpp" // for Selector
 
 #include <algorithm>                                   // for min, sort
+#include <cerrno>                                      // for errno
+#include <csignal>                                     // for signal, SIGKILL
+#include <cstdlib>                                     // for EXIT_FAILURE
+#include <cstring>                                     // for strerror, memset
+#include <iostream>                                    // for cout, cerr
+#include <limits>                                      // for numeric_limits
+#include <new>                                         // for bad_alloc
+#include <poll.h>                                      // for poll
+#include <stdexcept>                                   // for runtime_error
+#include <sys/stat.h>                                  // for stat
+#include <sys/wait.h>                                  // for waitpid
+#include <unistd.h>                                    // for fork, pipe
+#include <unordered_map>                               // for unordered_map
 #include <boost/log/core/record.hpp>                   // for record
 #include <boost/log/detail/attachable_sstream_buf.hpp> // for basic_ostring...
 #include <boost/log/sources/record_ostream.hpp>        // for basic_record_...
 
 #ifdef NUMA_OPTIMIZE
 #include <numa.h>
+#include <pthread.h>
+#include <sched.h>
 #endif
 
 Parallelizer::Parallelizer(Storage & storage_in, std::string run_id_in,
                            Randomizer & randomizer_in)
     : storage(storage_in), run_id(run_id_in), randomizer(randomizer_in),
-      l("PARALLELIZER")
+      memory_in_use(0), admission_generation(0), l("PARALLELIZER")
+{
+#ifdef NUMA_OPTIMIZE
+	assert(numa_available() != -1);
+	this->node_count = (unsigned int)(numa_max_node() + 1);
+#else
+	this->node_count = 1;
+#endif
+}
+
+Parallelizer::InstanceCache::InstanceCache(size_t capacity_in)
+    : capacity(capacity_in)
 {}
 
+std::shared_ptr<Instance>
+Parallelizer::InstanceCache::get(const std::string & file_name)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for (auto it = this->entries.begin(); it != this->entries.end(); ++it) {
+		if (it->first == file_name) {
+			this->entries.splice(this->entries.begin(), this->entries, it);
+			return it->second;
+		}
+	}
+	return nullptr;
+}
+
+void
+Parallelizer::InstanceCache::put(const std::string & file_name,
+                                 std::shared_ptr<Instance> instance)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for (const auto & entry : this->entries) {
+		if (entry.first == file_name) {
+			// Someone else parsed it concurrently. Keep theirs.
+			return;
+		}
+	}
+	this->entries.emplace_front(file_name, instance);
+	// Evicted instances live on as long as a thread still works on them
+	while (this->entries.size() > this->capacity) {
+		this->entries.pop_back();
+	}
+}
+
+unsigned int
+Parallelizer::get_node(int thread_id) const
+{
+	return (unsigned int)thread_id % this->node_count;
+}
+
 void
 Parallelizer::run_in_parallel(const std::vector<std::string> & filenames,
                               const std::vector<SolverConfig> & configurations,
                               unsigned int thread_count)
 {
-	this->remaining_tasks.reserve(configurations.size() * filenames.size());
+	this->all_tasks.reserve(configurations.size() * filenames.size());
 
 	for (const std::string & fname : filenames) {
 		for (const SolverConfig & config : configurations) {
-			this->remaining_tasks.emplace_back(fname, config);
+			this->all_tasks.emplace_back(fname, config);
 		}
 	}
 
@@ -59,36 +123,73 @@ Parallelizer::run_in_parallel(const std::vector<std::string> & filenames,
 			        std::hash<SolverConfig>{}(rhs.second));
 		};
 
-		double partition_size = (double)this->remaining_tasks.size() /
+		double partition_size = (double)this->all_tasks.size() /
 		                        (double)cfg->get_partition_count();
 
 		size_t partition_border_low =
 		    (size_t)(std::floor(partition_size * cfg->get_partition_number()));
 		size_t partition_border_high =
-		    std::min(this->remaining_tasks.size(),
+		    std::min(this->all_tasks.size(),
 		             (size_t)(std::floor(partition_size *
 		                                 (cfg->get_partition_number() + 1))));
 
-		auto low_it = this->remaining_tasks.begin() + (long)partition_border_low;
-		std::nth_element(this->remaining_tasks.begin(), low_it,
-		                 this->remaining_tasks.end(), cmp);
+		auto low_it = this->all_tasks.begin() + (long)partition_border_low;
+		std::nth_element(this->all_tasks.begin(), low_it,
+		                 this->all_tasks.end(), cmp);
 
-		auto high_it = this->remaining_tasks.begin();
+		auto high_it = this->all_tasks.begin();
 		if (cfg->get_partition_number().value() ==
 		    cfg->get_partition_count().value() - 1) {
 			// We are the last partition
-			high_it = this->remaining_tasks.end();
+			high_it = this->all_tasks.end();
 		} else {
 			high_it += (long)partition_border_high;
-			std::nth_element(low_it, high_it, this->remaining_tasks.end(), cmp);
+			std::nth_element(low_it, high_it, this->all_tasks.end(), cmp);
 		}
 
 		std::vector<std::pair<std::string, SolverConfig>> my_partition(low_it,
 		                                                               high_it);
-		this->remaining_tasks = std::move(my_partition);
+		this->all_tasks = std::move(my_partition);
+	}
+
+	this->totalTasks = all_tasks.size();
+	this->remaining_count = this->totalTasks;
+
+	/*
+	 * Order tasks longest-first and distribute them among the threads
+	 */
+	std::vector<Task> tasks;
+	tasks.reserve(this->all_tasks.size());
+	for (size_t i = 0; i < this->all_tasks.size(); ++i) {
+		tasks.push_back(
+		    {i, this->all_tasks[i].first, this->all_tasks[i].second, 0.0, 0});
+	}
+
+	this->estimate_costs(tasks);
+
+	if (cfg->get_memory_budget().valid()) {
+		this->memory_budget =
+		    Maybe<size_t>(cfg->get_memory_budget().value() * 1024 * 1024);
+		BOOST_LOG(l.i()) << "Using a memory budget of "
+		                 << cfg->get_memory_budget().value() << " MiB";
+		this->estimate_memory(tasks);
 	}
 
-	this->totalTasks = remaining_tasks.size();
+	this->distribute_tasks(tasks, thread_count);
+
+	// Keep one instance per thread on the node plus the one coming up next
+	size_t threads_per_node =
+	    (thread_count + this->node_count - 1) / this->node_count;
+	this->instance_caches.clear();
+	for (unsigned int node = 0; node < this->node_count; ++node) {
+		this->instance_caches.emplace_back(
+		    new InstanceCache(threads_per_node + 1));
+	}
+
+	if (cfg->get_isolate_processes()) {
+		this->run_isolated(thread_count);
+		return;
+	}
 
 	for (unsigned int i = 0; i < thread_count; ++i) {
 		this->threads.push_back(std::thread(&Parallelizer::run_thread, this, i));
@@ -99,107 +200,931 @@ Parallelizer::run_in_parallel(const std::vector<std::string> & filenames,
 	}
 }
 
-Maybe<std::pair<std::string, SolverConfig>>
-Parallelizer::get_next_task()
+std::unordered_map<std::string, size_t>
+Parallelizer::get_file_sizes(const std::vector<Task> & tasks) const
 {
-	std::lock_guard<std::mutex> lock(this->queue_mutex);
+	std::unordered_map<std::string, size_t> file_sizes;
+	for (const Task & task : tasks) {
+		if (file_sizes.find(task.file_name) != file_sizes.end()) {
+			continue;
+		}
+		struct stat st;
+		size_t size = 0;
+		if (stat(task.file_name.c_str(), &st) == 0) {
+			size = (size_t)st.st_size;
+		}
+		file_sizes[task.file_name] = size;
+	}
+	return file_sizes;
+}
 
-	if (this->remaining_tasks.empty()) {
-		return Maybe<std::pair<std::string, SolverConfig>>();
-	} else {
-		size_t done = this->totalTasks - remaining_tasks.size();
-		BOOST_LOG(l.i()) << "====================================================";
-		BOOST_LOG(l.i()) << "ca. " << done << " of " << this->totalTasks
-		                 << " tasks finished";
-		BOOST_LOG(l.i()) << remaining_tasks.size() << " tasks remaining";
-		BOOST_LOG(l.i()) << "====================================================";
-		std::pair<std::string, SolverConfig> next_task =
-		    this->remaining_tasks.back();
-		this->remaining_tasks.pop_back();
-		return {next_task};
+void
+Parallelizer::estimate_costs(std::vector<Task> & tasks)
+{
+	/*
+	 * A task's cost is the mean historical running time of its configuration
+	 * (or its time limit, if we have never seen it), scaled by the size of the
+	 * instance file relative to the average instance size, and capped at the
+	 * time limit.
+	 */
+	std::unordered_map<std::string, size_t> file_sizes =
+	    this->get_file_sizes(tasks);
+	double size_sum = 0;
+	for (const auto & entry : file_sizes) {
+		size_sum += (double)entry.second;
+	}
+	double mean_size = file_sizes.empty() ? 0.0 : size_sum / file_sizes.size();
+
+	std::unordered_map<std::string, Maybe<double>> history;
+	double fallback_cost = 0;
+	for (const Task & task : tasks) {
+		const std::string & cfg_name = task.config.get_name();
+		if (history.find(cfg_name) == history.end()) {
+			history[cfg_name] = this->storage.get_mean_elapsed(cfg_name);
+			if (history[cfg_name].valid()) {
+				BOOST_LOG(l.d(1)) << "Historical mean running time for " << cfg_name
+				                  << ": " << history[cfg_name].value() << "s";
+			}
+		}
+		if (task.config.get_time_limit().valid()) {
+			fallback_cost = std::max(fallback_cost,
+			                         (double)task.config.get_time_limit().value());
+		}
+		if (history[cfg_name].valid()) {
+			fallback_cost = std::max(fallback_cost, history[cfg_name].value());
+		}
+	}
+	if (fallback_cost <= 0) {
+		fallback_cost = 1.0;
+	}
+
+	for (Task & task : tasks) {
+		const Maybe<double> & hist = history[task.config.get_name()];
+		Maybe<unsigned int> time_limit = task.config.get_time_limit();
+
+		double base;
+		if (hist.valid()) {
+			base = hist.value();
+		} else if (time_limit.valid()) {
+			base = (double)time_limit.value();
+		} else {
+			base = fallback_cost;
+		}
+
+		double size_factor = 1.0;
+		if (mean_size > 0) {
+			size_factor = (double)file_sizes[task.file_name] / mean_size;
+		}
+
+		task.estimated_cost = base * size_factor;
+		if (time_limit.valid()) {
+			task.estimated_cost =
+			    std::min(task.estimated_cost, (double)time_limit.value());
+		}
 	}
 }
 
 void
-Parallelizer::run_thread(int thread_id)
+Parallelizer::estimate_memory(std::vector<Task> & tasks)
 {
-	Selector selector(this->storage, this->run_id, thread_id);
+	/*
+	 * If the configuration was measured before, its largest recent peak is
+	 * used as is. That peak was taken over instances of different sizes, so
+	 * scaling it by the instance size once more would count the size twice.
+	 * Without any prior measurement, the peak memory usage is assumed to be a
+	 * multiple of the instance file size. MIP models and the elite pool
+	 * scorer's n x n cache are a lot hungrier than the rest.
+	 */
+	constexpr size_t DEFAULT_SIZE_MULTIPLIER = 20;
+	constexpr size_t MIP_SIZE_MULTIPLIER = 500;
+	constexpr size_t EPS_SIZE_MULTIPLIER = 100;
+
+	std::unordered_map<std::string, size_t> file_sizes =
+	    this->get_file_sizes(tasks);
+
+	std::unordered_map<std::string, Maybe<size_t>> history;
+	for (Task & task : tasks) {
+		const std::string & cfg_name = task.config.get_name();
+		if (history.find(cfg_name) == history.end()) {
+			history[cfg_name] = this->storage.get_peak_memory(cfg_name);
+			if (history[cfg_name].valid()) {
+				BOOST_LOG(l.d(1)) << "Historical peak memory usage for " << cfg_name
+				                  << ": " << (history[cfg_name].value() / 1024 / 1024)
+				                  << " MiB";
+			}
+		}
+
+		const Maybe<size_t> & hist = history[cfg_name];
+		if (hist.valid()) {
+			task.estimated_memory = hist.value();
+		} else {
+			size_t multiplier = DEFAULT_SIZE_MULTIPLIER;
+			if (task.config.get_id().find("ILP") != std::string::npos) {
+				multiplier = MIP_SIZE_MULTIPLIER;
+			} else if (task.config.has_config("use_eps") &&
+			           task.config.as_bool("use_eps")) {
+				multiplier = EPS_SIZE_MULTIPLIER;
+			}
+			task.estimated_memory = file_sizes[task.file_name] * multiplier;
+		}
+	}
+}
+
+void
+Parallelizer::distribute_tasks(std::vector<Task> & tasks,
+                               unsigned int thread_count)
+{
+	std::stable_sort(tasks.begin(), tasks.end(),
+	                 [](const Task & lhs, const Task & rhs) {
+		                 return lhs.estimated_cost > rhs.estimated_cost;
+	                 });
+
+	this->worker_queues.clear();
+	for (unsigned int i = 0; i < thread_count; ++i) {
+		this->worker_queues.emplace_back(new WorkerQueue());
+	}
 
-	Maybe<std::pair<std::string, SolverConfig>> task = this->get_next_task();
+	// Every instance gets a home node, again greedily by load. All tasks on
+	// that instance go to threads on that node, s.t. they can share the
+	// node-local copy of the instance.
+	unsigned int used_nodes = std::min(this->node_count, thread_count);
+	std::unordered_map<std::string, double> file_costs;
+	for (const Task & task : tasks) {
+		file_costs[task.file_name] += task.estimated_cost;
+	}
+	std::vector<std::pair<std::string, double>> files_by_cost(file_costs.begin(),
+	                                                          file_costs.end());
+	std::sort(files_by_cost.begin(), files_by_cost.end(),
+	          [](const auto & lhs, const auto & rhs) {
+		          return (lhs.second > rhs.second) ||
+		                 ((lhs.second == rhs.second) && (lhs.first < rhs.first));
+	          });
+	std::vector<double> node_loads(used_nodes, 0.0);
+	std::unordered_map<std::string, unsigned int> home_node;
+	for (const auto & [file_name, cost] : files_by_cost) {
+		unsigned int node = (unsigned int)std::distance(
+		    node_loads.begin(),
+		    std::min_element(node_loads.begin(), node_loads.end()));
+		home_node[file_name] = node;
+		node_loads[node] += cost;
+	}
+
+	// Greedy LPT assignment: every task goes to the currently least loaded
+	// thread on its home node. Since tasks arrive in descending order, every
+	// queue is sorted descendingly, too.
+	for (Task & task : tasks) {
+		unsigned int node = home_node[task.file_name];
+		WorkerQueue * least_loaded = nullptr;
+		for (unsigned int i = node; i < thread_count; i += this->node_count) {
+			WorkerQueue * wq = this->worker_queues[i].get();
+			if ((least_loaded == nullptr) ||
+			    (wq->remaining_cost < least_loaded->remaining_cost)) {
+				least_loaded = wq;
+			}
+		}
+		least_loaded->remaining_cost += task.estimated_cost;
+		least_loaded->tasks.push_back(std::move(task));
+	}
+
+	for (unsigned int i = 0; i < thread_count; ++i) {
+		BOOST_LOG(l.d(1)) << "Thread " << i << " starts with "
+		                  << this->worker_queues[i]->tasks.size()
+		                  << " tasks, estimated "
+		                  << this->worker_queues[i]->remaining_cost << "s";
+	}
+}
+
+void
+Parallelizer::log_progress()
+{
+	std::lock_guard<std::mutex> lock(this->log_mutex);
+
+	size_t remaining = this->remaining_count;
+	size_t done = this->totalTasks - remaining;
+	BOOST_LOG(l.i()) << "====================================================";
+	BOOST_LOG(l.i()) << "ca. " << done << " of " << this->totalTasks
+	                 << " tasks finished";
+	BOOST_LOG(l.i()) << remaining << " tasks remaining";
+	BOOST_LOG(l.i()) << "====================================================";
+}
+
+bool
+Parallelizer::fits_budget(const Task & task) const
+{
+	// Must be called with admission_mutex held
+	if (!this->memory_budget.valid() || (this->memory_in_use == 0)) {
+		return true;
+	}
+	return this->memory_in_use + task.estimated_memory <=
+	       this->memory_budget.value();
+}
+
+bool
+Parallelizer::is_admissible(const Task & task)
+{
+	if (!this->memory_budget.valid()) {
+		return true;
+	}
+	std::lock_guard<std::mutex> lock(this->admission_mutex);
+	return this->fits_budget(task);
+}
+
+bool
+Parallelizer::try_reserve_memory(const Task & task)
+{
+	if (!this->memory_budget.valid()) {
+		return true;
+	}
+	std::lock_guard<std::mutex> lock(this->admission_mutex);
+	if (!this->fits_budget(task)) {
+		return false;
+	}
+	this->memory_in_use += task.estimated_memory;
+	return true;
+}
+
+void
+Parallelizer::release_memory(const Task & task)
+{
+	if (!this->memory_budget.valid()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->admission_mutex);
+		this->memory_in_use -= task.estimated_memory;
+		this->admission_generation++;
+	}
+	this->admission_cv.notify_all();
+}
+
+Parallelizer::MemoryReservation::MemoryReservation(Parallelizer & parallelizer_in,
+                                                   const Task & task_in)
+    : parallelizer(parallelizer_in), task(task_in)
+{}
 
+Parallelizer::MemoryReservation::~MemoryReservation()
+{
+	this->parallelizer.release_memory(this->task);
+}
+
+Maybe<Parallelizer::Task>
+Parallelizer::take_own_task(int thread_id)
+{
+	WorkerQueue & own = *this->worker_queues[(size_t)thread_id];
+	std::lock_guard<std::mutex> lock(own.mutex);
+
+	for (auto it = own.tasks.begin(); it != own.tasks.end(); ++it) {
+		if (this->try_reserve_memory(*it)) {
+			Task task = std::move(*it);
+			own.tasks.erase(it);
+			own.remaining_cost -= task.estimated_cost;
+			return Maybe<Task>(std::move(task));
+		}
+	}
+
+	return Maybe<Task>();
+}
+
+Maybe<Parallelizer::Task>
+Parallelizer::steal_task(int thread_id)
+{
+	// Threads on our own node are preferred as victims, since their instances
+	// are likely to be in our node's cache. Other threads may take from the
+	// victim between choosing and locking it, in which case we come back
+	// empty-handed and the caller retries.
+	WorkerQueue * victim = nullptr;
+	double victim_cost = -1;
+	bool victim_local = false;
+	unsigned int my_node = this->get_node(thread_id);
+
+	for (size_t i = 0; i < this->worker_queues.size(); ++i) {
+		if ((int)i == thread_id) {
+			continue;
+		}
+		bool local = (this->get_node((int)i) == my_node);
+		if (victim_local && !local) {
+			continue;
+		}
+
+		WorkerQueue & wq = *this->worker_queues[i];
+		std::lock_guard<std::mutex> lock(wq.mutex);
+		if (wq.tasks.empty() ||
+		    ((local == victim_local) && (wq.remaining_cost <= victim_cost))) {
+			continue;
+		}
+		if (std::any_of(wq.tasks.begin(), wq.tasks.end(),
+		                [&](const Task & t) { return this->is_admissible(t); })) {
+			victim = &wq;
+			victim_cost = wq.remaining_cost;
+			victim_local = local;
+		}
+	}
+
+	if (victim == nullptr) {
+		return Maybe<Task>();
+	}
+
+	std::lock_guard<std::mutex> lock(victim->mutex);
+	for (auto it = victim->tasks.rbegin(); it != victim->tasks.rend(); ++it) {
+		if (this->try_reserve_memory(*it)) {
+			Task stolen = std::move(*it);
+			victim->tasks.erase(std::next(it).base());
+			victim->remaining_cost -= stolen.estimated_cost;
+
+			BOOST_LOG(l.d(2)) << "Thread " << thread_id << " stole a task of cost "
+			                  << stolen.estimated_cost;
+
+			return Maybe<Task>(std::move(stolen));
+		}
+	}
+
+	return Maybe<Task>();
+}
+
+Maybe<Parallelizer::Task>
+Parallelizer::try_next_task(int thread_id)
+{
+	// Reserves the task's memory on success
+	Maybe<Task> task = this->take_own_task(thread_id);
+	if (!task.valid()) {
+		task = this->steal_task(thread_id);
+	}
+
+	if (task.valid()) {
+		this->log_progress();
+		this->remaining_count--;
+	}
+
+	return task;
+}
+
+Maybe<Parallelizer::Task>
+Parallelizer::get_next_task(int thread_id)
+{
+	while (true) {
+		size_t generation;
+		{
+			std::lock_guard<std::mutex> lock(this->admission_mutex);
+			generation = this->admission_generation;
+		}
+
+		Maybe<Task> task = this->try_next_task(thread_id);
+		if (task.valid()) {
+			return task;
+		}
+
+		if (this->remaining_count == 0) {
+			return Maybe<Task>();
+		}
+
+		std::unique_lock<std::mutex> lock(this->admission_mutex);
+		if (this->memory_in_use == 0) {
+			// Everything fits. Someone else took the task we were after, but
+			// others are left.
+			lock.unlock();
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Tasks are left, but none of them fitted into the memory budget. Since
+		// memory_in_use is positive, some running task will eventually release
+		// its memory and wake us up. Releases since we started looking count,
+		// too, they might have made room for what we just rejected.
+		BOOST_LOG(l.d(1)) << "Thread " << thread_id
+		                  << " defers: no remaining task fits into the memory "
+		                     "budget ("
+		                  << (this->memory_in_use / 1024 / 1024) << " MiB in use)";
+		this->admission_cv.wait(lock, [&]() {
+			return this->admission_generation != generation;
+		});
+	}
+}
+
+void
+Parallelizer::bind_to_node(int thread_id)
+{
 #ifdef NUMA_OPTIMIZE
-	assert(numa_available() != -1);
+	unsigned int node = this->get_node(thread_id);
+
+	numa_run_on_node((int)node);
+	struct bitmask * run_nodes = numa_get_run_node_mask();
+	numa_set_membind(run_nodes);
+	numa_bitmask_free(run_nodes);
+
+	/*
+	 * Additionally pin to a fixed set of cores on the node, one block of
+	 * <threads> cores per parallel run, so that runs do not migrate (and lose
+	 * their caches) within the node.
+	 */
+	struct bitmask * node_cpus = numa_allocate_cpumask();
+	numa_node_to_cpus((int)node, node_cpus);
+	std::vector<unsigned int> cpus;
+	for (unsigned int cpu = 0; cpu < node_cpus->size; ++cpu) {
+		if (numa_bitmask_isbitset(node_cpus, cpu)) {
+			cpus.push_back(cpu);
+		}
+	}
+	numa_free_cpumask(node_cpus);
+
+	unsigned int block_size = 1;
+	if (Configuration::get()->get_threads().valid()) {
+		block_size = std::max(1u, Configuration::get()->get_threads().value());
+	}
+	unsigned int run_on_node = (unsigned int)thread_id / this->node_count;
 
-	BOOST_LOG(l.i()) << "Pinning to NUMA node "
-	                 << (thread_id % (numa_max_node() + 1));
+	if (cpus.size() >= block_size) {
+		unsigned int blocks = (unsigned int)cpus.size() / block_size;
+		unsigned int first = (run_on_node % blocks) * block_size;
+
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		for (unsigned int i = first; i < first + block_size; ++i) {
+			CPU_SET(cpus[i], &cpu_set);
+		}
+
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) ==
+		    0) {
+			BOOST_LOG(l.i()) << "Pinning to NUMA node " << node << ", cores "
+			                 << cpus[first] << " to "
+			                 << cpus[first + block_size - 1];
+			return;
+		}
+	}
 
-	numa_run_on_node(thread_id % (numa_max_node() + 1));
-	numa_set_membind(numa_get_run_node_mask());
+	BOOST_LOG(l.i()) << "Pinning to NUMA node " << node;
 #else
 	(void)thread_id;
 #endif
+}
+
+void
+Parallelizer::assign_seed(SolverConfig & config)
+{
+	Configuration & cfg = *Configuration::get();
+	if (cfg.get_instance_seed().valid()) {
+		config.override_seed(cfg.get_instance_seed().value());
+	}
+	if (!config.was_seed_set()) {
+		config.override_seed(this->randomizer.get_random());
+	}
+}
+
+Instance *
+Parallelizer::parse_instance(const std::string & file_name)
+{
+	Instance * instance = nullptr;
+	try {
+		JsonReader reader(file_name);
+		instance = reader.parse();
+	} catch (json::parse_error e) {
+		BOOST_LOG(l.e()) << "JSON Parsing error in instance file.";
+		BOOST_LOG(l.e()) << "Problematic file: " << file_name;
+		BOOST_LOG(l.e()) << e.what();
+		BOOST_LOG(l.e()) << "Error is near: ";
+
+		util::FileContextGiver fcg(file_name, e.byte);
+
+		for (const auto & line : fcg.get_message()) {
+			BOOST_LOG(l.e()) << line;
+		}
+
+		// Or register error and continue with next instance?
+		throw std::move(e);
+	}
+
+	instance->compute_traits();
+	return instance;
+}
+
+std::shared_ptr<Instance>
+Parallelizer::get_instance(int thread_id, const std::string & file_name)
+{
+	InstanceCache & cache = *this->instance_caches[this->get_node(thread_id)];
+
+	std::shared_ptr<Instance> instance = cache.get(file_name);
+	if (instance) {
+		BOOST_LOG(l.d(1)) << "Using node-local cached instance " << file_name;
+		return instance;
+	}
+
+	// We are bound to the node, so the parsed instance is allocated there
+	instance.reset(this->parse_instance(file_name));
+	cache.put(file_name, instance);
+
+	return instance;
+}
+
+void
+Parallelizer::process_task(int thread_id, Selector & selector,
+                           const std::string & file_name,
+                           const SolverConfig & solverConfig)
+{
+	std::shared_ptr<Instance> instance =
+	    this->get_instance(thread_id, file_name);
+
+	BOOST_LOG(l.i()) << "====================================================";
+	BOOST_LOG(l.i()) << "Now processing: ";
+	BOOST_LOG(l.i()) << file_name;
+	BOOST_LOG(l.i()) << solverConfig.get_name();
+	BOOST_LOG(l.i()) << "====================================================";
+	BOOST_LOG(l.d(1)) << "Software version: " << std::string(GIT_SHA1);
+
+	BOOST_LOG(l.d(2)) << " Config Settings: ";
+	for (auto & [k, v] : solverConfig.get_kvs()) {
+		BOOST_LOG(l.d(2)) << "   " << k << ": \t" << v;
+	}
+
+	BOOST_LOG(l.d(1)) << "====================================================";
+
+	selector.run_all(*instance, solverConfig);
+
+	// TODO FIXME re-add logging!
+	/*
+	if (log_dir != nullptr) {
+	    Log::remove_logger(file_log);
+	    delete file_log;
+	}
+	*/
+}
+
+void
+Parallelizer::run_thread(int thread_id)
+{
+	// Bind first, s.t. everything this thread allocates is node-local
+	this->bind_to_node(thread_id);
+
+	Selector selector(this->storage, this->run_id, thread_id);
+
+	Maybe<Task> task = this->get_next_task(thread_id);
 	// TODO set the thread ID in the logger!
 
 	while (task.valid()) {
-		std::string file_name = task.value().first;
-		Instance * instance = nullptr;
-		try {
-			JsonReader reader(file_name);
-			instance = reader.parse();
-		} catch (json::parse_error e) {
-			BOOST_LOG(l.e()) << "JSON Parsing error in instance file.";
-			BOOST_LOG(l.e()) << "Problematic file: " << file_name;
-			BOOST_LOG(l.e()) << e.what();
-			BOOST_LOG(l.e()) << "Error is near: ";
+		{
+			// Released even if the task throws
+			MemoryReservation reservation(*this, task.value());
+
+			SolverConfig & solverConfig = task.value().config;
+			this->assign_seed(solverConfig);
+
+			this->process_task(thread_id, selector, task.value().file_name,
+			                   solverConfig);
+		}
 
-			util::FileContextGiver fcg(file_name, e.byte);
+		task = this->get_next_task(thread_id);
+	}
+}
+
+/*
+ * Process-isolated mode
+ */
 
-			for (const auto & line : fcg.get_message()) {
-				BOOST_LOG(l.e()) << line;
+static bool
+write_fully(int fd, const void * buf, size_t count)
+{
+	const char * ptr = static_cast<const char *>(buf);
+	while (count > 0) {
+		ssize_t written = write(fd, ptr, count);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
 			}
+			return false;
+		}
+		ptr += written;
+		count -= (size_t)written;
+	}
+	return true;
+}
 
-			// Or register error and continue with next instance?
-			throw std::move(e);
+static bool
+read_fully(int fd, void * buf, size_t count)
+{
+	char * ptr = static_cast<char *>(buf);
+	while (count > 0) {
+		ssize_t got = read(fd, ptr, count);
+		if (got < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		if (got == 0) {
+			return false; // EOF
 		}
+		ptr += got;
+		count -= (size_t)got;
+	}
+	return true;
+}
 
-		SolverConfig & solverConfig = task.value().second;
+/* Closes fd unless it is closed already, and marks it as closed. */
+static void
+close_fd(int & fd)
+{
+	if (fd >= 0) {
+		close(fd);
+		fd = -1;
+	}
+}
+
+void
+Parallelizer::spawn_worker(std::vector<Worker> & workers, int worker_id)
+{
+	int task_pipe[2];
+	int result_pipe[2];
+	if ((pipe(task_pipe) != 0) || (pipe(result_pipe) != 0)) {
+		BOOST_LOG(l.e()) << "Could not create pipes for worker " << worker_id
+		                 << ": " << strerror(errno);
+		throw std::runtime_error("pipe() failed");
+	}
 
-		BOOST_LOG(l.i()) << "====================================================";
-		BOOST_LOG(l.i()) << "Now processing: ";
-		BOOST_LOG(l.i()) << file_name;
-		BOOST_LOG(l.i()) << solverConfig.get_name();
-		BOOST_LOG(l.i()) << "====================================================";
-		BOOST_LOG(l.d(1)) << "Software version: " << std::string(GIT_SHA1);
+	// Make sure nothing buffered is written twice
+	std::cout << std::flush;
+	std::cerr << std::flush;
 
-		BOOST_LOG(l.d(2)) << " Config Settings: ";
-		for (auto & [k, v] : solverConfig.get_kvs()) {
-			BOOST_LOG(l.d(2)) << "   " << k << ": \t" << v;
+	pid_t pid = fork();
+	if (pid < 0) {
+		BOOST_LOG(l.e()) << "Could not fork worker " << worker_id << ": "
+		                 << strerror(errno);
+		throw std::runtime_error("fork() failed");
+	}
+
+	if (pid == 0) {
+		// Child: drop everything that belongs to other workers
+		for (const Worker & other : workers) {
+			if (other.task_fd >= 0) {
+				close(other.task_fd);
+			}
+			if (other.result_fd >= 0) {
+				close(other.result_fd);
+			}
 		}
+		close(task_pipe[1]);
+		close(result_pipe[0]);
+		this->run_worker(worker_id, task_pipe[0], result_pipe[1]);
+	}
+
+	close(task_pipe[0]);
+	close(result_pipe[1]);
+
+	Worker & w = workers[(size_t)worker_id];
+	w.pid = pid;
+	w.task_fd = task_pipe[1];
+	w.result_fd = result_pipe[0];
+	w.task = Maybe<Task>();
+	w.instance_id.clear();
+	w.solver_id.clear();
+
+	BOOST_LOG(l.d(1)) << "Forked worker " << worker_id << " as PID " << pid;
+}
+
+void
+Parallelizer::run_worker(int worker_id, int task_fd, int result_fd)
+{
+	int exit_code = EXIT_SUCCESS;
+	ResultMessage fault;
+	memset(&fault, 0, sizeof(fault));
+	fault.type = ResultMessage::TYPE_FAULT;
+
+	try {
+		this->serve_tasks(worker_id, task_fd, result_fd);
+	} catch (const std::bad_alloc & e) {
+		fault.fault_code = FAULT_OUT_OF_MEMORY;
+		strncpy(fault.error, e.what(), ResultMessage::ID_LENGTH - 1);
+		exit_code = EXIT_FAILURE;
+	} catch (const std::exception & e) {
+		fault.fault_code = FAULT_WORKER_EXCEPTION;
+		strncpy(fault.error, e.what(), ResultMessage::ID_LENGTH - 1);
+		exit_code = EXIT_FAILURE;
+	} catch (...) {
+		fault.fault_code = FAULT_WORKER_EXCEPTION;
+		strncpy(fault.error, "Unknown exception", ResultMessage::ID_LENGTH - 1);
+		exit_code = EXIT_FAILURE;
+	}
+
+	if (exit_code != EXIT_SUCCESS) {
+		BOOST_LOG(l.e()) << "Worker " << worker_id
+		                 << " caught an exception: " << fault.error;
+		write_fully(result_fd, &fault, sizeof(fault));
+	}
+
+	close(task_fd);
+	close(result_fd);
+
+	// Skip destructors and atexit handlers inherited from the parent
+	std::cout << std::flush;
+	std::cerr << std::flush;
+	_exit(exit_code);
+}
+
+void
+Parallelizer::serve_tasks(int worker_id, int task_fd, int result_fd)
+{
+	this->bind_to_node(worker_id);
+
+	// The parent's DB connection must not be used across fork()
+	Storage worker_storage(Configuration::get()->get_storage_path());
+	Selector selector(worker_storage, this->run_id, worker_id);
+
+	selector.set_start_callback(
+	    [&](const Instance & instance, const std::string & solver_id) {
+		    ResultMessage msg;
+		    memset(&msg, 0, sizeof(msg));
+		    msg.type = ResultMessage::TYPE_STARTED;
+		    strncpy(msg.instance_id, instance.get_id().c_str(),
+		            ResultMessage::ID_LENGTH - 1);
+		    strncpy(msg.solver_id, solver_id.c_str(), ResultMessage::ID_LENGTH - 1);
+		    write_fully(result_fd, &msg, sizeof(msg));
+	    });
+
+	TaskMessage task_msg;
+	while (read_fully(task_fd, &task_msg, sizeof(task_msg))) {
+		const auto & [file_name, base_config] =
+		    this->all_tasks[task_msg.task_index];
+		SolverConfig config = base_config;
+		config.override_seed(task_msg.seed);
+
+		this->process_task(worker_id, selector, file_name, config);
+
+		ResultMessage msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.type = ResultMessage::TYPE_FINISHED;
+		if (!write_fully(result_fd, &msg, sizeof(msg))) {
+			break;
+		}
+	}
+}
+
+void
+Parallelizer::record_worker_error(const Worker & w, int fault_code)
+{
+	if (!w.instance_id.empty()) {
+		this->storage.insert_error(w.instance_id, this->run_id, w.solver_id,
+		                           w.task.value().config.get_name(),
+		                           w.task.value().config.get_seed(), 0u,
+		                           fault_code);
+	} else {
+		BOOST_LOG(l.e()) << "Worker died before starting a solver. No error "
+		                    "can be recorded for "
+		                 << w.task.value().file_name;
+	}
+}
+
+void
+Parallelizer::handle_worker_exit(std::vector<Worker> & workers, int worker_id,
+                                 bool replace)
+{
+	Worker & w = workers[(size_t)worker_id];
 
-		BOOST_LOG(l.d(1)) << "====================================================";
+	int status = 0;
+	waitpid(w.pid, &status, 0);
+	close_fd(w.task_fd);
+	close_fd(w.result_fd);
+	w.pid = -1;
 
-		instance->compute_traits();
+	if (w.task.valid()) {
+		const Task & task = w.task.value();
 
-		Configuration & cfg = *Configuration::get();
-		if (cfg.get_instance_seed().valid()) {
-			solverConfig.override_seed(cfg.get_instance_seed().value());
+		// The kernel's OOM killer sends SIGKILL
+		int fault_code = FAULT_WORKER_CRASHED;
+		if (WIFSIGNALED(status)) {
+			BOOST_LOG(l.e()) << "Worker " << worker_id << " was killed by signal "
+			                 << WTERMSIG(status) << " while processing "
+			                 << task.file_name;
+			if (WTERMSIG(status) == SIGKILL) {
+				fault_code = FAULT_OUT_OF_MEMORY;
+			}
+		} else {
+			BOOST_LOG(l.e()) << "Worker " << worker_id << " exited with status "
+			                 << WEXITSTATUS(status) << " while processing "
+			                 << task.file_name;
 		}
-		if (!solverConfig.was_seed_set()) {
-			solverConfig.override_seed(this->randomizer.get_random());
+
+		this->record_worker_error(w, fault_code);
+		this->release_memory(task);
+		w.task = Maybe<Task>();
+	}
+
+	// Replace the worker if there is anything left to do
+	if (replace && (this->remaining_count > 0)) {
+		this->spawn_worker(workers, worker_id);
+	}
+}
+
+void
+Parallelizer::run_isolated(unsigned int worker_count)
+{
+	BOOST_LOG(l.i()) << "Running " << worker_count << " isolated worker processes";
+
+	// A dead worker must not take us down when we write to its pipe
+	signal(SIGPIPE, SIG_IGN);
+
+	std::vector<Worker> workers(worker_count);
+	for (unsigned int i = 0; i < worker_count; ++i) {
+		this->spawn_worker(workers, (int)i);
+	}
+
+	while (true) {
+		/*
+		 * Hand out tasks to idle workers
+		 */
+		size_t busy = 0;
+		for (unsigned int i = 0; i < worker_count; ++i) {
+			Worker & w = workers[i];
+			if (w.pid < 0) {
+				continue;
+			}
+
+			if (!w.task.valid()) {
+				Maybe<Task> task = this->try_next_task((int)i);
+
+				if (task.valid()) {
+					this->assign_seed(task.value().config);
+					TaskMessage msg{(uint32_t)task.value().index,
+					                (int32_t)task.value().config.get_seed()};
+					w.task = task;
+					w.instance_id.clear();
+					w.solver_id.clear();
+					if (!write_fully(w.task_fd, &msg, sizeof(msg))) {
+						// Died while idle - handled via poll() below
+						BOOST_LOG(l.w()) << "Could not send task to worker " << i;
+					}
+				} else if (this->remaining_count == 0) {
+					// Nothing left for this one. Closing the pipe ends it.
+					close_fd(w.task_fd);
+					this->handle_worker_exit(workers, (int)i, false);
+					continue;
+				}
+			}
+
+			if (w.task.valid()) {
+				busy++;
+			}
 		}
 
-		selector.run_all(*instance, solverConfig);
+		if (busy == 0) {
+			// With nothing running, every task fits the budget. Thus, we can only
+			// get here if we are done.
+			if (this->remaining_count > 0) {
+				BOOST_LOG(l.e()) << "No worker left, but " << this->remaining_count
+				                 << " tasks remaining!";
+			}
+			break;
+		}
 
-		// TODO FIXME re-add logging!
 		/*
-		if (log_dir != nullptr) {
-		    Log::remove_logger(file_log);
-		    delete file_log;
+		 * Wait for any busy worker to report back
+		 */
+		std::vector<struct pollfd> pfds;
+		std::vector<unsigned int> pfd_workers;
+		for (unsigned int i = 0; i < worker_count; ++i) {
+			if ((workers[i].pid >= 0) && workers[i].task.valid()) {
+				pfds.push_back({workers[i].result_fd, POLLIN, 0});
+				pfd_workers.push_back(i);
+			}
 		}
-		*/
 
-		delete instance;
+		if (poll(pfds.data(), pfds.size(), -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			BOOST_LOG(l.e()) << "poll() failed: " << strerror(errno);
+			throw std::runtime_error("poll() failed");
+		}
+
+		for (size_t j = 0; j < pfds.size(); ++j) {
+			if (pfds[j].revents == 0) {
+				continue;
+			}
 
-		task = this->get_next_task();
+			unsigned int i = pfd_workers[j];
+			Worker & w = workers[i];
+
+			ResultMessage msg;
+			if (!read_fully(w.result_fd, &msg, sizeof(msg))) {
+				// EOF: the worker is gone
+				this->handle_worker_exit(workers, (int)i, true);
+				continue;
+			}
+
+			if (msg.type == ResultMessage::TYPE_STARTED) {
+				w.instance_id = std::string(msg.instance_id);
+				w.solver_id = std::string(msg.solver_id);
+			} else if (msg.type == ResultMessage::TYPE_FINISHED) {
+				this->release_memory(w.task.value());
+				w.task = Maybe<Task>();
+			} else if (msg.type == ResultMessage::TYPE_FAULT) {
+				// The worker exits after sending this
+				msg.error[ResultMessage::ID_LENGTH - 1] = 0;
+				BOOST_LOG(l.e()) << "Worker " << i << " failed while processing "
+				                 << w.task.value().file_name << ": " << msg.error;
+				this->record_worker_error(w, msg.fault_code);
+				this->release_memory(w.task.value());
+				w.task = Maybe<Task>();
+				this->handle_worker_exit(workers, (int)i, true);
+			}
+		}
 	}
+
+	BOOST_LOG(l.i()) << "All worker processes finished";
 }
@@ -7,15 +7,25 @@
 
 #include "../datastructures/maybe.hpp" // for Maybe
 #include "../util/log.hpp"             // for Log
+#include "../util/solverconfig.hpp"    // for SolverConfig
 #include "timer.hpp"
+#include <atomic>                      // for atomic
+#include <condition_variable>          // for condition_variable
+#include <deque>                       // for deque
+#include <list>                        // for list
+#include <stdint.h>                    // for uint32_t
+#include <sys/types.h>                 // for pid_t
+#include <memory>                      // for unique_ptr
 #include <mutex>                       // for mutex
 #include <stddef.h>                    // for size_t
 #include <string>                      // for string
 #include <thread>                      // for thread
+#include <unordered_map>               // for unordered_map
 #include <utility>                     // for pair
 #include <vector>                      // for vector
+class Instance;
 class Randomizer;
-class SolverConfig;
+class Selector;
 class Storage;
 
 class Parallelizer {
@@ -26,16 +36,164 @@ public:
                        unsigned int thread_count);
 
 private:
+  struct Task
+  {
+    // Index into all_tasks
+    size_t index;
+    std::string file_name;
+    SolverConfig config;
+    // Estimated running time in seconds. Only used for ordering.
+    double estimated_cost;
+    // Estimated peak memory usage in bytes. Used for admission control.
+    size_t estimated_memory;
+  };
+
+  /* Every thread owns one of these. The owner takes tasks from the front
+   * (i.e., the most expensive one first), idle threads steal from the back. */
+  struct WorkerQueue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    double remaining_cost = 0;
+  };
+
   Storage & storage;
   std::string run_id;
   Randomizer & randomizer;
   size_t totalTasks;
+  std::atomic<size_t> remaining_count;
 
   void run_thread(int thread_id);
-  Maybe<std::pair<std::string, SolverConfig>> get_next_task();
+  void bind_to_node(int thread_id);
+  void assign_seed(SolverConfig & config);
+  void process_task(int thread_id, Selector & selector,
+                    const std::string & file_name, const SolverConfig & config);
+
+  /*
+   * NUMA placement. Thread i runs on node i % node_count. Every node keeps a
+   * small cache of instances that were parsed (and thus first-touched) by a
+   * thread running on that node, so that all configurations run on an
+   * instance can share one node-local copy. Tasks are distributed s.t. all
+   * tasks on the same instance prefer the same node.
+   */
+  class InstanceCache {
+  public:
+    explicit InstanceCache(size_t capacity);
+    std::shared_ptr<Instance> get(const std::string & file_name);
+    void put(const std::string & file_name, std::shared_ptr<Instance> instance);
+
+  private:
+    size_t capacity;
+    std::mutex mutex;
+    // Most recently used first
+    std::list<std::pair<std::string, std::shared_ptr<Instance>>> entries;
+  };
+
+  unsigned int node_count;
+  unsigned int get_node(int thread_id) const;
+  std::shared_ptr<Instance> get_instance(int thread_id,
+                                         const std::string & file_name);
+  Instance * parse_instance(const std::string & file_name);
+  std::vector<std::unique_ptr<InstanceCache>> instance_caches;
+
+  Maybe<Task> get_next_task(int thread_id);
+  Maybe<Task> try_next_task(int thread_id);
+  Maybe<Task> take_own_task(int thread_id);
+  Maybe<Task> steal_task(int thread_id);
+  void log_progress();
+
+  /* Admission control. A task is admitted if its estimated memory fits into
+   * the remaining budget, or if nothing else is running. admission_mutex only
+   * guards the budget. It is taken inside the queue mutexes, never the other
+   * way round, and not at all without a budget. */
+  bool fits_budget(const Task & task) const;
+  bool is_admissible(const Task & task);
+  bool try_reserve_memory(const Task & task);
+  void release_memory(const Task & task);
+  Maybe<size_t> memory_budget;
+  size_t memory_in_use;
+  // Bumped on every release, s.t. waiting threads do not miss one
+  size_t admission_generation;
+  std::mutex admission_mutex;
+  std::condition_variable admission_cv;
+
+  /* Gives the memory reserved for a task back to the budget when the task is
+   * done, however it ends. */
+  class MemoryReservation {
+  public:
+    MemoryReservation(Parallelizer & parallelizer, const Task & task);
+    ~MemoryReservation();
+    MemoryReservation(const MemoryReservation &) = delete;
+    MemoryReservation & operator=(const MemoryReservation &) = delete;
+
+  private:
+    Parallelizer & parallelizer;
+    const Task & task;
+  };
+
+  std::unordered_map<std::string, size_t>
+  get_file_sizes(const std::vector<Task> & tasks) const;
+  void estimate_costs(std::vector<Task> & tasks);
+  void estimate_memory(std::vector<Task> & tasks);
+  void distribute_tasks(std::vector<Task> & tasks, unsigned int thread_count);
+
+  /*
+   * Process-isolated mode. Workers are forked from this process and thus know
+   * all_tasks. The parent sends indices into all_tasks (with the seed to use)
+   * and receives a message when a solver starts and when a task is finished.
+   * Every worker writes its results through its own Storage connection. If a
+   * worker dies, the parent records an error for the task it was working on
+   * and forks a replacement.
+   */
+  struct TaskMessage
+  {
+    uint32_t task_index;
+    int32_t seed;
+  };
+
+  struct ResultMessage
+  {
+    constexpr static uint32_t TYPE_STARTED = 1;
+    constexpr static uint32_t TYPE_FINISHED = 2;
+    // The worker caught an exception and exits
+    constexpr static uint32_t TYPE_FAULT = 3;
+    constexpr static size_t ID_LENGTH = 256;
+
+    uint32_t type;
+    char instance_id[ID_LENGTH];
+    char solver_id[ID_LENGTH];
+    // Only for TYPE_FAULT
+    int32_t fault_code;
+    char error[ID_LENGTH];
+  };
+
+  struct Worker
+  {
+    pid_t pid = -1;
+    int task_fd = -1;
+    int result_fd = -1;
+    Maybe<Task> task;
+    // Set once the worker reported which solver runs on which instance
+    std::string instance_id;
+    std::string solver_id;
+  };
+
+  void run_isolated(unsigned int worker_count);
+  void spawn_worker(std::vector<Worker> & workers, int worker_id);
+  /* The worker's main function. Never returns and never throws: unwinding
+   * would continue through the frames the child inherited from the parent. */
+  [[noreturn]] void run_worker(int worker_id, int task_fd, int result_fd);
+  void serve_tasks(int worker_id, int task_fd, int result_fd);
+  /* Reaps the worker and closes its pipes. If it still had a task, an error
+   * is recorded for it. If replace is set and tasks are left, a new worker is
+   * forked in its place. */
+  void handle_worker_exit(std::vector<Worker> & workers, int worker_id,
+                          bool replace);
+  void record_worker_error(const Worker & w, int fault_code);
 
-  std::mutex queue_mutex;
-  std::vector<std::pair<std::string, SolverConfig>> remaining_tasks;
+  std::vector<std::pair<std::string, SolverConfig>> all_tasks;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues;
+  std::mutex log_mutex;
 
   std::vector<std::thread> threads;
 
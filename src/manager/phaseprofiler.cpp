@@ -0,0 +1,277 @@
+#include "phaseprofiler.hpp"
+
+#include "../db/storage.hpp" // for AdditionalResultStorage
+
+#if defined(__linux__)
+#include <linux/perf_event.h> // for perf_event_attr, PERF_*
+#include <sys/ioctl.h>        // for ioctl
+#include <sys/syscall.h>      // for SYS_perf_event_open
+#include <unistd.h>           // for syscall, read, close
+#endif
+
+#ifdef PAPI_FOUND
+#include "memoryinfo.hpp" // for PAPIPerformanceInfo
+#include <papi.h>
+#endif
+
+#include <cstring> // for memset
+#include <utility> // for move
+
+PhaseProfiler::PhaseProfiler(std::vector<std::string> phase_names_in)
+    : phase_names(std::move(phase_names_in)), enabled(false),
+      counters_open(false), cycles(this->phase_names.size(), 0),
+      counters(this->phase_names.size() * COUNTER_COUNT, 0),
+#ifdef PAPI_FOUND
+      papi_event_set(PAPI_NULL),
+#endif
+      enabled_cycles(0), l("PROFILER")
+{
+	for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+		this->counter_fds[c] = -1;
+	}
+}
+
+PhaseProfiler::PhaseProfiler(PhaseProfiler && other) noexcept
+    : phase_names(std::move(other.phase_names)), enabled(other.enabled),
+      counters_open(other.counters_open), cycles(std::move(other.cycles)),
+      counters(std::move(other.counters)),
+#ifdef PAPI_FOUND
+      papi_event_set(other.papi_event_set),
+#endif
+      enabled_cycles(other.enabled_cycles), enabled_time(other.enabled_time),
+      l(std::move(other.l))
+{
+	for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+		this->counter_fds[c] = other.counter_fds[c];
+		other.counter_fds[c] = -1;
+	}
+#ifdef PAPI_FOUND
+	other.papi_event_set = PAPI_NULL;
+#endif
+	other.counters_open = false;
+}
+
+PhaseProfiler::~PhaseProfiler()
+{
+#ifdef PAPI_FOUND
+	if (this->papi_event_set != PAPI_NULL) {
+		PAPI_stop(this->papi_event_set, nullptr);
+		PAPI_cleanup_eventset(this->papi_event_set);
+		PAPI_destroy_eventset(&this->papi_event_set);
+	}
+#endif
+#if defined(__linux__)
+	for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+		if (this->counter_fds[c] >= 0) {
+			close(this->counter_fds[c]);
+		}
+	}
+#endif
+}
+
+void
+PhaseProfiler::enable(bool with_counters)
+{
+	this->enabled = true;
+	this->enabled_cycles = read_cycles();
+	this->enabled_time = std::chrono::steady_clock::now();
+
+	if (!with_counters) {
+		return;
+	}
+
+#ifdef PAPI_FOUND
+	if (this->open_papi_counters()) {
+		this->counters_open = true;
+		return;
+	}
+	BOOST_LOG(l.d(1)) << "Could not start PAPI counters, trying perf_event.";
+#endif
+
+	if (this->open_perf_counters()) {
+		this->counters_open = true;
+	} else {
+		BOOST_LOG(l.w()) << "Could not open hardware counters, only counting "
+		                    "cycles. Check /proc/sys/kernel/perf_event_paranoid.";
+	}
+}
+
+#ifdef PAPI_FOUND
+bool
+PhaseProfiler::open_papi_counters() noexcept
+{
+	if (!manager::PAPIPerformanceInfo::initialize_library()) {
+		return false;
+	}
+	PAPI_register_thread();
+
+	int event_set = PAPI_NULL;
+	if (PAPI_create_eventset(&event_set) != PAPI_OK) {
+		return false;
+	}
+
+	// Count threads started later on, too
+	if (PAPI_assign_eventset_component(event_set, 0) == PAPI_OK) {
+		PAPI_option_t opt;
+		memset(&opt, 0, sizeof(opt));
+		opt.inherit.eventset = event_set;
+		opt.inherit.inherit = PAPI_INHERIT_ALL;
+		if (PAPI_set_opt(PAPI_INHERIT, &opt) != PAPI_OK) {
+			BOOST_LOG(l.w()) << "PAPI counters are not inherited by child threads. "
+			                    "Only the solver thread is counted.";
+		}
+	}
+
+	// Same order as Counter
+	int events[COUNTER_COUNT] = {PAPI_L3_TCM, PAPI_BR_MSP};
+	// Fails if PAPI counters already run on this thread, e.g. for the runner
+	if ((PAPI_add_events(event_set, events, COUNTER_COUNT) != PAPI_OK) ||
+	    (PAPI_start(event_set) != PAPI_OK)) {
+		PAPI_cleanup_eventset(event_set);
+		PAPI_destroy_eventset(&event_set);
+		return false;
+	}
+
+	this->papi_event_set = event_set;
+	return true;
+}
+#endif
+
+bool
+PhaseProfiler::open_perf_counters() noexcept
+{
+#if defined(__linux__)
+	const uint64_t configs[COUNTER_COUNT] = {PERF_COUNT_HW_CACHE_MISSES,
+	                                         PERF_COUNT_HW_BRANCH_MISSES};
+
+	for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = configs[c];
+		attr.disabled = (c == 0) ? 1 : 0;
+		// Threads started later on (e.g., propagation workers) are counted, too.
+		// Reading the group leader sums over them.
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP;
+
+		int group_fd = (c == 0) ? -1 : this->counter_fds[0];
+		// This thread, any CPU
+		this->counter_fds[c] =
+		    (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+
+		if (this->counter_fds[c] < 0) {
+			for (size_t opened = 0; opened < c; ++opened) {
+				close(this->counter_fds[opened]);
+				this->counter_fds[opened] = -1;
+			}
+			return false;
+		}
+	}
+
+	ioctl(this->counter_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(this->counter_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool
+PhaseProfiler::read_counters(Stamp & stamp) const noexcept
+{
+#ifdef PAPI_FOUND
+	if (this->papi_event_set != PAPI_NULL) {
+		long long values[COUNTER_COUNT];
+		if (PAPI_read(this->papi_event_set, values) != PAPI_OK) {
+			return false;
+		}
+		for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+			stamp.counters[c] = (uint64_t)values[c];
+		}
+		return true;
+	}
+#endif
+
+#if defined(__linux__)
+	// Layout of a PERF_FORMAT_GROUP read
+	struct
+	{
+		uint64_t nr;
+		uint64_t values[COUNTER_COUNT];
+	} group;
+
+	if (read(this->counter_fds[0], &group, sizeof(group)) !=
+	    (ssize_t)sizeof(group)) {
+		return false;
+	}
+	for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+		stamp.counters[c] = group.values[c];
+	}
+	return true;
+#else
+	(void)stamp;
+	return false;
+#endif
+}
+
+double
+PhaseProfiler::cycles_per_second() const noexcept
+{
+	double elapsed = std::chrono::duration<double>(
+	                     std::chrono::steady_clock::now() - this->enabled_time)
+	                     .count();
+	uint64_t elapsed_cycles = read_cycles() - this->enabled_cycles;
+	if ((elapsed <= 0) || (elapsed_cycles == 0)) {
+		return 1;
+	}
+	return (double)elapsed_cycles / elapsed;
+}
+
+double
+PhaseProfiler::get_seconds(size_t phase) const noexcept
+{
+	return (double)this->cycles[phase] / this->cycles_per_second();
+}
+
+void
+PhaseProfiler::write_measures(AdditionalResultStorage & additional) const
+{
+	if (!this->enabled) {
+		return;
+	}
+
+	double rate = this->cycles_per_second();
+	const char * counter_names[COUNTER_COUNT] = {"_CACHE_MISSES",
+	                                             "_BRANCH_MISSES"};
+
+	for (size_t phase = 0; phase < this->phase_names.size(); ++phase) {
+		const std::string & name = this->phase_names[phase];
+		additional.extended_measures.push_back(
+		    {name + "_TIME",
+		     {},
+		     {},
+		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
+		     {(double)this->cycles[phase] / rate}});
+		additional.extended_measures.push_back(
+		    {name + "_CYCLES",
+		     {},
+		     {},
+		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
+		     {(double)this->cycles[phase]}});
+
+		if (this->counters_open) {
+			for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+				additional.extended_measures.push_back(
+				    {name + counter_names[c],
+				     {},
+				     {},
+				     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
+				     {(double)this->counters[phase * COUNTER_COUNT + c]}});
+			}
+		}
+	}
+}
@@ -0,0 +1,159 @@
+#ifndef PHASEPROFILER_HPP
+#define PHASEPROFILER_HPP
+
+#include "generated_config.hpp"
+
+#include "../util/log.hpp" // for Log
+
+#include <chrono>  // for steady_clock
+#include <cstdint> // for uint64_t
+#include <string>  // for string
+#include <vector>  // for vector
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // for __rdtsc
+#endif
+
+class AdditionalResultStorage;
+
+/* Accumulates cycles and, optionally, hardware event counts for a fixed set
+ * of phases of an algorithm.
+ *
+ * Usage:
+ *    auto started = profiler.start();
+ *    ...
+ *    profiler.stop(PHASE_FOO, started);
+ *
+ * Phases may be nested or overlap, every phase is accumulated on its own. A
+ * disabled profiler costs one predictable branch per call.
+ *
+ * Cycles are read from the time stamp counter where available, and converted
+ * to seconds using the rate of the counter observed between enable() and
+ * write_measures(). Hardware counters (cache misses, branch misses) come from
+ * PAPI if it is available, and from Linux' perf_event interface otherwise
+ * (e.g., when PAPI is not compiled in or PAPI counters are already running
+ * on this thread). Either way, they are read with a single call per start() /
+ * stop(), so only turn them on when you need them.
+ *
+ * Counters are opened for the thread calling enable() and are inherited by
+ * threads it starts afterwards (e.g., a WorkerPool), so a phase's counts
+ * include what such threads did while the phase ran. Some kernels only report
+ * an inherited count once its thread has ended, the phases then miss it.
+ * Threads that existed before enable() are never counted. With PAPI, the
+ * profiler must be destroyed by the thread that enabled it.
+ */
+class PhaseProfiler {
+public:
+	enum Counter { CACHE_MISSES = 0, BRANCH_MISSES, COUNTER_COUNT };
+
+	struct Stamp
+	{
+		uint64_t cycles;
+		uint64_t counters[COUNTER_COUNT];
+		// Whether counters could be read
+		bool counted;
+	};
+
+	explicit PhaseProfiler(std::vector<std::string> phase_names);
+	~PhaseProfiler();
+
+	// The counter file descriptors can only have one owner
+	PhaseProfiler(const PhaseProfiler &) = delete;
+	PhaseProfiler & operator=(const PhaseProfiler &) = delete;
+	PhaseProfiler(PhaseProfiler && other) noexcept;
+
+	/* Starts profiling. If with_counters is set, tries to open the hardware
+	 * counters for the calling thread and falls back to cycles only (with a
+	 * warning) if that is not possible, e.g. due to perf_event_paranoid. */
+	void enable(bool with_counters);
+
+	bool
+	is_enabled() const noexcept
+	{
+		return this->enabled;
+	}
+
+	Stamp
+	start() const noexcept
+	{
+		Stamp stamp{};
+		if (__builtin_expect(this->enabled, false)) {
+			this->take(stamp);
+		}
+		return stamp;
+	}
+
+	void
+	stop(size_t phase, const Stamp & started) noexcept
+	{
+		if (__builtin_expect(this->enabled, false)) {
+			Stamp now{};
+			this->take(now);
+			this->cycles[phase] += now.cycles - started.cycles;
+			// A failed read leaves the counters at zero, skip the sample then
+			if (started.counted && now.counted) {
+				for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+					this->counters[phase * COUNTER_COUNT + c] +=
+					    now.counters[c] - started.counters[c];
+				}
+			}
+		}
+	}
+
+	double get_seconds(size_t phase) const noexcept;
+
+	/* Writes <PHASE>_TIME (seconds) and <PHASE>_CYCLES for every phase, plus
+	 * <PHASE>_CACHE_MISSES and <PHASE>_BRANCH_MISSES if counters were
+	 * recorded. */
+	void write_measures(AdditionalResultStorage & additional) const;
+
+private:
+	static uint64_t
+	read_cycles() noexcept
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		           std::chrono::steady_clock::now().time_since_epoch())
+		    .count();
+#endif
+	}
+
+	void
+	take(Stamp & stamp) const noexcept
+	{
+		if (this->counters_open) {
+			stamp.counted = this->read_counters(stamp);
+		}
+		stamp.cycles = read_cycles();
+	}
+
+	bool read_counters(Stamp & stamp) const noexcept;
+	bool open_perf_counters() noexcept;
+#ifdef PAPI_FOUND
+	bool open_papi_counters() noexcept;
+#endif
+	double cycles_per_second() const noexcept;
+
+	std::vector<std::string> phase_names;
+	bool enabled;
+	bool counters_open;
+	// The first counter leads the group, so that one read gets all of them
+	int counter_fds[COUNTER_COUNT];
+
+	std::vector<uint64_t> cycles;
+	// counters[phase * COUNTER_COUNT + counter]
+	std::vector<uint64_t> counters;
+#ifdef PAPI_FOUND
+	// PAPI_NULL if the perf_event counters are used
+	int papi_event_set;
+#endif
+
+	uint64_t enabled_cycles;
+	std::chrono::steady_clock::time_point enabled_time;
+
+	Log l;
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "runner.hpp"
 
+#include "checkpoint.hpp"
 #include "errors.hpp"
 #include "instance/solution.hpp"
 #include "instance/traits.hpp"
@@ -69,6 +70,7 @@ Runner<Solver>::run(const Instance & instance_in)
 
 	Solution sol; // Must be declared here s.t. it can be read in the exception
 	              // handler!
+	std::unique_ptr<manager::Checkpoint> checkpoint; // Same here
 
 	try {
 		if ((Configuration::get()->get_skip_done()) &&
@@ -86,53 +88,72 @@ Runner<Solver>::run(const Instance & instance_in)
 			return;
 		}
 
+		if constexpr (runner_detail::supports_checkpoint<Solver>::value) {
+			if (Configuration::get()->get_checkpoint_dir().valid()) {
+				checkpoint = this->make_checkpoint(instance, solver.get_id());
+				solver.set_checkpoint(checkpoint.get());
+			}
+		}
+
 		Timer t;
 
 		unsigned int meminfo_time = sconf.get_meminfo_sampling_time();
-		manager::LinuxMemoryInfo mem_info(meminfo_time);
+		// With multiple runs in parallel threads, only per-thread figures are
+		// meaningful. Isolated worker processes can be measured as a whole.
+		bool per_thread_metrics =
+		    (Configuration::get()->get_parallelism() > 1) &&
+		    !Configuration::get()->get_isolate_processes();
+		bool memory_metrics = sconf.are_memory_metrics_enabled();
+		bool papi_metrics = sconf.get_papi_metrics().size() > 0;
+		if constexpr (runner_detail::may_run_foreign_threads<Solver>::value) {
+			if (per_thread_metrics && solver.runs_foreign_threads() &&
+			    (memory_metrics || papi_metrics)) {
+				BOOST_LOG(l.w()) << "Cannot measure a solver that starts threads of "
+				                    "its own per thread. Not collecting memory and "
+				                    "PAPI metrics. Use --threads 1 or isolated "
+				                    "processes to measure it.";
+				memory_metrics = false;
+				papi_metrics = false;
+			}
+		}
+		manager::LinuxMemoryInfo mem_info(meminfo_time, per_thread_metrics);
 		manager::PAPIPerformanceInfo * papi_ptr = nullptr;
 
 #ifdef PAPI_FOUND
 		manager::PAPIPerformanceInfo papi_info(sconf.get_papi_metrics());
-		if (Configuration::get()->get_parallelism() <= 1) {
+		if (papi_metrics) {
 			papi_ptr = &papi_info;
 		}
 #endif
 
 		t.start();
-		if (sconf.are_memory_metrics_enabled()) {
-			if (Configuration::get()->get_parallelism() > 1) {
-				BOOST_LOG(l.w())
-				    << "Cannot collect memory statistics in parallel mode!";
-			} else {
-				mem_info.start();
-			}
+		if (memory_metrics) {
+			mem_info.start();
 		}
 
 #ifdef PAPI_FOUND
-		if (sconf.get_papi_metrics().size() > 0) {
-			if (Configuration::get()->get_parallelism() > 1) {
-				BOOST_LOG(l.w())
-				    << "Cannot collect PAPI measurements in parallel mode!";
-			} else {
-				papi_info.start();
-			}
+		if (papi_metrics) {
+			papi_info.start();
 		}
 #endif
 
 		solver.run();
 		sol = solver.get_solution();
 		double elapsed = t.stop();
+		if (checkpoint) {
+			// Count the time of the interrupted attempts, too
+			elapsed += checkpoint->get_previous_elapsed();
+		}
 
-		if (Configuration::get()->get_parallelism() <= 1) {
 #ifdef PAPI_FOUND
-			if (sconf.get_papi_metrics().size() > 0) {
-				papi_info.stop();
-			}
+		if (papi_metrics) {
+			papi_info.stop();
+		}
+#else
+		(void)papi_metrics;
 #endif
-			if (sconf.are_memory_metrics_enabled()) {
-				mem_info.stop();
-			}
+		if (memory_metrics) {
+			mem_info.stop();
 		}
 
 		BOOST_LOG(l.i()) << "Solution costs: " << sol.get_costs();
@@ -147,8 +168,7 @@ Runner<Solver>::run(const Instance & instance_in)
 
 		std::string solver_id = solver.get_id();
 		long unsigned int res_id;
-		if (sconf.are_memory_metrics_enabled() &&
-		    (sconf.get_papi_metrics().size() > 0)) {
+		if (memory_metrics) {
 			res_id = storage.insert(sol, this->run_id, solver_id, sconf.get_name(),
 			                        sconf.get_seed(), elapsed, sconf, aresults,
 			                        &mem_info, papi_ptr);
@@ -169,6 +189,10 @@ Runner<Solver>::run(const Instance & instance_in)
 			writer.write_to(filename);
 		}
 
+		if (checkpoint) {
+			checkpoint->discard();
+		}
+
 	} catch (const RuntimeError & exception) {
 		if ((Configuration::get()->get_result_dir().valid()) &&
 		    (sol.get_instance() != nullptr)) {
@@ -183,9 +207,36 @@ Runner<Solver>::run(const Instance & instance_in)
 			writer.write_to(filename);
 		}
 
+		// Resuming would most probably run into the same error
+		if (checkpoint) {
+			checkpoint->discard();
+		}
+
 		ErrorHandler handler(this->storage, solver.get_id(), this->run_id,
 		                     sconf.get_name(), &sconf);
 		handler.handle(exception);
 		return;
 	}
 }
+
+template <class Solver>
+std::unique_ptr<manager::Checkpoint>
+Runner<Solver>::make_checkpoint(const Instance & instance,
+                                const std::string & solver_id)
+{
+	// Everything that identifies this computation. A re-launch with the same
+	// run ID finds the checkpoint again.
+	std::string key = this->run_id + std::string("___") + instance.get_id() +
+	                  std::string("___") + solver_id + std::string("___") +
+	                  this->sconf.get_name() + std::string("___") +
+	                  std::to_string(this->sconf.get_seed());
+
+	auto checkpoint = std::make_unique<manager::Checkpoint>(
+	    Configuration::get()->get_checkpoint_dir().value(), key,
+	    Configuration::get()->get_checkpoint_interval());
+	if (checkpoint->can_resume()) {
+		BOOST_LOG(l.i()) << "Resuming from checkpoint "
+		                 << checkpoint->get_path();
+	}
+	return checkpoint;
+}
@@ -5,12 +5,54 @@
 #include "util/solverconfig.hpp"
 #include "db/storage.hpp"
 
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace manager {
+class Checkpoint;
+}
+
+namespace runner_detail {
+/* Whether the solver can save its state to and resume from a checkpoint,
+ * i.e., whether it offers set_checkpoint(manager::Checkpoint *). */
+template <class Solver, class = void>
+struct supports_checkpoint : std::false_type
+{
+};
+
+template <class Solver>
+struct supports_checkpoint<
+    Solver, std::void_t<decltype(std::declval<Solver &>().set_checkpoint(
+                std::declval<manager::Checkpoint *>()))>> : std::true_type
+{
+};
+
+/* Whether the solver may start threads that per-thread measurements can not
+ * count, i.e., whether it offers bool runs_foreign_threads() const. */
+template <class Solver, class = void>
+struct may_run_foreign_threads : std::false_type
+{
+};
+
+template <class Solver>
+struct may_run_foreign_threads<
+    Solver, std::void_t<decltype(
+                std::declval<const Solver &>().runs_foreign_threads())>>
+    : std::true_type
+{
+};
+} // namespace runner_detail
+
 template <class Solver>
 class Runner {
 public:
   Runner(Storage &storage, std::string run_id, const SolverConfig & sconf);
   void run(const Instance &instance);
 private:
+  std::unique_ptr<manager::Checkpoint> make_checkpoint(const Instance &instance,
+                                                       const std::string &solver_id);
+
   Storage &storage;
   const SolverConfig & sconf;
   std::string run_id;
@@ -10,6 +10,12 @@ Selector::Selector(Storage & storage_in, std::string run_id_in,
       l("SELECTOR")
 {}
 
+void
+Selector::set_start_callback(StartCallback cb)
+{
+	this->start_callback = cb;
+}
+
 void
 Selector::run_all(const Instance & instance, const SolverConfig & solver_cfg)
 {
@@ -38,6 +44,10 @@ Selector::run_all(const Instance & instance, const SolverConfig & solver_cfg)
 
 				BOOST_LOG(l.d()) << ":::: Instance seed: " << solver_cfg.get_seed();
 
+				if (this->start_callback) {
+					this->start_callback(instance, decltype(solver_cls)::type::get_id());
+				}
+
 				runner.run(instance);
 			} catch (std::bad_alloc & ba) {
 				// We can't do anything here that requires more memory,
@@ -11,6 +11,8 @@
 #include "../util/solverconfig.hpp"
 #include "runner.hpp"
 
+#include <functional>
+
 #include <boost/hana.hpp>
 #include <boost/hana/assert.hpp>
 #include <boost/hana/core/to.hpp>
@@ -25,10 +27,16 @@ public:
   inline void run_all(const Instance & instance,
                       const SolverConfig & solver_cfg);
 
+	// Called right before a matching solver is run, with the solver's ID
+	using StartCallback =
+	    std::function<void(const Instance &, const std::string &)>;
+	inline void set_start_callback(StartCallback cb);
+
 private:
   Storage & storage;
   std::string run_id;
 	int thread_id;
+	StartCallback start_callback;
 	
   Log l;
 };
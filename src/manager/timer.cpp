@@ -7,6 +7,14 @@ Timer::start()
   this->started = std::chrono::steady_clock::now();
 }
 
+void
+Timer::start_at(double elapsed)
+{
+  this->started = std::chrono::steady_clock::now() -
+                  std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>(elapsed));
+}
+
 // TODO should this actually 'stop' somehow?
 double
 Timer::stop()
@@ -6,6 +6,8 @@
 class Timer {
 public:
   void start();
+  // Starts as if the timer had been started <elapsed> seconds ago
+  void start_at(double elapsed);
   double stop();
   double get() const;
 
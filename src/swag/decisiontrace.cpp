@@ -0,0 +1,66 @@
+#include "decisiontrace.hpp"
+
+#include <fstream> // for ifstream, ofstream
+
+namespace swag {
+
+DecisionTrace::DecisionTrace() : replay_pos(0) {}
+
+bool
+DecisionTrace::load(const std::string & filename)
+{
+	std::ifstream in_stream(filename);
+	if (!in_stream.is_open()) {
+		return false;
+	}
+
+	this->events.clear();
+	this->replay_pos = 0;
+
+	Event ev;
+	char kind;
+	while (in_stream >> ev.iteration >> kind >> ev.a >> ev.b) {
+		switch (kind) {
+		case (char)Kind::EDGE:
+		case (char)Kind::DELETION:
+		case (char)Kind::RESET:
+		case (char)Kind::END:
+			ev.kind = (Kind)kind;
+			break;
+		default:
+			return false;
+		}
+		this->events.push_back(ev);
+	}
+
+	// Must have read everything and be properly terminated
+	return in_stream.eof() && !this->events.empty() &&
+	       (this->events.back().kind == Kind::END);
+}
+
+bool
+DecisionTrace::save(const std::string & filename) const
+{
+	std::ofstream out_stream(filename);
+	if (!out_stream.is_open()) {
+		return false;
+	}
+
+	for (const Event & ev : this->events) {
+		out_stream << ev.iteration << " " << (char)ev.kind << " " << ev.a << " "
+		           << ev.b << "\n";
+	}
+
+	return out_stream.good();
+}
+
+size_t
+DecisionTrace::get_iteration_count() const noexcept
+{
+	if (this->events.empty() || (this->events.back().kind != Kind::END)) {
+		return 0;
+	}
+	return this->events.back().iteration;
+}
+
+} // namespace swag
@@ -0,0 +1,93 @@
+#ifndef DECISIONTRACE_HPP
+#define DECISIONTRACE_HPP
+
+#include <cstddef> // for size_t
+#include <string>  // for string
+#include <vector>  // for vector
+
+namespace swag {
+
+/* The sequence of decisions a SWAG run made, for replaying the exact same
+ * work later on.
+ *
+ * The only free decision SWAG makes is which candidate edge it tries to
+ * insert next. Deletions and resets follow deterministically from that, and
+ * are recorded as checkpoints that the replay verifies. Events are kept in
+ * memory while recording, so that the file I/O does not show up in the
+ * measured times.
+ *
+ * The file format is plain text, one event per line:
+ *    <iteration> <kind> <a> <b>
+ * where kind is one of the characters of Kind. The trace is terminated by an
+ * END event carrying the total number of iterations.
+ */
+class DecisionTrace {
+public:
+	enum class Kind : char {
+		EDGE = 'E',     // a = s, b = t of the edge that was tried
+		DELETION = 'D', // a = s, b = t of the job pair that caused it
+		RESET = 'R',
+		END = 'X'
+	};
+
+	struct Event
+	{
+		size_t iteration;
+		Kind kind;
+		unsigned int a;
+		unsigned int b;
+
+		bool
+		operator==(const Event & other) const noexcept
+		{
+			return (this->iteration == other.iteration) &&
+			       (this->kind == other.kind) && (this->a == other.a) &&
+			       (this->b == other.b);
+		}
+	};
+
+	DecisionTrace();
+
+	void
+	record(size_t iteration, Kind kind, unsigned int a, unsigned int b)
+	{
+		this->events.push_back({iteration, kind, a, b});
+	}
+
+	/* Both return false on I/O errors or malformed input. */
+	bool load(const std::string & filename);
+	bool save(const std::string & filename) const;
+
+	/* Replay cursor. Returns nullptr once the trace is exhausted. */
+	const Event *
+	peek() const noexcept
+	{
+		if (this->replay_pos >= this->events.size()) {
+			return nullptr;
+		}
+		return &this->events[this->replay_pos];
+	}
+
+	void
+	advance() noexcept
+	{
+		this->replay_pos++;
+	}
+
+	/* Number of iterations of the recorded run, taken from the END event. */
+	size_t get_iteration_count() const noexcept;
+
+	size_t
+	size() const noexcept
+	{
+		return this->events.size();
+	}
+
+private:
+	std::vector<Event> events;
+	size_t replay_pos;
+};
+
+} // namespace swag
+
+#endif
@@ -1,9 +1,12 @@
 #include "elitepoolscorer.hpp"
 
 #include "../instance/instance.hpp"
+#include "../manager/checkpoint.hpp"
 #include "../util/solverconfig.hpp"
 #include "swag.hpp"
 
+#include <algorithm> // for min, max
+
 namespace swag {
 using namespace detail;
 
@@ -34,11 +37,11 @@ ElitePoolScorer::ElitePoolScorer(const Instance & instance_in,
 		this->sigmoid_coefficient = sconf["sigmoid_coefficient"].get<double>();
 	}
 
-	this->pool_start_times.resize(instance.job_count(),
-	                              std::vector<unsigned int>(this->pool_size));
+	this->pool_start_times.resize(instance.job_count() * this->pool_size, 0);
 	this->scores.resize(this->pool_size);
-	this->cache.resize(instance.job_count(),
-	                   std::vector<CacheEntry>(instance.job_count(), {0, 0}));
+	if (instance.job_count() > 1) {
+		this->cache.resize(cache_index(0, instance.job_count()), {0, 0, 0});
+	}
 
 	this->durations.resize(instance.job_count());
 	for (unsigned int jid = 0; jid < instance.job_count(); ++jid) {
@@ -54,29 +57,50 @@ ElitePoolScorer::get_score_for(size_t s, size_t t) const noexcept
 		return 1.0;
 	}
 
-	if (this->cache[s][t].generation != this->current_generation) {
-		this->update_cache(s, t);
+	if (s == t) {
+		return (double)this->count_orders(s, t).first / (double)this->pool_size;
+	}
+
+	size_t index = (s < t) ? cache_index(s, t) : cache_index(t, s);
+	if (this->cache[index].generation != this->current_generation) {
+		this->update_cache(std::min(s, t), std::max(s, t));
 	}
 
-	return (double)this->cache[s][t].i_before_j_count / (double)this->pool_size;
+	const CacheEntry & entry = this->cache[index];
+	uint32_t count = (s < t) ? entry.s_before_t_count : entry.t_before_s_count;
+	return (double)count / (double)this->pool_size;
 }
 
-void
-ElitePoolScorer::update_cache(size_t s, size_t t) const
+std::pair<uint32_t, uint32_t>
+ElitePoolScorer::count_orders(size_t s, size_t t) const noexcept
 {
-	// TODO also update backward edge
-
-	// TODO make sure that SIMD is used here
-	size_t count = 0;
+	const unsigned int * __restrict s_starts =
+	    &this->pool_start_times[s * this->pool_size];
+	const unsigned int * __restrict t_starts =
+	    &this->pool_start_times[t * this->pool_size];
+	const unsigned int s_duration = this->durations[s];
+	const unsigned int t_duration = this->durations[t];
+
+	// Branch-free, so that the compiler can vectorize this
+	uint32_t s_before_t = 0;
+	uint32_t t_before_s = 0;
 	for (size_t i = 0; i < this->pool_size; ++i) {
-		if (this->pool_start_times[s][i] + this->durations[s] <=
-		    this->pool_start_times[t][i]) {
-			count++;
-		}
+		s_before_t += (s_starts[i] + s_duration <= t_starts[i]);
+		t_before_s += (t_starts[i] + t_duration <= s_starts[i]);
 	}
 
-	this->cache[s][t].i_before_j_count = count;
-	this->cache[s][t].generation = this->current_generation;
+	return {s_before_t, t_before_s};
+}
+
+void
+ElitePoolScorer::update_cache(size_t s, size_t t) const noexcept
+{
+	auto counts = this->count_orders(s, t);
+
+	CacheEntry & entry = this->cache[cache_index(s, t)];
+	entry.s_before_t_count = counts.first;
+	entry.t_before_s_count = counts.second;
+	entry.generation = this->current_generation;
 }
 
 void
@@ -161,7 +185,7 @@ ElitePoolScorer::replace_elite_pool(
     size_t index, double quality, const std::vector<unsigned int> & start_times)
 {
 	for (unsigned int jid = 0; jid < this->instance.job_count(); ++jid) {
-		this->pool_start_times[jid][index] = start_times[jid];
+		this->pool_start_times[jid * this->pool_size + index] = start_times[jid];
 	}
 	this->scores[index] = quality;
 	if (quality < this->best_score) {
@@ -169,6 +193,53 @@ ElitePoolScorer::replace_elite_pool(
 	}
 
 	this->current_generation++;
+	if (this->current_generation == 0) {
+		// Wrapped around, old entries could look current
+		for (CacheEntry & entry : this->cache) {
+			entry.generation = 0;
+		}
+		this->current_generation = 1;
+	}
+}
+
+void
+ElitePoolScorer::save(manager::CheckpointWriter & out) const
+{
+	out.write((uint64_t)this->solutions_seen);
+	out.write(this->rng);
+	out.write(this->pool_start_times);
+	out.write(this->scores);
+	out.write(this->best_score);
+	out.write((uint64_t)this->num_replaced);
+}
+
+void
+ElitePoolScorer::load(manager::CheckpointReader & in)
+{
+	uint64_t stored_solutions_seen = 0;
+	uint64_t stored_num_replaced = 0;
+
+	in.read(stored_solutions_seen);
+	in.read(this->rng);
+	in.read(this->pool_start_times);
+	in.read(this->scores);
+	in.read(this->best_score);
+	in.read(stored_num_replaced);
+
+	this->solutions_seen = (size_t)stored_solutions_seen;
+	this->num_replaced = (size_t)stored_num_replaced;
+
+	if ((this->pool_start_times.size() !=
+	     this->instance.job_count() * this->pool_size) ||
+	    (this->scores.size() != this->pool_size)) {
+		in.fail();
+	}
+
+	// The cache is not saved, invalidate all of it
+	for (CacheEntry & entry : this->cache) {
+		entry.generation = 0;
+	}
+	this->current_generation = 1;
 }
 
 } // namespace swag
@@ -4,7 +4,9 @@
 #include "../util/log.hpp"
 #include <boost/container/flat_set.hpp>
 #include <cstddef>
+#include <cstdint> // for uint32_t
 #include <random>
+#include <utility> // for pair
 #include <vector>
 
 // Forwards
@@ -15,6 +17,10 @@ namespace detail {
 class Edge;
 }
 } // namespace swag
+namespace manager {
+class CheckpointWriter;
+class CheckpointReader;
+} // namespace manager
 
 namespace swag {
 
@@ -28,6 +34,10 @@ public:
 	    const std::vector<std::vector<detail::Edge>> & adjacency_list);
 	void iteration(size_t iteration) noexcept;
 
+	/* The learned scores, for checkpointing */
+	void save(manager::CheckpointWriter & out) const;
+	void load(manager::CheckpointReader & in);
+
 private:
 	constexpr static double EPS_DOUBLE_DELTA = 0.0000001;
 
@@ -45,27 +55,39 @@ private:
 
 	std::mt19937 rng; // TODO initialize!
 
-	// start_times[jid][i] is the start time of job <jid> in the elite
-	// solution nr. <i>
-	// TODO make this one large vector, for better SIMDing
-	std::vector<std::vector<unsigned int>> pool_start_times;
+	// pool_start_times[jid * pool_size + i] is the start time of job <jid> in
+	// the elite solution nr. <i>. The pool of a job is contiguous, so that
+	// comparing two jobs across the pool vectorizes.
+	std::vector<unsigned int> pool_start_times;
 
 	// scores[i] is the quality of elite solution nr <i>
 	std::vector<double> scores;
 	double best_score;
 
-	// TODO make this a half-matrix
+	/* One entry per unordered pair {s, t} with s < t, stored as lower
+	 * triangle, see cache_index(). Both directions are computed in the same
+	 * pass over the pool. */
 	struct CacheEntry
 	{
-		size_t i_before_j_count; // TODO this should be the computed double
-		size_t generation;
+		uint32_t s_before_t_count;
+		uint32_t t_before_s_count;
+		uint32_t generation;
 	};
 
-	mutable std::vector<std::vector<CacheEntry>> cache;
-
-	void update_cache(size_t s, size_t t) const;
+	mutable std::vector<CacheEntry> cache;
 
-	size_t current_generation;
+	static size_t
+	cache_index(size_t s, size_t t) noexcept
+	{
+		// s < t
+		return t * (t - 1) / 2 + s;
+	}
+	// Returns how often s ends before t starts in the pool, and vice versa
+	std::pair<uint32_t, uint32_t> count_orders(size_t s, size_t t) const
+	    noexcept;
+	void update_cache(size_t s, size_t t) const noexcept;
+
+	uint32_t current_generation;
 
 	// This is just here for faster iteration
 	std::vector<unsigned int> durations;
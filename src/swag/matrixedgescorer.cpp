@@ -1,6 +1,7 @@
 #include "matrixedgescorer.hpp"
 
 #include "../instance/instance.hpp"
+#include "../manager/checkpoint.hpp"
 #include "../util/solverconfig.hpp"
 #include "swag.hpp"
 
@@ -11,11 +12,17 @@ MatrixEdgeScorer::MatrixEdgeScorer(const Instance & instance_in,
                                    const SolverConfig & sconf) noexcept
     : instance(instance_in), score_window_size(10),
       score_window_fraction_threshold(0.5), score_exponent(2),
-      use_score_a(true), aging_interval(0), age_period(1),
-      score_matrix_a(instance_in.job_count() * instance_in.job_count(), {0, 0}),
-      score_matrix_b(instance_in.job_count() * instance_in.job_count(), {0, 0}),
-      last_scores(score_window_size, 0), last_scores_offset(0)
+      use_score_a(true), aging_interval(0), age_period(1), pruned_period(1),
+      score_count(0), score_shift(64), last_scores(score_window_size, 0),
+      last_scores_offset(0)
 {
+	// Room for a few edges per job before the first resize
+	size_t capacity = 16;
+	while (capacity < 4 * instance_in.job_count()) {
+		capacity *= 2;
+	}
+	this->rebuild(capacity, false);
+
 	if (sconf.has_config("score_window_size")) {
 		this->score_window_size = (size_t)sconf["score_window_size"];
 		last_scores.resize(score_window_size, 0);
@@ -35,24 +42,85 @@ MatrixEdgeScorer::MatrixEdgeScorer(const Instance & instance_in,
 	}
 }
 
+size_t
+MatrixEdgeScorer::find_slot(uint64_t key) const noexcept
+{
+	// Fibonacci hashing, the upper bits are the best mixed ones
+	size_t mask = this->scores.size() - 1;
+	size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >>
+	                                  this->score_shift);
+	while ((this->scores[slot].key != key) &&
+	       (this->scores[slot].key != EMPTY_KEY)) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+MatrixEdgeScorer::ScoreEntry &
+MatrixEdgeScorer::get_entry(uint64_t key)
+{
+	size_t slot = this->find_slot(key);
+	if (this->scores[slot].key == key) {
+		return this->scores[slot];
+	}
+
+	// Keep the load factor below 1/2
+	if (2 * (this->score_count + 1) > this->scores.size()) {
+		this->rebuild(2 * this->scores.size(), false);
+		slot = this->find_slot(key);
+	}
+
+	this->scores[slot] = {key, 0, 0, 0, 0};
+	this->score_count++;
+	return this->scores[slot];
+}
+
+void
+MatrixEdgeScorer::rebuild(size_t capacity, bool drop_stale)
+{
+	std::vector<ScoreEntry> old_scores;
+	old_scores.swap(this->scores);
+	this->scores.assign(capacity, {EMPTY_KEY, 0, 0, 0, 0});
+	this->score_count = 0;
+
+	this->score_shift = 64;
+	for (size_t c = capacity; c > 1; c /= 2) {
+		this->score_shift--;
+	}
+
+	for (const ScoreEntry & entry : old_scores) {
+		if (entry.key == EMPTY_KEY) {
+			continue;
+		}
+		if (drop_stale && (entry.age_a + 1 < this->age_period) &&
+		    (entry.age_b + 1 < this->age_period)) {
+			continue;
+		}
+		this->scores[this->find_slot(entry.key)] = entry;
+		this->score_count++;
+	}
+}
+
 double
 MatrixEdgeScorer::get_score_for(size_t s, size_t t) const noexcept
 {
+	const ScoreEntry & entry = this->scores[this->find_slot(make_key(s, t))];
+	bool found = (entry.key != EMPTY_KEY);
+
 	if (this->aging_interval == 0) {
-		return this->score_matrix_a[s * this->instance.job_count() + t].second;
+		return found ? entry.score_a : 0.0;
 	}
 
 	double score = 1.0;
+	if (!found) {
+		return score;
+	}
 
-	const auto & entry_a =
-	    this->score_matrix_a[s * this->instance.job_count() + t];
-	if (entry_a.first >= this->age_period - 1) {
-		score += entry_a.second;
+	if (entry.age_a >= this->age_period - 1) {
+		score += entry.score_a;
 	}
-	const auto & entry_b =
-	    this->score_matrix_b[s * this->instance.job_count() + t];
-	if (entry_b.first >= this->age_period - 1) {
-		score += entry_b.second;
+	if (entry.age_b >= this->age_period - 1) {
+		score += entry.score_b;
 	}
 
 	return score;
@@ -70,23 +138,22 @@ MatrixEdgeScorer::iteration(size_t iteration_count) noexcept
 
 void
 MatrixEdgeScorer::adjust_score_for(unsigned int s, unsigned int t,
-                                   double delta) noexcept
+                                   double delta)
 {
+	ScoreEntry & entry = this->get_entry(make_key(s, t));
 	if (this->use_score_a) {
-		auto & entry = this->score_matrix_a[s * this->instance.job_count() + t];
-		if (entry.first != this->age_period) {
-			entry.first = this->age_period;
-			entry.second = delta;
+		if (entry.age_a != this->age_period) {
+			entry.age_a = this->age_period;
+			entry.score_a = delta;
 		} else {
-			entry.second += delta;
+			entry.score_a += delta;
 		}
 	} else {
-		auto & entry = this->score_matrix_b[s * this->instance.job_count() + t];
-		if (entry.first != this->age_period) {
-			entry.first = this->age_period;
-			entry.second = delta;
+		if (entry.age_b != this->age_period) {
+			entry.age_b = this->age_period;
+			entry.score_b = delta;
 		} else {
-			entry.second += delta;
+			entry.score_b += delta;
 		}
 	}
 }
@@ -117,6 +184,12 @@ MatrixEdgeScorer::incorporate_result(
 	this->last_scores_offset++;
 	this->last_scores_offset %= this->score_window_size;
 
+	// A new period has begun, forget what has aged out
+	if (this->pruned_period != this->age_period) {
+		this->pruned_period = this->age_period;
+		this->rebuild(this->scores.size(), true);
+	}
+
 	for (size_t s = 0; s < this->instance.job_count(); ++s) {
 		for (auto & edge : adjacency_list[s]) {
 			if (!edge.is_permanent()) {
@@ -126,4 +199,44 @@ MatrixEdgeScorer::incorporate_result(
 	}
 }
 
+void
+MatrixEdgeScorer::save(manager::CheckpointWriter & out) const
+{
+	out.write(this->use_score_a);
+	out.write(this->age_period);
+	out.write(this->pruned_period);
+	out.write(this->scores);
+	out.write((uint64_t)this->score_count);
+	out.write(this->score_shift);
+	out.write(this->last_scores);
+	out.write((uint64_t)this->last_scores_offset);
+}
+
+void
+MatrixEdgeScorer::load(manager::CheckpointReader & in)
+{
+	uint64_t stored_score_count = 0;
+	uint64_t stored_offset = 0;
+
+	in.read(this->use_score_a);
+	in.read(this->age_period);
+	in.read(this->pruned_period);
+	in.read(this->scores);
+	in.read(stored_score_count);
+	in.read(this->score_shift);
+	in.read(this->last_scores);
+	in.read(stored_offset);
+
+	this->score_count = (size_t)stored_score_count;
+	this->last_scores_offset = (size_t)stored_offset;
+
+	// The table must be a power of two, the window must match the config
+	bool consistent = !this->scores.empty() &&
+	                  ((this->scores.size() & (this->scores.size() - 1)) == 0) &&
+	                  (this->last_scores.size() == this->score_window_size);
+	if (!consistent) {
+		in.fail();
+	}
+}
+
 } // namespace swag
@@ -2,6 +2,8 @@
 #define MATRIXEDGESCORER_HPP
 
 #include <cstddef>
+#include <cstdint> // for uint64_t
+#include <limits>  // for numeric_limits
 #include <vector>
 
 // Forwards
@@ -12,6 +14,10 @@ namespace detail {
 class Edge;
 }
 } // namespace swag
+namespace manager {
+class CheckpointWriter;
+class CheckpointReader;
+} // namespace manager
 
 namespace swag {
 
@@ -26,6 +32,10 @@ public:
 	    const std::vector<std::vector<detail::Edge>> & adjacency_list);
 	void iteration(size_t iteration) noexcept;
 
+	/* The learned scores, for checkpointing */
+	void save(manager::CheckpointWriter & out) const;
+	void load(manager::CheckpointReader & in);
+
 private:
 	const Instance & instance;
 
@@ -36,10 +46,37 @@ private:
 	bool use_score_a;
 	unsigned int aging_interval;
 	unsigned int age_period;
-	std::vector<std::pair<unsigned int, double>> score_matrix_a;
-	std::vector<std::pair<unsigned int, double>> score_matrix_b;
+	unsigned int pruned_period;
+
+	/* Only edges that have been part of a solution ever get a score, so the
+	 * scores are kept in an open-addressing hash table (linear probing,
+	 * power-of-two capacity) keyed by (s, t). Edges not in the table have a
+	 * score of zero in both periods. Entries that are older than the previous
+	 * period are equivalent to that and are dropped whenever a period ends. */
+	struct ScoreEntry
+	{
+		uint64_t key;
+		double score_a;
+		double score_b;
+		unsigned int age_a;
+		unsigned int age_b;
+	};
+	static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+	std::vector<ScoreEntry> scores;
+	size_t score_count;
+	unsigned int score_shift;
+
+	static uint64_t
+	make_key(size_t s, size_t t) noexcept
+	{
+		return (static_cast<uint64_t>(s) << 32) | static_cast<uint64_t>(t);
+	}
+	size_t find_slot(uint64_t key) const noexcept;
+	ScoreEntry & get_entry(uint64_t key);
+	void rebuild(size_t capacity, bool drop_stale);
 
-	void adjust_score_for(unsigned int s, unsigned int t, double delta) noexcept;
+	void adjust_score_for(unsigned int s, unsigned int t, double delta);
 
 	std::vector<double> last_scores;
 	size_t last_scores_offset;
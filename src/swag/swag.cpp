@@ -10,17 +10,24 @@
 #include "../instance/resource.hpp"
 #include "../instance/solution.hpp"
 #include "../instance/traits.hpp"
+#include "../manager/checkpoint.hpp"
 #include "../manager/errors.hpp"
+#include "../manager/incumbentexchange.hpp"
 #include "../manager/timer.hpp"
+#include "../util/configuration.hpp"
 #include "../util/fault_codes.hpp"
 #include "../util/log.hpp" // for Log
 #include "../util/solverconfig.hpp"
 #include <algorithm>
+#include <atomic>
 #include <boost/container/vector.hpp>
 #include <cassert>
 #include <cmath>
 #include <ext/alloc_traits.h>
 #include <limits>
+#if defined(__AVX2__)
+#include <immintrin.h> // for _mm256_*
+#endif
 #include <memory>
 
 namespace swag {
@@ -31,12 +38,16 @@ SWAGSolver<use_mes, use_eps>::SWAGSolver(
     const Instance & instance_in, AdditionalResultStorage & additional_in,
     const SolverConfig & sconf_in)
     : instance(instance_in), sconf(sconf_in), additional(additional_in),
-      disaggregate_time(false), intermediate_interval(0),
+      disaggregate_time(false), profile_counters(false),
+      intermediate_interval(0),
       intermediate_score_interval(0), deletion_trials(30),
       deletion_max_depth(6), deletions_before_reset(30),
       force_complete_push_after(50), force_range_check_after(0),
       randomize_edge_candidates(false), edge_candidate_batchsize(0),
-      deletion_undermove_penalty(3), last_complete_push(0), last_range_check(0),
+      deletion_undermove_penalty(3), iteration_limit(0),
+      parallel_propagation_threshold(4096), propagation_threads(1),
+      replaying(false),
+      replay_diverged(false), last_complete_push(0), last_range_check(0),
       adjacency_list(instance_in.job_count()),
       rev_adjacency_list(instance_in.job_count()),
       rsl((instance.resource_count() > 1)
@@ -45,12 +56,14 @@ SWAGSolver<use_mes, use_eps>::SWAGSolver(
       earliest_starts(instance_in.job_count()),
       latest_finishs(instance_in.job_count()),
       best_score(std::numeric_limits<double>::max()),
-      best_start_times(instance_in.job_count(), 0),
+      best_start_times(instance_in.job_count(), 0), exchange(nullptr),
+      exchange_version(0), checkpoint(nullptr),
       rnd((unsigned long)sconf.get_seed()), mes(instance_in, sconf_in),
       eps(instance_in, sconf_in), insertion_count(0), solution_count(0),
-      deletion_count(0), reset_count(0), skyline_update_time(0),
-      propagate_time(0), reset_time(0), job_selection_time(0),
-      edge_selection_time(0), unstick_time(0), last_log_time(0),
+      deletion_count(0), reset_count(0),
+      profiler({"SKYLINE_UPDATE", "PROPAGATE", "RESET", "JOB_SELECTION",
+                "EDGE_SELECTION", "UNSTICK", "DELETION_PROPAGATE"}),
+      last_log_time(0),
       last_log_iteration(0), intermediate_score_last_time(0),
       intermediate_score_number(0), job_count(instance.job_count()),
       node_moved_buf(job_count, false),
@@ -61,18 +74,59 @@ SWAGSolver<use_mes, use_eps>::SWAGSolver(
       edgedel_vertex_seen(instance.job_count(), false),
       edgedel_current_value(instance.job_count()), l("E-INS")
 {
-	if (!this->sconf.get_time_limit().valid()) {
+	if (this->sconf.has_config("iteration_limit")) {
+		this->iteration_limit = (size_t)this->sconf["iteration_limit"];
+	}
+
+	if (this->sconf.has_config("record_trace") &&
+	    this->sconf.has_config("replay_trace")) {
+		// Both would use the same trace, recording would append to the decisions
+		// being replayed
+		BOOST_LOG(l.e()) << "record_trace and replay_trace can not be combined";
+		throw ConfigurationError(instance_in, sconf.get_seed(),
+		                         FAULT_TRACE_RECORD_AND_REPLAY,
+		                         "record_trace and replay_trace can not be combined");
+	}
+
+	if (this->sconf.has_config("record_trace")) {
+		this->record_trace_file = std::string(this->sconf["record_trace"]);
+	}
+
+	if (this->sconf.has_config("replay_trace")) {
+		std::string replay_file = this->sconf["replay_trace"];
+		if (!this->trace.load(replay_file)) {
+			BOOST_LOG(l.e()) << "Could not read trace " << replay_file;
+			throw IOError(instance_in, sconf.get_seed(), FAULT_TRACE_FILE_FAILED,
+			              "Could not read SWAG trace " + replay_file);
+		}
+		this->replaying = true;
+		// Do exactly the same amount of work as the recorded run
+		this->iteration_limit = this->trace.get_iteration_count();
+		BOOST_LOG(l.d(1)) << "Replaying " << this->trace.size()
+		                  << " recorded decisions over " << this->iteration_limit
+		                  << " iterations";
+	}
+
+	if (this->iteration_limit > 0) {
+		// The time limit is ignored, it would make the run nondeterministic
+		this->timelimit = 0;
+	} else if (!this->sconf.get_time_limit().valid()) {
 		BOOST_LOG(l.e()) << "SWAGSolver needs a time limit!";
 		throw ConfigurationError(instance_in, sconf.get_seed(),
 		                         FAULT_TIME_LIMIT_NEEDED,
 		                         "SWAGSolver needs a time limit!");
+	} else {
+		this->timelimit = this->sconf.get_time_limit();
 	}
-	this->timelimit = this->sconf.get_time_limit();
 
 	if (this->sconf.has_config("disaggregate_time")) {
 		this->disaggregate_time = (bool)this->sconf["disaggregate_time"];
 	}
 
+	if (this->sconf.has_config("profile_counters")) {
+		this->profile_counters = (bool)this->sconf["profile_counters"];
+	}
+
 	if (this->sconf.has_config("deletion_trials")) {
 		this->deletion_trials = (size_t)this->sconf["deletion_trials"];
 	}
@@ -121,6 +175,29 @@ SWAGSolver<use_mes, use_eps>::SWAGSolver(
 		    (double)this->sconf["deletion_undermove_penalty"];
 	}
 
+	if (this->sconf.has_config("parallel_propagation_threshold")) {
+		this->parallel_propagation_threshold =
+		    (size_t)this->sconf["parallel_propagation_threshold"];
+	}
+
+	if (this->sconf.has_config("propagation_threads")) {
+		this->propagation_threads =
+		    std::max(1u, (unsigned int)this->sconf["propagation_threads"]);
+	}
+	// With --parallel, every run gets its own pool, and runs are pinned to
+	// blocks of --threads cores. More threads would compete with other runs.
+	unsigned int run_threads = 1;
+	if (Configuration::get()->get_threads().valid()) {
+		run_threads = std::max(1u, Configuration::get()->get_threads().value());
+	}
+	if (this->propagation_threads > run_threads) {
+		BOOST_LOG(l.w()) << "propagation_threads is " << this->propagation_threads
+		                 << ", but runs only get " << run_threads
+		                 << " thread(s) (see --threads). Using " << run_threads
+		                 << ".";
+		this->propagation_threads = run_threads;
+	}
+
 	this->durations.resize(this->job_count);
 	this->deadlines.resize(this->job_count);
 	this->releases.resize(this->job_count);
@@ -132,16 +209,15 @@ SWAGSolver<use_mes, use_eps>::SWAGSolver(
 	}
 
 	this->active_range = {0, 0};
+	this->active_range_version = 0;
 }
 
 template <bool use_mes, bool use_eps>
 void
 SWAGSolver<use_mes, use_eps>::bulk_delete()
 {
-	for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
-		this->forward_pointers_changed[jid].clear();
-		this->reverse_pointers_changed[jid].clear();
-	}
+	this->forward_pointers_changed.clear();
+	this->reverse_pointers_changed.clear();
 
 	/* Deletion happens in three passes:
 	 * 1. delete edges from forward adjacency lists, storing the changes to the
@@ -152,11 +228,7 @@ SWAGSolver<use_mes, use_eps>::bulk_delete()
 	 */
 
 	// Pass 1
-	for (Job::JobId s = 0; s < this->job_count; ++s) {
-		if (this->forward_deletion_buckets[s].empty()) {
-			continue;
-		}
-
+	for (size_t s : this->forward_deletion_buckets.get_used_buckets()) {
 		/* The same index might appear multiple times in the list of
 		 * indices to be deleted. Obviously, we should delete only
 		 * once, so we deduplicate. */
@@ -165,13 +237,17 @@ SWAGSolver<use_mes, use_eps>::bulk_delete()
 		/* Inside the adjacency list, we must delete from the right to the left
 		 * to ensure that an element is never moved twice (that would break
 		 * the values in reverse_pointers_changed). */
-		std::sort(this->forward_deletion_buckets[s].begin(),
-		          this->forward_deletion_buckets[s].end(),
+		this->deletion_indices_buf.clear();
+		this->forward_deletion_buckets.for_each(s, [&](size_t delete_index) {
+			this->deletion_indices_buf.push_back(delete_index);
+		});
+		std::sort(this->deletion_indices_buf.begin(),
+		          this->deletion_indices_buf.end(),
 		          [](size_t lhs, size_t rhs) { return rhs < lhs; });
 
 		size_t end_index = this->adjacency_list[s].size();
 
-		for (size_t delete_index : this->forward_deletion_buckets[s]) {
+		for (size_t delete_index : this->deletion_indices_buf) {
 			if (delete_index == last_index) {
 				continue;
 			}
@@ -180,9 +256,9 @@ SWAGSolver<use_mes, use_eps>::bulk_delete()
 			if (delete_index != end_index - 1) {
 				this->adjacency_list[s][delete_index] =
 				    this->adjacency_list[s][end_index - 1];
-				this->reverse_pointers_changed[this->adjacency_list[s][delete_index].t]
-				    .push_back({this->adjacency_list[s][delete_index].rev_index,
-				                delete_index});
+				this->reverse_pointers_changed.push_back(
+				    this->adjacency_list[s][delete_index].t,
+				    {this->adjacency_list[s][delete_index].rev_index, delete_index});
 			}
 			end_index--;
 		}
@@ -190,30 +266,33 @@ SWAGSolver<use_mes, use_eps>::bulk_delete()
 		this->adjacency_list[s].resize(end_index);
 	}
 
-	// Pass 2
-	for (Job::JobId t = 0; t < this->job_count; ++t) {
-		if (!this->reverse_pointers_changed[t].empty()) {
-			for (auto [index, new_forward_index] :
-			     this->reverse_pointers_changed[t]) {
-				this->rev_adjacency_list[t][index].forward_index = new_forward_index;
-			}
-		}
-
-		if (this->reverse_deletion_buckets[t].empty()) {
-			continue;
-		}
+	// Pass 2. The changes to a reverse adjacency list only concern that list,
+	// so all changes can be applied before any deletion.
+	for (size_t t : this->reverse_pointers_changed.get_used_buckets()) {
+		// In the order of recording, the same edge may have been moved twice.
+		this->reverse_pointers_changed.for_each(
+		    t, [&](const std::pair<size_t, size_t> & change) {
+			    this->rev_adjacency_list[t][change.first].forward_index =
+			        change.second;
+		    });
+	}
 
+	for (size_t t : this->reverse_deletion_buckets.get_used_buckets()) {
 		/* Inside the adjacency list, we must delete from the right to the left
 		 * to ensure that an element is never moved twice (that would break
 		 * the values in reverse_pointers_changed). */
-		std::sort(this->reverse_deletion_buckets[t].begin(),
-		          this->reverse_deletion_buckets[t].end(),
+		this->deletion_indices_buf.clear();
+		this->reverse_deletion_buckets.for_each(t, [&](size_t delete_index) {
+			this->deletion_indices_buf.push_back(delete_index);
+		});
+		std::sort(this->deletion_indices_buf.begin(),
+		          this->deletion_indices_buf.end(),
 		          [](size_t lhs, size_t rhs) { return rhs < lhs; });
 
 		size_t last_index = std::numeric_limits<size_t>::max();
 		size_t end_index = this->rev_adjacency_list[t].size();
 
-		for (size_t delete_index : this->reverse_deletion_buckets[t]) {
+		for (size_t delete_index : this->deletion_indices_buf) {
 			if (delete_index == last_index) {
 				continue;
 			}
@@ -223,10 +302,10 @@ SWAGSolver<use_mes, use_eps>::bulk_delete()
 			if (delete_index != end_index - 1) {
 				this->rev_adjacency_list[t][delete_index] =
 				    this->rev_adjacency_list[t][end_index - 1];
-				this->forward_pointers_changed[this->rev_adjacency_list[t][delete_index]
-				                                   .s]
-				    .push_back({this->rev_adjacency_list[t][delete_index].forward_index,
-				                delete_index});
+				this->forward_pointers_changed.push_back(
+				    this->rev_adjacency_list[t][delete_index].s,
+				    {this->rev_adjacency_list[t][delete_index].forward_index,
+				     delete_index});
 			}
 			end_index--;
 		}
@@ -234,12 +313,12 @@ SWAGSolver<use_mes, use_eps>::bulk_delete()
 		this->rev_adjacency_list[t].resize(end_index);
 	}
 
-	for (Job::JobId s = 0; s < this->job_count; ++s) {
-		if (!this->forward_pointers_changed[s].empty()) {
-			for (auto [index, new_rev_index] : this->forward_pointers_changed[s]) {
-				this->adjacency_list[s][index].rev_index = new_rev_index;
-			}
-		}
+	// Pass 3
+	for (size_t s : this->forward_pointers_changed.get_used_buckets()) {
+		this->forward_pointers_changed.for_each(
+		    s, [&](const std::pair<size_t, size_t> & change) {
+			    this->adjacency_list[s][change.first].rev_index = change.second;
+		    });
 	}
 }
 
@@ -344,6 +423,7 @@ SWAGSolver<use_mes, use_eps>::create_new_candidate_edges() noexcept
 
 		// From this point on, we are committed to deleting an edge
 		this->deletion_count++;
+		this->trace_checkpoint(DecisionTrace::Kind::DELETION, wanted_s, wanted_t);
 
 		/* Step 3:
 		 * We found a feasible deletion set. Delete all the edges,
@@ -356,11 +436,8 @@ SWAGSolver<use_mes, use_eps>::create_new_candidate_edges() noexcept
 		 * bulk.
 		 */
 		// TODO can't we directly store in this format?
-		// TODO fast reset?
-		for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
-			this->forward_deletion_buckets[jid].clear();
-			this->reverse_deletion_buckets[jid].clear();
-		}
+		this->forward_deletion_buckets.clear();
+		this->reverse_deletion_buckets.clear();
 
 		for (Edge * e : this->delete_forwards_edges_buf) {
 			//			std::cout << "<< Edge marked for deletion: " << (size_t)e << "\n";
@@ -374,8 +451,8 @@ SWAGSolver<use_mes, use_eps>::create_new_candidate_edges() noexcept
 			assert(this->adjacency_list[s].size() > forward_index);
 			assert(this->rev_adjacency_list[e->t].size() > e->rev_index);
 
-			this->forward_deletion_buckets[s].push_back(forward_index);
-			this->reverse_deletion_buckets[e->t].push_back(e->rev_index);
+			this->forward_deletion_buckets.push_back(s, forward_index);
+			this->reverse_deletion_buckets.push_back(e->t, e->rev_index);
 		}
 
 		for (Edge * e : this->delete_backwards_edges_buf) {
@@ -389,8 +466,8 @@ SWAGSolver<use_mes, use_eps>::create_new_candidate_edges() noexcept
 			assert(this->adjacency_list[s].size() > forward_index);
 			assert(this->rev_adjacency_list[e->t].size() > e->rev_index);
 
-			this->forward_deletion_buckets[s].push_back(forward_index);
-			this->reverse_deletion_buckets[e->t].push_back(e->rev_index);
+			this->forward_deletion_buckets.push_back(s, forward_index);
+			this->reverse_deletion_buckets.push_back(e->t, e->rev_index);
 		}
 
 		this->bulk_delete();
@@ -400,25 +477,21 @@ SWAGSolver<use_mes, use_eps>::create_new_candidate_edges() noexcept
 		this->rebuild_lf_backward();
 
 		this->node_moved_buf.reset();
-		Timer skyline_timer;
-		if (this->disaggregate_time) {
-			skyline_timer.start();
-		}
+		auto skyline_started = this->profiler.start();
 		for (auto jid : this->changed_nodes_buf) {
 			if (!this->node_moved_buf[jid]) {
 				this->rsl.set_pos(jid, (int)this->earliest_starts[jid]);
 				this->node_moved_buf[jid] = true;
 			}
 		}
-		if (this->disaggregate_time) {
-			this->skyline_update_time += skyline_timer.get();
-		}
+		this->profiler.stop(PHASE_SKYLINE_UPDATE, skyline_started);
 
 		/*
 		 *Step 4: Insert the new candidate into the candidate edge set.
 		 */
 		if constexpr (use_mes || use_eps) {
 			this->candidate_edge_buf.emplace_back(1.0, wanted_s, wanted_t);
+			this->candidate_score_tree.clear();
 			break; // We succeeded
 		} else {
 			this->candidate_edge_buf.emplace_back(wanted_s, wanted_t);
@@ -1029,10 +1102,7 @@ void
 SWAGSolver<use_mes, use_eps>::push_es_forward(bool force_complete,
                                               bool range_changed) noexcept
 {
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
 	if (force_complete) {
 		this->push_es_forward_queue.insert(
@@ -1040,6 +1110,12 @@ SWAGSolver<use_mes, use_eps>::push_es_forward(bool force_complete,
 		    this->push_es_forward_out_of_range.begin(),
 		    this->push_es_forward_out_of_range.end());
 		this->push_es_forward_out_of_range.clear();
+
+		if ((this->propagation_workers != nullptr) &&
+		    (this->push_es_forward_queue.size() >=
+		     this->parallel_propagation_threshold)) {
+			this->push_es_forward_parallel();
+		}
 	} else if (range_changed) {
 		// We need to check which of the unpropagated changes need to be
 		// propagated
@@ -1088,19 +1164,122 @@ SWAGSolver<use_mes, use_eps>::push_es_forward(bool force_complete,
 		}
 	}
 
-	if (this->disaggregate_time) {
-		this->propagate_time += timer.get();
+	this->profiler.stop(PHASE_PROPAGATE, started);
+}
+
+template <bool use_mes, bool use_eps>
+template <class Relax>
+void
+SWAGSolver<use_mes, use_eps>::propagate_parallel(
+    std::vector<Job::JobId> & queue, bool record_changes, Relax && relax) noexcept
+{
+	// Workers take this many jobs of the current round at a time
+	constexpr size_t chunk_size = 256;
+
+	this->frontier_next_bufs.resize(
+	    this->propagation_workers->get_thread_count());
+
+	while (queue.size() >= this->parallel_propagation_threshold) {
+		std::atomic<size_t> next_chunk(0);
+
+		this->propagation_workers->run([&](unsigned int worker) {
+			auto & next = this->frontier_next_bufs[worker];
+			auto enqueue = [&](Job::JobId jid) {
+				if (__atomic_exchange_n(&this->frontier_flags[jid], (unsigned char)1,
+				                        __ATOMIC_RELAXED) == 0) {
+					next.push_back(jid);
+				}
+			};
+
+			while (true) {
+				size_t begin =
+				    next_chunk.fetch_add(chunk_size, std::memory_order_relaxed);
+				if (begin >= queue.size()) {
+					break;
+				}
+				size_t end = std::min(begin + chunk_size, queue.size());
+				for (size_t i = begin; i < end; ++i) {
+					relax(queue[i], enqueue);
+				}
+			}
+		});
+
+		queue.clear();
+		for (auto & next : this->frontier_next_bufs) {
+			for (Job::JobId jid : next) {
+				this->frontier_flags[jid] = 0;
+			}
+			queue.insert(queue.end(), next.begin(), next.end());
+			if (record_changes) {
+				this->changed_nodes_buf.insert(this->changed_nodes_buf.end(),
+				                               next.begin(), next.end());
+			}
+			next.clear();
+		}
 	}
 }
 
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::push_es_forward_parallel() noexcept
+{
+	/* A job may be relaxed while another worker raises its own earliest start
+	 * in the same round. That is fine: whoever raises it enqueues it for the
+	 * next round, so we converge to the same values as the sequential push. */
+	this->propagate_parallel(
+	    this->push_es_forward_queue, true, [&](Job::JobId v, auto & enqueue) {
+		    unsigned int new_start =
+		        __atomic_load_n(&this->earliest_starts[v], __ATOMIC_RELAXED) +
+		        this->durations[v];
+
+		    for (const auto & edge : this->adjacency_list[v]) {
+			    unsigned int * target = &this->earliest_starts[edge.t];
+			    unsigned int current = __atomic_load_n(target, __ATOMIC_RELAXED);
+			    // Atomic maximum
+			    while (new_start > current) {
+				    if (__atomic_compare_exchange_n(target, &current, new_start, true,
+				                                    __ATOMIC_RELAXED,
+				                                    __ATOMIC_RELAXED)) {
+					    enqueue(edge.t);
+					    break;
+				    }
+			    }
+		    }
+	    });
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::push_lf_backward_parallel() noexcept
+{
+	// See push_es_forward_parallel()
+	this->propagate_parallel(
+	    this->push_lf_backward_queue, false, [&](Job::JobId v, auto & enqueue) {
+		    unsigned int new_finish =
+		        __atomic_load_n(&this->latest_finishs[v], __ATOMIC_RELAXED) -
+		        this->durations[v];
+
+		    for (const auto & rev_edge : this->rev_adjacency_list[v]) {
+			    unsigned int * target = &this->latest_finishs[rev_edge.s];
+			    unsigned int current = __atomic_load_n(target, __ATOMIC_RELAXED);
+			    // Atomic minimum
+			    while (new_finish < current) {
+				    if (__atomic_compare_exchange_n(target, &current, new_finish, true,
+				                                    __ATOMIC_RELAXED,
+				                                    __ATOMIC_RELAXED)) {
+					    enqueue(rev_edge.s);
+					    break;
+				    }
+			    }
+		    }
+	    });
+}
+
 template <bool use_mes, bool use_eps>
 void
 SWAGSolver<use_mes, use_eps>::build_candidate_jobs() noexcept
 {
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
 	this->candidates_buf.clear();
 	// TODO this is way too slow
@@ -1114,26 +1293,21 @@ SWAGSolver<use_mes, use_eps>::build_candidate_jobs() noexcept
 
 	this->batch_offset = 0;
 
-	if (this->disaggregate_time) {
-		this->job_selection_time += timer.get();
-	}
+	this->profiler.stop(PHASE_JOB_SELECTION, started);
 }
 
 template <bool use_mes, bool use_eps>
 void
 SWAGSolver<use_mes, use_eps>::build_candidate_edges_batched() noexcept
 {
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
 	if (this->randomize_edge_candidates && (this->batch_offset == 0)) {
 		std::shuffle(this->candidates_buf.begin(), this->candidates_buf.end(),
 		             this->rnd);
 	}
 
-	this->score_sum = 0;
+	this->candidate_score_tree.clear();
 
 	size_t num_jobs = this->candidates_buf.size();
 	size_t max_attempt = num_jobs * (num_jobs - 1);
@@ -1171,110 +1345,190 @@ SWAGSolver<use_mes, use_eps>::build_candidate_edges_batched() noexcept
 					score += this->eps.get_score_for(s_jid, t_jid);
 				}
 				this->candidate_edge_buf.emplace_back(score, s_jid, t_jid);
-				this->score_sum += score;
 			} else {
 				this->candidate_edge_buf.emplace_back(s_jid, t_jid);
 			}
 		}
 	}
 
-	if (this->disaggregate_time) {
-		this->edge_selection_time += timer.get();
+	this->profiler.stop(PHASE_EDGE_SELECTION, started);
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::sort_candidates_by_start() noexcept
+{
+	if (this->candidates_buf.empty()) {
+		return;
+	}
+
+	unsigned int min_start = std::numeric_limits<unsigned int>::max();
+	unsigned int max_start = 0;
+	for (Job::JobId jid : this->candidates_buf) {
+		min_start = std::min(min_start, this->earliest_starts[jid]);
+		max_start = std::max(max_start, this->earliest_starts[jid]);
+	}
+
+	size_t range = (size_t)(max_start - min_start) + 1;
+	if (range > 4 * this->candidates_buf.size() + 1024) {
+		// Too sparse for buckets
+		std::sort(this->candidates_buf.begin(), this->candidates_buf.end(),
+		          [&](Job::JobId jid_a, Job::JobId jid_b) {
+			          return this->earliest_starts[jid_a] < this->earliest_starts[jid_b];
+		          });
+		return;
 	}
+
+	// Counting sort
+	this->start_buckets_buf.assign(range + 1, 0);
+	for (Job::JobId jid : this->candidates_buf) {
+		this->start_buckets_buf[this->earliest_starts[jid] - min_start + 1]++;
+	}
+	for (size_t i = 1; i <= range; ++i) {
+		this->start_buckets_buf[i] += this->start_buckets_buf[i - 1];
+	}
+
+	this->sorted_candidates_buf.resize(this->candidates_buf.size());
+	for (Job::JobId jid : this->candidates_buf) {
+		this->sorted_candidates_buf[this->start_buckets_buf
+		                                [this->earliest_starts[jid] - min_start]++] =
+		    jid;
+	}
+	this->candidates_buf.swap(this->sorted_candidates_buf);
 }
 
 template <bool use_mes, bool use_eps>
 void
 SWAGSolver<use_mes, use_eps>::build_candidate_edges() noexcept
 {
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
-	this->score_sum = 0;
+	this->sort_candidates_by_start();
 
-	// sort by start points
-	struct cmp
-	{
-		const std::vector<unsigned int> & start_times;
-		cmp(const std::vector<unsigned int> & start_times_in)
-		    : start_times(start_times_in)
-		{}
+	this->active_jids_buf.clear();
+	this->active_ends_buf.clear();
+	this->active_latest_starts_buf.clear();
+
+	this->clear_candidate_edges();
 
-		bool
-		operator()(unsigned int jid_a, unsigned int jid_b) const noexcept
-		{
-			return start_times[jid_a] < start_times[jid_b];
+	auto emit_edge = [&](Job::JobId s, Job::JobId t) {
+		if constexpr (use_mes || use_eps) {
+			double score = 1.0;
+			if constexpr (use_mes) {
+				score += this->mes.get_score_for(s, t);
+			}
+			if constexpr (use_eps) {
+				score += this->eps.get_score_for(s, t);
+			}
+			this->candidate_edge_buf.emplace_back(score, s, t);
+		} else {
+			this->candidate_edge_buf.emplace_back(s, t);
 		}
 	};
-	std::sort(this->candidates_buf.begin(), this->candidates_buf.end(),
-	          cmp(this->earliest_starts));
-
-	// list of currently active jobs and their end times
-	this->active_jobs_buf.clear();
-
-	this->candidate_edge_buf.clear();
 
+	/* Sweep over the jobs by start time. Every job is compared against all
+	 * jobs that are still running at its start:
+	 *   * it has ended if end <= start
+	 *   * the forward edge jid -> other fits if
+	 *       latest_start[other] >= start + duration[jid]
+	 *   * the backward edge other -> jid fits if
+	 *       end[other] <= latest_finish[jid] - duration[jid]
+	 * Jobs that have ended are compacted out of the active set in the same
+	 * pass. */
 	for (Job::JobId jid : this->candidates_buf) {
-		unsigned int start = this->earliest_starts[jid];
-		// TODO can this be SIMDed?
-		for (size_t i = 0; i < this->active_jobs_buf.size();) {
-			auto [other_jid, other_end] = this->active_jobs_buf[i];
+		const int start = (int)this->earliest_starts[jid];
+		const int forward_bound = start + (int)this->durations[jid];
+		const int backward_bound =
+		    (int)this->latest_finishs[jid] - (int)this->durations[jid];
+
+		Job::JobId * jids = this->active_jids_buf.data();
+		int * ends = this->active_ends_buf.data();
+		int * latest_starts = this->active_latest_starts_buf.data();
+		const size_t count = this->active_jids_buf.size();
+		size_t write = 0;
+		size_t i = 0;
 
-			if (other_end <= start) {
-				// No longer active
-				std::swap(this->active_jobs_buf[i], this->active_jobs_buf.back());
-				this->active_jobs_buf.pop_back();
-			} else {
-				// Try forward edge
-				if (this->latest_finishs[other_jid] >=
-				    start + this->durations[jid] + this->durations[other_jid]) {
-					if constexpr (use_mes || use_eps) {
-						double score = 1.0;
-						if constexpr (use_mes) {
-							score += this->mes.get_score_for(jid, other_jid);
-						}
-						if constexpr (use_eps) {
-							score += this->eps.get_score_for(jid, other_jid);
-						}
-						this->candidate_edge_buf.emplace_back(score, jid, other_jid);
-						this->score_sum += score;
-					} else {
-						this->candidate_edge_buf.emplace_back(jid, other_jid);
-					}
+#if defined(__AVX2__)
+		const __m256i start_v = _mm256_set1_epi32(start);
+		const __m256i forward_v = _mm256_set1_epi32(forward_bound - 1);
+		const __m256i backward_v = _mm256_set1_epi32(backward_bound + 1);
+		for (; i + 8 <= count; i += 8) {
+			__m256i ends_v = _mm256_loadu_si256((const __m256i *)(ends + i));
+			__m256i latest_starts_v =
+			    _mm256_loadu_si256((const __m256i *)(latest_starts + i));
+
+			unsigned int alive = (unsigned int)_mm256_movemask_ps(
+			    _mm256_castsi256_ps(_mm256_cmpgt_epi32(ends_v, start_v)));
+			unsigned int forward =
+			    alive & (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(
+			                _mm256_cmpgt_epi32(latest_starts_v, forward_v)));
+			unsigned int backward =
+			    alive & (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(
+			                _mm256_cmpgt_epi32(backward_v, ends_v)));
+
+			for (unsigned int edges = forward | backward; edges != 0;
+			     edges &= edges - 1) {
+				unsigned int bit = (unsigned int)__builtin_ctz(edges);
+				Job::JobId other_jid = jids[i + bit];
+				if (forward & (1u << bit)) {
+					emit_edge(jid, other_jid);
 				}
+				if (backward & (1u << bit)) {
+					emit_edge(other_jid, jid);
+				}
+			}
 
-				// Try backwards edge
-				if (this->latest_finishs[jid] >= this->earliest_starts[other_jid] +
-				                                     this->durations[jid] +
-				                                     this->durations[other_jid]) {
-					if constexpr (use_mes || use_eps) {
-						double score = 1.0;
-						if constexpr (use_mes) {
-							score += this->mes.get_score_for(other_jid, jid);
-						}
-						if constexpr (use_eps) {
-							score += this->eps.get_score_for(other_jid, jid);
-						}
-						this->candidate_edge_buf.emplace_back(score, other_jid, jid);
-						this->score_sum += score;
-					} else {
-						this->candidate_edge_buf.emplace_back(other_jid, jid);
-					}
+			// AVX2 has no compress, move the survivors one by one
+			if (alive == 0xFF) {
+				if (write != i) {
+					std::copy(jids + i, jids + i + 8, jids + write);
+					std::copy(ends + i, ends + i + 8, ends + write);
+					std::copy(latest_starts + i, latest_starts + i + 8,
+					          latest_starts + write);
 				}
+				write += 8;
+			} else {
+				for (; alive != 0; alive &= alive - 1) {
+					size_t from = i + (size_t)__builtin_ctz(alive);
+					jids[write] = jids[from];
+					ends[write] = ends[from];
+					latest_starts[write] = latest_starts[from];
+					write++;
+				}
+			}
+		}
+#endif
+
+		for (; i < count; ++i) {
+			if (ends[i] <= start) {
+				// No longer active
+				continue;
+			}
 
-				++i;
+			if (latest_starts[i] >= forward_bound) {
+				emit_edge(jid, jids[i]);
+			}
+			if (ends[i] <= backward_bound) {
+				emit_edge(jids[i], jid);
 			}
+
+			jids[write] = jids[i];
+			ends[write] = ends[i];
+			latest_starts[write] = latest_starts[i];
+			write++;
 		}
 
-		this->active_jobs_buf.emplace_back(jid, this->earliest_starts[jid] +
-		                                            this->durations[jid]);
-	}
+		this->active_jids_buf.resize(write);
+		this->active_ends_buf.resize(write);
+		this->active_latest_starts_buf.resize(write);
 
-	if (this->disaggregate_time) {
-		this->edge_selection_time += timer.get();
+		this->active_jids_buf.push_back(jid);
+		this->active_ends_buf.push_back(forward_bound);
+		this->active_latest_starts_buf.push_back((int)this->latest_finishs[jid] -
+		                                         (int)this->durations[jid]);
 	}
+
+	this->profiler.stop(PHASE_EDGE_SELECTION, started);
 }
 
 template <bool use_mes, bool use_eps>
@@ -1282,11 +1536,9 @@ void
 SWAGSolver<use_mes, use_eps>::reset() noexcept
 {
 	this->reset_count++;
+	this->trace_checkpoint(DecisionTrace::Kind::RESET, 0, 0);
 
-	Timer reset_timer;
-	if (this->disaggregate_time) {
-		reset_timer.start();
-	}
+	auto reset_started = this->profiler.start();
 
 	double score = this->rsl.get_maximum().getUsage()[0];
 	this->solution_count++;
@@ -1316,13 +1568,122 @@ SWAGSolver<use_mes, use_eps>::reset() noexcept
 		this->rsl.set_pos(jid, (int)this->earliest_starts[jid]);
 	}
 
-	if (this->disaggregate_time) {
-		this->reset_time += reset_timer.get();
+	// The base times are completely propagated, so everything that was
+	// deferred is obsolete now.
+	this->push_es_forward_out_of_range.clear();
+	this->push_lf_backward_out_of_range.clear();
+
+	this->profiler.stop(PHASE_RESET, reset_started);
+
+	this->refresh_active_range();
+}
+
+template <bool use_mes, bool use_eps>
+bool
+SWAGSolver<use_mes, use_eps>::refresh_active_range() noexcept
+{
+	// Cheap - the skyline tells us if its maximum range has moved at all
+	size_t version = this->rsl.get_maximum_range_version();
+	if (version == this->active_range_version) {
+		return false;
 	}
+	this->active_range_version = version;
 
-	this->active_range = this->rsl.get_maximum_range();
-	// Propagate for the new active range
-	this->iteration_propagate(true, true); // TODO is this necessary?
+	auto max_range = this->rsl.get_maximum_range();
+	if (max_range == this->active_range) {
+		return false;
+	}
+	this->active_range = max_range;
+
+	return true;
+}
+
+template <bool use_mes, bool use_eps>
+bool
+SWAGSolver<use_mes, use_eps>::keep_running() noexcept
+{
+	if (this->iteration_limit > 0) {
+		return this->iteration_count < this->iteration_limit;
+	}
+	return this->run_timer.get() < this->timelimit;
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::trace_checkpoint(DecisionTrace::Kind kind,
+                                               unsigned int a,
+                                               unsigned int b) noexcept
+{
+	if (!this->record_trace_file.empty()) {
+		this->trace.record(this->iteration_count, kind, a, b);
+	}
+
+	if (this->replaying && !this->replay_diverged) {
+		const DecisionTrace::Event * ev = this->trace.peek();
+		if ((ev == nullptr) ||
+		    !(*ev == DecisionTrace::Event{this->iteration_count, kind, a, b})) {
+			this->replay_diverge();
+			return;
+		}
+		this->trace.advance();
+	}
+}
+
+template <bool use_mes, bool use_eps>
+size_t
+SWAGSolver<use_mes, use_eps>::replay_edge_index(size_t sampled_index) noexcept
+{
+	const DecisionTrace::Event * ev = this->trace.peek();
+	if ((ev == nullptr) || (ev->kind != DecisionTrace::Kind::EDGE) ||
+	    (ev->iteration != this->iteration_count)) {
+		this->replay_diverge();
+		return sampled_index;
+	}
+
+	auto is_recorded = [&](const auto & edge) {
+		if constexpr (use_mes || use_eps) {
+			return (std::get<1>(edge) == ev->a) && (std::get<2>(edge) == ev->b);
+		} else {
+			return (edge.first == ev->a) && (edge.second == ev->b);
+		}
+	};
+
+	// Unless the candidates are ordered differently than in the recorded run,
+	// we sampled the same edge.
+	size_t index = sampled_index;
+	if (!is_recorded(this->candidate_edge_buf[index])) {
+		index = 0;
+		while ((index < this->candidate_edge_buf.size()) &&
+		       !is_recorded(this->candidate_edge_buf[index])) {
+			index++;
+		}
+		if (index == this->candidate_edge_buf.size()) {
+			this->replay_diverge();
+			return sampled_index;
+		}
+	}
+
+	this->trace.advance();
+	return index;
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::replay_diverge() noexcept
+{
+	BOOST_LOG(l.w()) << "Replay diverged from the trace in iteration "
+	                 << this->iteration_count
+	                 << ", continuing with own decisions.";
+	this->replay_diverged = true;
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::clear_candidate_edges() noexcept
+{
+	this->candidate_edge_buf.clear();
+	// The tree must never hold weights of edges that are gone
+	this->candidate_score_tree.clear();
 }
 
 template <bool use_mes, bool use_eps>
@@ -1331,7 +1692,7 @@ SWAGSolver<use_mes, use_eps>::iteration_regenerate_candidates() noexcept
 {
 	this->build_candidate_jobs();
 
-	this->candidate_edge_buf.clear();
+	this->clear_candidate_edges();
 
 	if (this->edge_candidate_batchsize == 0) {
 		this->build_candidate_edges();
@@ -1352,10 +1713,7 @@ SWAGSolver<use_mes, use_eps>::iteration_propagate(bool complete,
 
 	this->node_moved_buf.reset(); // TODO does this even speed things up?
 
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
 	for (auto jid : this->changed_nodes_buf) {
 		if (!this->node_moved_buf[jid]) {
@@ -1364,24 +1722,18 @@ SWAGSolver<use_mes, use_eps>::iteration_propagate(bool complete,
 		}
 	}
 
-	if (this->disaggregate_time) {
-		this->skyline_update_time += timer.get();
-	}
+	this->profiler.stop(PHASE_SKYLINE_UPDATE, started);
 }
 
 template <bool use_mes, bool use_eps>
 void
 SWAGSolver<use_mes, use_eps>::iteration_unstick() noexcept
 {
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
 	this->iteration_propagate(true, false);
 
-	if (this->rsl.get_maximum_range() != this->active_range) {
-		this->active_range = this->rsl.get_maximum_range();
+	if (this->refresh_active_range()) {
 		// We just propagated everything, so we don't need to do it again here.
 		// this->dbg_verify_correctly_partially_propagated();
 
@@ -1389,9 +1741,7 @@ SWAGSolver<use_mes, use_eps>::iteration_unstick() noexcept
 		this->iteration_regenerate_candidates();
 		if (!this->candidate_edge_buf.empty()) {
 			// Ha, that worked!
-			if (disaggregate_time) {
-				this->unstick_time += timer.get();
-			}
+			this->profiler.stop(PHASE_UNSTICK, started);
 			return;
 		}
 	}
@@ -1403,6 +1753,12 @@ SWAGSolver<use_mes, use_eps>::iteration_unstick() noexcept
 		for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
 			this->best_start_times[jid] = this->earliest_starts[jid];
 		}
+		if (this->exchange != nullptr) {
+			this->exchange->offer(
+			    this->best_start_times,
+			    AdditionalResultStorage::IntermediateResult::SOURCE_HEURISTIC,
+			    Maybe<unsigned int>((unsigned int)this->iteration_count));
+		}
 	}
 
 	// Okay, now for actual unsticking. If we can still delete…
@@ -1410,11 +1766,6 @@ SWAGSolver<use_mes, use_eps>::iteration_unstick() noexcept
 		// Then delete!
 		this->deletions_remaining--;
 
-		Timer deletion_timer;
-		if (this->disaggregate_time) {
-			deletion_timer.start();
-		}
-
 		this->create_new_candidate_edges();
 
 		if (this->candidate_edge_buf.empty()) {
@@ -1422,9 +1773,7 @@ SWAGSolver<use_mes, use_eps>::iteration_unstick() noexcept
 			this->reset();
 			this->iteration_regenerate_candidates();
 			this->deletions_remaining = this->deletions_before_reset;
-			if (disaggregate_time) {
-				this->unstick_time += timer.get();
-			}
+			this->profiler.stop(PHASE_UNSTICK, started);
 			return;
 		} else {
 			//			BOOST_LOG(l.d(3)) << ">>> Success!";
@@ -1436,15 +1785,11 @@ SWAGSolver<use_mes, use_eps>::iteration_unstick() noexcept
 		this->reset();
 		this->iteration_regenerate_candidates();
 		this->deletions_remaining = this->deletions_before_reset;
-		if (disaggregate_time) {
-			this->unstick_time += timer.get();
-		}
+		this->profiler.stop(PHASE_UNSTICK, started);
 		return;
 	}
 
-	if (disaggregate_time) {
-		this->unstick_time += timer.get();
-	}
+	this->profiler.stop(PHASE_UNSTICK, started);
 }
 
 template <bool use_mes, bool use_eps>
@@ -1485,6 +1830,7 @@ SWAGSolver<use_mes, use_eps>::iteration() noexcept
 			     {(unsigned int)this->iteration_count},
 			     {this->best_score},
 			     {},
+			     {},
 			     {}});
 		}
 	}
@@ -1509,23 +1855,23 @@ SWAGSolver<use_mes, use_eps>::iteration() noexcept
 	}
 	*/
 
-	// Periodically check if our active range is still okay
+	// Check if our active range is still okay. The skyline notifies us about
+	// moves of the peak, so this only does work if it actually moved.
 	if ((this->iteration_count - this->last_range_check) >=
 	    this->force_range_check_after) {
 		this->last_range_check = this->iteration_count;
 
-		auto max_range = this->rsl.get_maximum_range();
-		if (max_range != this->active_range) {
+		if (this->refresh_active_range()) {
 			// Active range has changed
 			active_range_changed = true;
 
 			// Clear everything.
 			this->candidates_buf.clear();
-			this->candidate_edge_buf.clear();
-			this->active_range = max_range;
+			this->clear_candidate_edges();
 
-			// Propagate for the new active range
-			this->iteration_propagate(true, true); // TODO is complete necessary?
+			// Propagate what was deferred and now lies within the new active
+			// range. Everything else stays deferred until the next complete push.
+			this->iteration_propagate(false, true);
 		}
 	}
 
@@ -1585,10 +1931,7 @@ void
 SWAGSolver<use_mes, use_eps>::push_lf_backward(bool force_complete,
                                                bool range_changed) noexcept
 {
-	Timer timer;
-	if (this->disaggregate_time) {
-		timer.start();
-	}
+	auto started = this->profiler.start();
 
 	if (force_complete) {
 		this->push_lf_backward_queue.insert(
@@ -1596,6 +1939,12 @@ SWAGSolver<use_mes, use_eps>::push_lf_backward(bool force_complete,
 		    this->push_lf_backward_out_of_range.begin(),
 		    this->push_lf_backward_out_of_range.end());
 		this->push_lf_backward_out_of_range.clear();
+
+		if ((this->propagation_workers != nullptr) &&
+		    (this->push_lf_backward_queue.size() >=
+		     this->parallel_propagation_threshold)) {
+			this->push_lf_backward_parallel();
+		}
 	} else if (range_changed) {
 		// We need to check which of the unpropagated changes need to be
 		// propagated
@@ -1638,9 +1987,7 @@ SWAGSolver<use_mes, use_eps>::push_lf_backward(bool force_complete,
 		}
 	}
 
-	if (this->disaggregate_time) {
-		this->propagate_time += timer.get();
-	}
+	this->profiler.stop(PHASE_PROPAGATE, started);
 }
 
 template <bool use_mes, bool use_eps>
@@ -1709,19 +2056,14 @@ SWAGSolver<use_mes, use_eps>::insert_edge(Job::JobId s, Job::JobId t,
 	this->push_lf_backward(force_complete, false);
 
 	this->node_moved_buf.reset();
-	Timer skyline_timer;
-	if (this->disaggregate_time) {
-		skyline_timer.start();
-	}
+	auto skyline_started = this->profiler.start();
 	for (auto jid : this->changed_nodes_buf) {
 		if (!this->node_moved_buf[jid]) {
 			this->rsl.set_pos(jid, (int)this->earliest_starts[jid]);
 			this->node_moved_buf[jid] = true;
 		}
 	}
-	if (this->disaggregate_time) {
-		this->skyline_update_time += skyline_timer.get();
-	}
+	this->profiler.stop(PHASE_SKYLINE_UPDATE, skyline_started);
 }
 
 template <bool use_mes, bool use_eps>
@@ -1731,10 +2073,7 @@ SWAGSolver<use_mes, use_eps>::delete_edge(Job::JobId s,
 {
 	Job::JobId t = this->adjacency_list[s][s_adj_list_index];
 	this->graph_delete_edge(s, s_adj_list_index);
-	Timer update_timer;
-	if (this->disaggregate_time) {
-		update_timer.start();
-	}
+	auto update_started = this->profiler.start();
 
 	this->changed_nodes_buf.clear();
 	this->rebuild_es_forward_buf.push_back(t);
@@ -1742,24 +2081,17 @@ SWAGSolver<use_mes, use_eps>::delete_edge(Job::JobId s,
 	this->rebuild_lf_backward_buf.push_back(s);
 	this->rebuild_lf_backward();
 
-	if (this->disaggregate_time) {
-		this->time_update_time += update_timer.get();
-	}
+	this->profiler.stop(PHASE_DELETION_PROPAGATE, update_started);
 
 	this->node_moved_buf.reset();
-	Timer skyline_timer;
-	if (this->disaggregate_time) {
-		skyline_timer.start();
-	}
+	auto skyline_started = this->profiler.start();
 	for (auto jid : this->changed_nodes_buf) {
 		if (!this->node_moved_buf[jid]) {
 			this->rsl.set_pos(jid, this->earliest_starts[jid]);
 			this->node_moved_buf[jid] = true;
 		}
 	}
-	if (this->disaggregate_time) {
-		this->skyline_update_time += skyline_timer.get();
-	}
+	this->profiler.stop(PHASE_SKYLINE_UPDATE, skyline_started);
 }
 
 template <bool use_mes, bool use_eps>
@@ -1777,10 +2109,24 @@ SWAGSolver<use_mes, use_eps>::run()
 
 	this->run_timer.start();
 	this->log_timer.start();
+	if (this->disaggregate_time) {
+		// Counters are per thread, so this must happen here
+		this->profiler.enable(this->profile_counters);
+	}
 
 	this->iteration_count = 0;
 	this->insertion_count = 0;
 
+	if ((this->propagation_threads > 1) &&
+	    (this->parallel_propagation_threshold > 0)) {
+		BOOST_LOG(l.d(2)) << "Propagating complete pushes of at least "
+		                  << this->parallel_propagation_threshold << " jobs with "
+		                  << this->propagation_threads << " threads";
+		this->propagation_workers =
+		    std::make_unique<util::WorkerPool>(this->propagation_threads);
+		this->frontier_flags.assign(this->job_count, 0);
+	}
+
 	BOOST_LOG(l.d(3)) << "Initializing graph...";
 	this->initialize_graph();
 	BOOST_LOG(l.d(3)) << "Initializing times...";
@@ -1788,14 +2134,63 @@ SWAGSolver<use_mes, use_eps>::run()
 	BOOST_LOG(l.d(3)) << "Initializing skyline...";
 	this->initialize_skyline();
 	this->active_range = this->rsl.get_maximum_range();
+	this->active_range_version = this->rsl.get_maximum_range_version();
+
+	if ((this->checkpoint != nullptr) && this->checkpoint->can_resume()) {
+		this->resume_from_checkpoint();
+	}
 
 	BOOST_LOG(l.d(2)) << "Initialization done.";
 
-	while (this->run_timer.get() < this->timelimit) {
+	// How often to look for incumbents of a concurrently running MIP, and
+	// whether a checkpoint is due
+	constexpr size_t exchange_interval = 1000;
+	constexpr size_t checkpoint_check_interval = 1000;
+
+	while (this->keep_running()) {
 		this->iteration();
+
+		if ((this->checkpoint != nullptr) &&
+		    ((this->iteration_count % checkpoint_check_interval) == 0) &&
+		    this->checkpoint->is_due(this->run_timer.get())) {
+			this->save_checkpoint();
+		}
+
+		if ((this->exchange != nullptr) &&
+		    ((this->iteration_count % exchange_interval) == 0)) {
+			this->synchronize();
+			if (this->exchange->should_stop()) {
+				BOOST_LOG(l.d(2)) << "Stopping early on request of the exchange.";
+				break;
+			}
+		}
 	}
 
 	double elapsed_time = this->run_timer.get();
+
+	// The pool's threads report their resource usage to the run when they end
+	this->propagation_workers.reset();
+
+	if (!this->record_trace_file.empty()) {
+		this->trace.record(this->iteration_count, DecisionTrace::Kind::END, 0, 0);
+		if (!this->trace.save(this->record_trace_file)) {
+			BOOST_LOG(l.e()) << "Could not write trace " << this->record_trace_file;
+			throw IOError(this->instance, this->sconf.get_seed(),
+			              FAULT_TRACE_FILE_FAILED,
+			              "Could not write SWAG trace " + this->record_trace_file);
+		}
+		BOOST_LOG(l.d(1)) << "Recorded " << this->trace.size() << " decisions to "
+		                  << this->record_trace_file;
+	}
+	if (this->replaying) {
+		this->additional.extended_measures.push_back(
+		    {"REPLAY_DIVERGED",
+		     {},
+		     {},
+		     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
+		     {(int)this->replay_diverged}});
+	}
+
 	this->additional.extended_measures.push_back(
 	    {"ITERATIONS_PER_SECOND",
 	     {},
@@ -1833,48 +2228,14 @@ SWAGSolver<use_mes, use_eps>::run()
 	     AdditionalResultStorage::ExtendedMeasure::TYPE_INT,
 	     {(double)this->solution_count}});
 	if (this->disaggregate_time) {
-		this->additional.extended_measures.push_back(
-		    {"SKYLINE_UPDATE_TIME",
-		     {},
-		     {},
-		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->skyline_update_time}});
-		this->additional.extended_measures.push_back(
-		    {"PROPAGATE_TIME",
-		     {},
-		     {},
-		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->propagate_time}});
-		this->additional.extended_measures.push_back(
-		    {"RESET_TIME",
-		     {},
-		     {},
-		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->reset_time}});
+		this->profiler.write_measures(this->additional);
 		this->additional.extended_measures.push_back(
 		    {"SELECTION_TIME",
 		     {},
 		     {},
 		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->edge_selection_time + this->job_selection_time}});
-		this->additional.extended_measures.push_back(
-		    {"EDGE_SELECTION_TIME",
-		     {},
-		     {},
-		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->edge_selection_time}});
-		this->additional.extended_measures.push_back(
-		    {"JOB_SELECTION_TIME",
-		     {},
-		     {},
-		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->job_selection_time}});
-		this->additional.extended_measures.push_back(
-		    {"UNSTICK_TIME",
-		     {},
-		     {},
-		     AdditionalResultStorage::ExtendedMeasure::TYPE_DOUBLE,
-		     {this->unstick_time}});
+		     {this->profiler.get_seconds(PHASE_EDGE_SELECTION) +
+		      this->profiler.get_seconds(PHASE_JOB_SELECTION)}});
 	}
 }
 
@@ -1886,20 +2247,32 @@ SWAGSolver<use_mes, use_eps>::iteration_insert_edge(
 	size_t i = 0;
 
 	if constexpr (use_mes || use_eps) {
-		std::uniform_real_distribution<double> distr(0, this->score_sum);
+		// Sample proportionally to the scores in O(log k). The tree is built
+		// once per candidate generation and shrinks along with the buffer.
+		if (this->candidate_score_tree.empty()) {
+			this->candidate_score_tree.build(
+			    this->candidate_edge_buf.begin(), this->candidate_edge_buf.end(),
+			    [](const auto & edge) { return std::get<0>(edge); });
+		}
+		assert(this->candidate_score_tree.size() ==
+		       this->candidate_edge_buf.size());
+
+		std::uniform_real_distribution<double> distr(
+		    0, this->candidate_score_tree.total());
 		double point = distr(this->rnd);
-		double sum = 0;
-		while ((i < this->candidate_edge_buf.size() - 1) &&
-		       (sum + std::get<0>(this->candidate_edge_buf.at(i)) < point)) {
-			sum += std::get<0>(this->candidate_edge_buf.at(i));
-			i++;
-		}
+		i = this->candidate_score_tree.find(point);
 	} else {
 		std::uniform_int_distribution<size_t> distr(
 		    0, this->candidate_edge_buf.size() - 1);
 		i = distr(this->rnd);
 	}
 
+	// Sample anyways, so that the replay does the same work and consumes the
+	// same random numbers as the recorded run.
+	if (this->replaying && !this->replay_diverged) {
+		i = this->replay_edge_index(i);
+	}
+
 	Job::JobId s;
 	Job::JobId t;
 
@@ -1911,6 +2284,10 @@ SWAGSolver<use_mes, use_eps>::iteration_insert_edge(
 		t = this->candidate_edge_buf.at(i).second;
 	}
 
+	if (!this->record_trace_file.empty()) {
+		this->trace.record(this->iteration_count, DecisionTrace::Kind::EDGE, s, t);
+	}
+
 	bool inserted = false;
 	// Make sure they still overlap
 	if ((this->earliest_starts[s] <
@@ -1940,7 +2317,9 @@ SWAGSolver<use_mes, use_eps>::iteration_insert_edge(
 	// Remove edge from candidates
 	if constexpr (use_mes || use_eps) {
 		auto edge_score = std::get<0>(this->candidate_edge_buf.at(i));
-		this->score_sum -= edge_score;
+		auto last_score = std::get<0>(this->candidate_edge_buf.back());
+		this->candidate_score_tree.add(i, last_score - edge_score);
+		this->candidate_score_tree.pop_back();
 	}
 	std::swap(this->candidate_edge_buf.at(i), this->candidate_edge_buf.back());
 	this->candidate_edge_buf.pop_back();
@@ -2420,6 +2799,187 @@ SWAGSolver<use_mes, use_eps>::get_solution()
 	return Solution(this->instance, false, this->best_start_times, {});
 }
 
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::set_incumbent_exchange(
+    manager::IncumbentExchange * exchange_in) noexcept
+{
+	this->exchange = exchange_in;
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::set_checkpoint(
+    manager::Checkpoint * checkpoint_in) noexcept
+{
+	if (!this->record_trace_file.empty() || this->replaying) {
+		BOOST_LOG(l.w()) << "Traces must cover complete runs, not using the "
+		                    "checkpoint.";
+		// Neither resume from an earlier attempt nor count its time
+		checkpoint_in->discard();
+		return;
+	}
+	this->checkpoint = checkpoint_in;
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::save_checkpoint()
+{
+	manager::CheckpointWriter out;
+
+	out.write((uint64_t)this->job_count);
+
+	out.write((uint64_t)this->iteration_count);
+	out.write((uint64_t)this->insertion_count);
+	out.write((uint64_t)this->solution_count);
+	out.write((uint64_t)this->deletion_count);
+	out.write((uint64_t)this->reset_count);
+	out.write((uint64_t)this->deletions_remaining);
+	out.write((uint64_t)this->last_complete_push);
+	out.write((uint64_t)this->last_range_check);
+
+	out.write(this->best_score);
+	out.write(this->best_start_times);
+
+	// The current graph and its (partially) propagated times
+	out.write(this->earliest_starts);
+	out.write(this->latest_finishs);
+	out.write(this->push_es_forward_out_of_range);
+	out.write(this->push_lf_backward_out_of_range);
+	for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
+		out.write(this->adjacency_list[jid]);
+		out.write(this->rev_adjacency_list[jid]);
+	}
+
+	out.write(this->rnd);
+
+	if constexpr (use_mes) {
+		this->mes.save(out);
+	}
+	if constexpr (use_eps) {
+		this->eps.save(out);
+	}
+
+	this->checkpoint->write(out, this->run_timer.get());
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::resume_from_checkpoint()
+{
+	manager::CheckpointReader in = this->checkpoint->resume();
+
+	uint64_t stored_job_count = 0;
+	in.read(stored_job_count);
+
+	uint64_t counts[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	for (uint64_t & count : counts) {
+		in.read(count);
+	}
+
+	in.read(this->best_score);
+	in.read(this->best_start_times);
+
+	in.read(this->earliest_starts);
+	in.read(this->latest_finishs);
+	in.read(this->push_es_forward_out_of_range);
+	in.read(this->push_lf_backward_out_of_range);
+	if (stored_job_count == this->job_count) {
+		for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
+			in.read(this->adjacency_list[jid]);
+			in.read(this->rev_adjacency_list[jid]);
+		}
+	}
+
+	in.read(this->rnd);
+
+	if constexpr (use_mes) {
+		this->mes.load(in);
+	}
+	if constexpr (use_eps) {
+		this->eps.load(in);
+	}
+
+	if (!in.good() || !in.at_end() || (stored_job_count != this->job_count) ||
+	    (this->best_start_times.size() != this->job_count) ||
+	    (this->earliest_starts.size() != this->job_count) ||
+	    (this->latest_finishs.size() != this->job_count)) {
+		BOOST_LOG(l.e()) << "Checkpoint " << this->checkpoint->get_path()
+		                 << " does not fit this instance and configuration.";
+		throw IOError(this->instance, this->sconf.get_seed(),
+		              FAULT_CHECKPOINT_FAILED,
+		              "Could not resume SWAG from checkpoint " +
+		                  this->checkpoint->get_path());
+	}
+
+	this->iteration_count = (size_t)counts[0];
+	this->insertion_count = (size_t)counts[1];
+	this->solution_count = (size_t)counts[2];
+	this->deletion_count = (size_t)counts[3];
+	this->reset_count = (size_t)counts[4];
+	this->deletions_remaining = (size_t)counts[5];
+	this->last_complete_push = (size_t)counts[6];
+	this->last_range_check = (size_t)counts[7];
+
+	for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
+		this->rsl.set_pos(jid, (int)this->earliest_starts[jid]);
+	}
+	this->active_range = this->rsl.get_maximum_range();
+	this->active_range_version = this->rsl.get_maximum_range_version();
+
+	// Continue the clock where the interrupted run stopped
+	this->run_timer.start_at(this->checkpoint->get_previous_elapsed());
+	this->last_log_time = this->run_timer.get();
+	this->last_log_iteration = this->iteration_count;
+	this->intermediate_score_last_time = this->run_timer.get();
+
+	// Candidates are not part of the checkpoint
+	this->iteration_regenerate_candidates();
+
+	BOOST_LOG(l.i()) << "Resumed at iteration " << this->iteration_count
+	                 << " with best score " << this->best_score;
+}
+
+template <bool use_mes, bool use_eps>
+void
+SWAGSolver<use_mes, use_eps>::synchronize() noexcept
+{
+	std::vector<unsigned int> incumbent;
+	double incumbent_costs;
+	if (!this->exchange->fetch(
+	        AdditionalResultStorage::IntermediateResult::SOURCE_HEURISTIC,
+	        this->exchange_version, incumbent, incumbent_costs)) {
+		return;
+	}
+
+	/* SWAG's state is the set of inserted edges, which cannot be recovered from
+	 * a schedule. We can't restart the search from the incumbent, but we adopt
+	 * it as our best solution so that we only report improvements on it. */
+	std::vector<std::pair<unsigned int, double>> events;
+	events.reserve(2 * this->job_count);
+	for (Job::JobId jid = 0; jid < this->job_count; ++jid) {
+		double usage = this->instance.get_job(jid).get_resource_usage(0);
+		events.emplace_back(incumbent[jid], usage);
+		events.emplace_back(incumbent[jid] + this->durations[jid], -usage);
+	}
+	// Jobs ending at t do not overlap with the jobs starting at t
+	std::sort(events.begin(), events.end());
+
+	double usage = 0;
+	double peak = 0;
+	for (const auto & [time, delta] : events) {
+		(void)time;
+		usage += delta;
+		peak = std::max(peak, usage);
+	}
+
+	BOOST_LOG(l.d(2)) << "Adopting external incumbent with costs "
+	                  << incumbent_costs;
+	this->best_score = peak;
+	this->best_start_times = std::move(incumbent);
+}
+
 } // namespace detail
 
 /**********************************
@@ -2464,6 +3024,38 @@ SWAGSolver::run()
 	}
 }
 
+void
+SWAGSolver::set_incumbent_exchange(
+    manager::IncumbentExchange * exchange) noexcept
+{
+	std::get<0>(this->impl).set_incumbent_exchange(exchange);
+	std::get<1>(this->impl).set_incumbent_exchange(exchange);
+	std::get<2>(this->impl).set_incumbent_exchange(exchange);
+	std::get<3>(this->impl).set_incumbent_exchange(exchange);
+}
+
+void
+SWAGSolver::set_checkpoint(manager::Checkpoint * checkpoint) noexcept
+{
+	// Only the one that runs ever uses it
+	switch (this->impl_index) {
+	case 0:
+		std::get<0>(this->impl).set_checkpoint(checkpoint);
+		break;
+	case 1:
+		std::get<1>(this->impl).set_checkpoint(checkpoint);
+		break;
+	case 2:
+		std::get<2>(this->impl).set_checkpoint(checkpoint);
+		break;
+	case 3:
+		std::get<3>(this->impl).set_checkpoint(checkpoint);
+		break;
+	default:
+		assert(false);
+	}
+}
+
 Solution
 SWAGSolver::get_solution()
 {
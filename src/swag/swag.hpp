@@ -1,18 +1,25 @@
 #ifndef TCPSPSUITE_SWAG_HPP
 #define TCPSPSUITE_SWAG_HPP
 
+#include "../datastructures/bucket_arena.hpp"    // for BucketArena
+#include "../datastructures/circular_vector.hpp" // for CircularVector
 #include "../datastructures/fast_reset_vector.hpp"
+#include "../datastructures/fenwick_tree.hpp"    // for FenwickTree
 #include "../datastructures/skyline_interface.hpp" // for Sky...
 #include "../instance/job.hpp"                     // for Job
 #include "../instance/solution.hpp"                // for Sol...
 #include "../instance/traits.hpp"
+#include "../manager/phaseprofiler.hpp" // for PhaseProfiler
 #include "../manager/solvers.hpp" // for get...
 #include "../manager/timer.hpp"   // for Timer
 #include "../util/log.hpp"        // for Log
+#include "../util/workerpool.hpp" // for WorkerPool
+#include "decisiontrace.hpp"
 #include "elitepoolscorer.hpp"
 #include "matrixedgescorer.hpp"
 
 #include <bitset>
+#include <memory>   // for unique_ptr
 #include <random>   // for mt1...
 #include <stddef.h> // for size_t
 #include <string>   // for string
@@ -23,6 +30,10 @@
 class AdditionalResultStorage;
 class Instance;
 class SolverConfig;
+namespace manager {
+class IncumbentExchange;
+class Checkpoint;
+} // namespace manager
 namespace solvers {
 template <unsigned int>
 struct registry_hook;
@@ -99,6 +110,8 @@ public:
 	           const SolverConfig & sconf);
 	void run();
 	Solution get_solution();
+	void set_incumbent_exchange(manager::IncumbentExchange * exchange) noexcept;
+	void set_checkpoint(manager::Checkpoint * checkpoint) noexcept;
 
 	void dbg_verify();
 
@@ -121,6 +134,16 @@ private:
 	void push_lf_backward(bool force_complete, bool range_changed) noexcept;
 	void rebuild_lf_backward() noexcept;
 
+	/* Level-synchronous parallel versions of the complete pushes. They process
+	 * the respective queue in rounds until it is smaller than
+	 * parallel_propagation_threshold, and leave the rest in the queue for the
+	 * sequential loop. */
+	void push_es_forward_parallel() noexcept;
+	void push_lf_backward_parallel() noexcept;
+	template <class Relax>
+	void propagate_parallel(std::vector<Job::JobId> & queue, bool record_changes,
+	                        Relax && relax) noexcept;
+
 	void insert_edge(Job::JobId s, Job::JobId t, bool force_complete) noexcept;
 
 	void delete_edge(Edge * e) noexcept;
@@ -130,14 +153,33 @@ private:
 	void iteration_regenerate_candidates() noexcept;
 	void iteration_unstick() noexcept;
 	void iteration_propagate(bool complete, bool range_changed) noexcept;
+	/* Adopts the skyline's current maximum range as active range if it has
+	 * moved since the last call. Returns whether it moved. */
+	bool refresh_active_range() noexcept;
 	void iteration() noexcept;
 	void reset() noexcept;
+	bool keep_running() noexcept;
+
+	/* Record / replay. trace_checkpoint() records an event or, when
+	 * replaying, verifies that the recorded run did the same. */
+	void trace_checkpoint(DecisionTrace::Kind kind, unsigned int a,
+	                      unsigned int b) noexcept;
+	size_t replay_edge_index(size_t sampled_index) noexcept;
+	void replay_diverge() noexcept;
+
+	/* Adopts better incumbents found by the other side of the exchange. */
+	void synchronize() noexcept;
+
+	/* Checkpointing. Candidates are not saved, resuming regenerates them. */
+	void save_checkpoint();
+	void resume_from_checkpoint();
 
 	/* Candidate building & selection */
 	void build_candidate_jobs() noexcept;
-	// Returns the score sum
 	void build_candidate_edges() noexcept;
 	void build_candidate_edges_batched() noexcept;
+	// Clears candidate_edge_buf together with candidate_score_tree
+	void clear_candidate_edges() noexcept;
 	size_t batch_offset;
 
 	// Force-Creates new candidates by deleting edges
@@ -172,6 +214,7 @@ private:
 	const SolverConfig & sconf;
 	AdditionalResultStorage & additional;
 	bool disaggregate_time;
+	bool profile_counters;
 	double intermediate_interval;
 	double intermediate_score_interval;
 	size_t deletion_trials;
@@ -182,6 +225,22 @@ private:
 	bool randomize_edge_candidates;
 	size_t edge_candidate_batchsize;
 	double deletion_undermove_penalty;
+	// If nonzero, run exactly this many iterations instead of until the time
+	// limit, which makes the run deterministic for a given seed.
+	size_t iteration_limit;
+	// Complete pushes of at least this many jobs are done in parallel, if
+	// there is more than one propagation thread. Zero disables parallel
+	// propagation.
+	size_t parallel_propagation_threshold;
+	// At most the number of threads per run (--threads), which is what a run
+	// is pinned to
+	unsigned int propagation_threads;
+
+	/* Record / replay */
+	std::string record_trace_file;
+	bool replaying;
+	bool replay_diverged;
+	DecisionTrace trace;
 
 	size_t deletions_remaining;
 	size_t last_complete_push;
@@ -204,12 +263,17 @@ private:
 	double best_score;
 	std::vector<unsigned int> best_start_times;
 
+	/* Sharing incumbents with a concurrently running MIP */
+	manager::IncumbentExchange * exchange;
+	size_t exchange_version;
+
+	manager::Checkpoint * checkpoint;
+
 	std::mt19937 rnd;
 
 	/* Scoring */
 	utilities::OptionalMember<MatrixEdgeScorer, use_mes> mes;
 	utilities::OptionalMember<ElitePoolScorer, use_eps> eps;
-	double score_sum;
 
 	/* Statistics - Counts */
 	size_t iteration_count;
@@ -218,13 +282,18 @@ private:
 	size_t deletion_count;
 	size_t reset_count;
 
-	/* Statistics - Times */
-	double skyline_update_time;
-	double propagate_time;
-	double reset_time;
-	double job_selection_time;
-	double edge_selection_time;
-	double unstick_time;
+	/* Statistics - Times, only collected with disaggregate_time. Must match
+	 * the phase names passed to the profiler. */
+	enum Phase {
+		PHASE_SKYLINE_UPDATE = 0,
+		PHASE_PROPAGATE,
+		PHASE_RESET,
+		PHASE_JOB_SELECTION,
+		PHASE_EDGE_SELECTION,
+		PHASE_UNSTICK,
+		PHASE_DELETION_PROPAGATE
+	};
+	PhaseProfiler profiler;
 
 	// Periodic logging
 	Timer log_timer;
@@ -247,9 +316,24 @@ private:
 	    std::vector<std::tuple<double, Job::JobId, Job::JobId>>,
 	    std::vector<std::pair<Job::JobId, Job::JobId>>, use_mes || use_eps>
 	    candidate_edge_buf;
-	std::vector<std::pair<Job::JobId, unsigned int>> active_jobs_buf;
+	/* Scores of candidate_edge_buf for weighted sampling. Built lazily on the
+	 * first draw, cleared whenever candidates are (re-)generated. */
+	ds::FenwickTree<double> candidate_score_tree;
+	/* The jobs still running during the build_candidate_edges() sweep, as
+	 * structure of arrays so that a job can be compared against all of them
+	 * with vector instructions. Per job: its end (earliest start + duration)
+	 * and its latest start (latest finish - duration). */
+	std::vector<Job::JobId> active_jids_buf;
+	std::vector<int> active_ends_buf;
+	std::vector<int> active_latest_starts_buf;
+	// Bucket sort of candidates_buf by earliest start
+	std::vector<unsigned int> start_buckets_buf;
+	std::vector<Job::JobId> sorted_candidates_buf;
+	void sort_candidates_by_start() noexcept;
 
 	std::pair<unsigned int, unsigned int> active_range;
+	// Skyline range version that active_range corresponds to
+	size_t active_range_version;
 
 	// TODO change queues to circular vector?
 	std::vector<Job::JobId> push_lf_backward_queue;
@@ -264,21 +348,31 @@ private:
 	std::vector<Job::JobId> changed_nodes_buf;
 	FastResetVector<bool> node_moved_buf;
 
+	/* Parallel propagation. Only set up if used. */
+	std::unique_ptr<util::WorkerPool> propagation_workers;
+	// One buffer per worker for the jobs it enqueued for the next round
+	std::vector<std::vector<Job::JobId>> frontier_next_bufs;
+	// Whether a job is already enqueued for the next round
+	std::vector<unsigned char> frontier_flags;
+
 	/*
-	 * Bulk deletion buffers
+	 * Bulk deletion buffers. All of them are cleared in constant time, and
+	 * only the used buckets are visited.
 	 */
-	// forward_deletion_buckets[s] stores the list of indices into
-	// adjacency_list[s] that should be deleted
-	std::vector<std::vector<size_t>> forward_deletion_buckets;
-	// reverse_deletion_buckets[t] stores the list of indices into
-	// rev_adjacency_list[t] that should be deleted
-	std::vector<std::vector<size_t>> reverse_deletion_buckets;
-	// forward_pointers_changed[s] stores (edge_index, new_rev_index), where
+	// Bucket s stores the indices into adjacency_list[s] that should be
+	// deleted
+	ds::BucketArena<size_t> forward_deletion_buckets;
+	// Bucket t stores the indices into rev_adjacency_list[t] that should be
+	// deleted
+	ds::BucketArena<size_t> reverse_deletion_buckets;
+	// Bucket s stores (edge_index, new_rev_index), where
 	// adjacency_list[s][edge_index].rev_index should be new_rev_index
-	std::vector<std::vector<std::pair<size_t, size_t>>> forward_pointers_changed;
-	// reverse_pointers_changed[t] stores (edge_index, new_forward_index), where
+	ds::BucketArena<std::pair<size_t, size_t>> forward_pointers_changed;
+	// Bucket t stores (edge_index, new_forward_index), where
 	// rev_adj_list[t][edge_index].forward_index should be new_forward_index
-	std::vector<std::vector<std::pair<size_t, size_t>>> reverse_pointers_changed;
+	ds::BucketArena<std::pair<size_t, size_t>> reverse_pointers_changed;
+	// The deletion indices of one bucket, to be sorted
+	std::vector<size_t> deletion_indices_buf;
 
 	/* Edge-deletion related buffers
 	 *
@@ -323,13 +417,8 @@ private:
 	std::vector<Job::JobId> edgedel_sorted_by_start_buf;
 	std::vector<Job::JobId> edgedel_sorted_by_end_buf;
 
-	/* TODO FIXME DEBUG */
-	// CircularVector<EdgeBFSEntry> bfs_buf;
-	std::deque<EdgeBFSEntry> bfs_buf;
-	std::deque<Job::JobId> rebuild_queue;
-	//	CircularVector<Job::JobId> rebuild_queue;
-	// std::vector<EdgeBFSEntry> bfs_buf;
-	// std::vector<Job::JobId> rebuild_queue;
+	CircularVector<EdgeBFSEntry> bfs_buf;
+	CircularVector<Job::JobId> rebuild_queue;
 
 	std::vector<Edge *> bfs_pruned_buffer;
 	std::vector<Job::JobId> bfs_ran_out_of_buffer; // TODO do we still need this?
@@ -355,6 +444,16 @@ public:
 	Maybe<double> get_lower_bound();
 	static const Traits & get_requirements();
 
+	/* Shares incumbents with other solvers running concurrently. SWAG offers
+	 * its best solutions, adopts better ones as its result and stops as soon as
+	 * the exchange asks it to. The exchange must outlive run(). */
+	void set_incumbent_exchange(manager::IncumbentExchange * exchange) noexcept;
+
+	/* Periodically saves the search state to the checkpoint, and continues from
+	 * the state stored in it if there is one. The checkpoint must outlive
+	 * run(). */
+	void set_checkpoint(manager::Checkpoint * checkpoint) noexcept;
+
 private:
 	size_t impl_index;
 	static const Traits required_traits;
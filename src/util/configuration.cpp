@@ -99,6 +99,19 @@ Configuration::parse_cmdline(int argc, const char ** argv)
 	  ("thread-check-time", po::value<double>(), "Setting this to <seconds> causes TCPSPSuite to periodically"
 	          "check whether all threads are still alive. A thread is considered to be alive if it completed"
 	          " a result within the last <seconds> seconds. This is mainly useful for debugging purposes.")
+	  ("memory-budget", po::value<unsigned long>(), "Sets a memory budget of <MiB> mebibytes for "
+	          "parallel runs. Every task's peak memory usage is estimated from the instance size, the "
+	          "solver and earlier measurements in the database. A task is only started if its estimate "
+	          "fits into the remaining budget, otherwise it is deferred until enough memory is freed.")
+	  ("isolate-processes", "Runs every one of the -p parallel workers in a separate process instead "
+	          "of a thread. A crashing or out-of-memory-killed solver then only loses its current task, "
+	          "which is recorded as an error in the database, and memory metrics are exact per process.")
+	  ("checkpoint-dir", po::value<std::string>(), "Sets <ckptdir> as path to the checkpoint directory. "
+	          "If this is given, solvers that support it periodically save their state there. If TCPSPSuite "
+	          "is interrupted and re-launched with the same run ID, these solvers continue from their "
+	          "last checkpoint instead of starting over.")
+	  ("checkpoint-interval", po::value<double>(), "Sets the time in seconds between two checkpoints "
+	          "of a solver. Only meaningful with --checkpoint-dir. Defaults to 300.")
       ;
 	// clang-format on
 
@@ -216,6 +229,22 @@ Configuration::parse_cmdline(int argc, const char ** argv)
 		this->thread_check_time = vm["thread-check-time"].as<double>();
 	}
 
+	if (vm.count("memory-budget")) {
+		this->memory_budget = vm["memory-budget"].as<unsigned long>();
+	}
+
+	if (vm.count("isolate-processes")) {
+		this->isolate_processes = true;
+	}
+
+	if (vm.count("checkpoint-dir")) {
+		this->checkpoint_dir = vm["checkpoint-dir"].as<std::string>();
+	}
+
+	if (vm.count("checkpoint-interval")) {
+		this->checkpoint_interval = vm["checkpoint-interval"].as<double>();
+	}
+
 	if (this->partition_count.valid() != this->partition_number.valid()) {
 		BOOST_LOG(l.e())
 		    << "You must set both --partition-count and --partition-number!";
@@ -245,6 +274,10 @@ Configuration::set_defaults()
 	this->global_seed = {};
 	this->log_dir = {};
 	this->result_dir = {};
+	this->memory_budget = {};
+	this->isolate_processes = false;
+	this->checkpoint_dir = {};
+	this->checkpoint_interval = 300;
 }
 
 void
@@ -481,4 +514,52 @@ Configuration::get_thread_check_time() const
 	return this->thread_check_time;
 }
 
+void
+Configuration::set_memory_budget(Maybe<unsigned long> mib)
+{
+	this->memory_budget = mib;
+}
+
+Maybe<unsigned long>
+Configuration::get_memory_budget() const
+{
+	return this->memory_budget;
+}
+
+void
+Configuration::set_isolate_processes(bool isolate)
+{
+	this->isolate_processes = isolate;
+}
+
+bool
+Configuration::get_isolate_processes() const
+{
+	return this->isolate_processes;
+}
+
+void
+Configuration::set_checkpoint_dir(Maybe<std::string> path)
+{
+	this->checkpoint_dir = path;
+}
+
+const Maybe<std::string> &
+Configuration::get_checkpoint_dir() const
+{
+	return this->checkpoint_dir;
+}
+
+void
+Configuration::set_checkpoint_interval(double seconds)
+{
+	this->checkpoint_interval = seconds;
+}
+
+double
+Configuration::get_checkpoint_interval() const
+{
+	return this->checkpoint_interval;
+}
+
 Configuration * Configuration::instance = nullptr;
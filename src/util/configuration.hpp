@@ -138,6 +138,18 @@ public:
 	void set_thread_check_time(Maybe<double> seconds);
 	Maybe<double> get_thread_check_time() const;
 
+	void set_memory_budget(Maybe<unsigned long> mib);
+	Maybe<unsigned long> get_memory_budget() const;
+
+	void set_isolate_processes(bool isolate);
+	bool get_isolate_processes() const;
+
+	void set_checkpoint_dir(Maybe<std::string> path);
+	const Maybe<std::string> & get_checkpoint_dir() const;
+
+	void set_checkpoint_interval(double seconds);
+	double get_checkpoint_interval() const;
+
 	Configuration(const Configuration &) = delete;
 
 private:
@@ -168,6 +180,10 @@ private:
 	Maybe<unsigned int> partition_number;
 	bool skip_oom;
 	Maybe<double> thread_check_time;
+	Maybe<unsigned long> memory_budget;
+	bool isolate_processes;
+	Maybe<std::string> checkpoint_dir;
+	double checkpoint_interval;
 
 	std::vector<SolverConfig> solver_cfgs;
 
@@ -16,4 +16,9 @@
 #define FAULT_DATABASE_FAILED							13
 #define FAULT_OUT_OF_MEMORY               14
 #define FAULT_WINDOW_EXTENSION_HARD_DEADLINE    15
+#define FAULT_WORKER_CRASHED              16
+#define FAULT_TRACE_FILE_FAILED           17
+#define FAULT_CHECKPOINT_FAILED           18
+#define FAULT_WORKER_EXCEPTION            19
+#define FAULT_TRACE_RECORD_AND_REPLAY     20
 #endif
@@ -0,0 +1,125 @@
+#include "threadgroup.hpp"
+
+#include <algorithm>      // for max
+#include <sys/resource.h> // for getrusage
+#include <sys/time.h>     // for timeval
+#include <utility>        // for move
+
+#ifdef INSTRUMENT_MALLOC
+#include <contrib/tbingmann/malloc_tracker.hpp>
+#endif
+
+namespace util {
+
+namespace {
+thread_local std::shared_ptr<ThreadGroup> current_group;
+} // namespace
+
+std::shared_ptr<ThreadGroup>
+ThreadGroup::current()
+{
+	return current_group;
+}
+
+ThreadGroup::Usage
+ThreadGroup::measure_calling_thread() noexcept
+{
+	Usage measured;
+
+	struct rusage usage;
+	if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+		measured.minor_pagefaults = static_cast<size_t>(usage.ru_minflt);
+		measured.major_pagefaults = static_cast<size_t>(usage.ru_majflt);
+		measured.user_usecs = static_cast<unsigned long>(
+		    (usage.ru_utime.tv_sec * 1000000) + usage.ru_utime.tv_usec);
+		measured.system_usecs = static_cast<unsigned long>(
+		    (usage.ru_stime.tv_sec * 1000000) + usage.ru_stime.tv_usec);
+	}
+
+#ifdef INSTRUMENT_MALLOC
+	measured.malloc_count =
+	    static_cast<size_t>(thrill::mem::malloc_tracker_thread_total_allocs());
+#endif
+
+	return measured;
+}
+
+ThreadGroup::Membership::Membership(std::shared_ptr<ThreadGroup> group_in)
+    : group(std::move(group_in))
+{
+	if (!this->group) {
+		return;
+	}
+
+	this->previous = current_group;
+	current_group = this->group;
+	this->group->join();
+
+	this->before = ThreadGroup::measure_calling_thread();
+#ifdef INSTRUMENT_MALLOC
+	thrill::mem::malloc_tracker_thread_reset_peak();
+	this->malloc_current_before = thrill::mem::malloc_tracker_thread_current();
+#endif
+}
+
+ThreadGroup::Membership::~Membership()
+{
+	if (!this->group) {
+		return;
+	}
+
+	Usage after = ThreadGroup::measure_calling_thread();
+	Usage used;
+	used.minor_pagefaults = after.minor_pagefaults - this->before.minor_pagefaults;
+	used.major_pagefaults = after.major_pagefaults - this->before.major_pagefaults;
+	used.user_usecs = after.user_usecs - this->before.user_usecs;
+	used.system_usecs = after.system_usecs - this->before.system_usecs;
+#ifdef INSTRUMENT_MALLOC
+	used.malloc_count = after.malloc_count - this->before.malloc_count;
+	// Only what this thread allocated on top of what it held when joining
+	used.malloc_peak = (size_t)std::max(
+	    (ssize_t)0, thrill::mem::malloc_tracker_thread_peak() -
+	                    this->malloc_current_before);
+#endif
+
+	this->group->leave(used);
+	current_group = std::move(this->previous);
+}
+
+void
+ThreadGroup::join()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->member_count++;
+}
+
+void
+ThreadGroup::leave(const Usage & used)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->member_count--;
+	this->usage.minor_pagefaults += used.minor_pagefaults;
+	this->usage.major_pagefaults += used.major_pagefaults;
+	this->usage.user_usecs += used.user_usecs;
+	this->usage.system_usecs += used.system_usecs;
+#ifdef INSTRUMENT_MALLOC
+	this->usage.malloc_count += used.malloc_count;
+	this->usage.malloc_peak += used.malloc_peak;
+#endif
+}
+
+ThreadGroup::Usage
+ThreadGroup::get_usage() const
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->usage;
+}
+
+size_t
+ThreadGroup::get_member_count() const
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->member_count;
+}
+
+} // namespace util
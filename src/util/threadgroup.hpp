@@ -0,0 +1,80 @@
+#ifndef THREADGROUP_HPP
+#define THREADGROUP_HPP
+
+#include "generated_config.hpp"
+
+#include <cstddef>     // for size_t
+#include <memory>      // for shared_ptr
+#include <mutex>       // for mutex
+#include <sys/types.h> // for ssize_t
+
+namespace util {
+
+/* The threads that work on one solver run, for per-thread resource
+ * measurements (see manager::LinuxMemoryInfo).
+ *
+ * A thread joins a group by creating a Membership and leaves it when the
+ * Membership is destroyed. On leaving, it adds the page faults, CPU times and
+ * (with INSTRUMENT_MALLOC) allocations it caused as a member to the group.
+ * Code that starts threads for a solver (WorkerPool, the MIP portfolio
+ * thread) makes them join the group of the thread that starts them, see
+ * current().
+ *
+ * Only threads that have left are part of get_usage(). Threads started by
+ * third-party libraries (e.g., inside a MIP solver) can not join.
+ */
+class ThreadGroup {
+public:
+	struct Usage
+	{
+		size_t minor_pagefaults = 0;
+		size_t major_pagefaults = 0;
+		unsigned long user_usecs = 0;
+		unsigned long system_usecs = 0;
+#ifdef INSTRUMENT_MALLOC
+		size_t malloc_count = 0;
+		// The sum of the members' peaks, i.e., an upper bound for the peak of
+		// the whole group
+		size_t malloc_peak = 0;
+#endif
+	};
+
+	class Membership {
+	public:
+		/* A null group is allowed, the membership does nothing then. */
+		explicit Membership(std::shared_ptr<ThreadGroup> group);
+		~Membership();
+
+		Membership(const Membership &) = delete;
+		Membership & operator=(const Membership &) = delete;
+
+	private:
+		std::shared_ptr<ThreadGroup> group;
+		std::shared_ptr<ThreadGroup> previous;
+		Usage before;
+#ifdef INSTRUMENT_MALLOC
+		ssize_t malloc_current_before;
+#endif
+	};
+
+	/* The group the calling thread is a member of, or null. */
+	static std::shared_ptr<ThreadGroup> current();
+
+	Usage get_usage() const;
+	/* Number of threads that are members right now. */
+	size_t get_member_count() const;
+
+private:
+	static Usage measure_calling_thread() noexcept;
+
+	void join();
+	void leave(const Usage & used);
+
+	mutable std::mutex mutex;
+	Usage usage;
+	size_t member_count = 0;
+};
+
+} // namespace util
+
+#endif
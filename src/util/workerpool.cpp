@@ -0,0 +1,99 @@
+#include "workerpool.hpp"
+
+#include "threadgroup.hpp" // for ThreadGroup
+
+#include <algorithm> // for max
+
+namespace util {
+
+WorkerPool::WorkerPool(unsigned int thread_count_in)
+    : thread_count(std::max(1u, thread_count_in)), generation(0), running(0),
+      stopping(false), job(nullptr)
+{}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->start_cv.notify_all();
+
+	for (std::thread & thread : this->threads) {
+		thread.join();
+	}
+}
+
+void
+WorkerPool::start_threads()
+{
+	// The workers' resource usage counts towards the run that owns the pool
+	std::shared_ptr<ThreadGroup> group = ThreadGroup::current();
+	for (unsigned int worker = 1; worker < this->thread_count; ++worker) {
+		this->threads.emplace_back([this, worker, group]() {
+			ThreadGroup::Membership membership(group);
+			this->work(worker);
+		});
+	}
+}
+
+void
+WorkerPool::run(const std::function<void(unsigned int)> & fn)
+{
+	if (this->thread_count == 1) {
+		fn(0);
+		return;
+	}
+
+	if (this->threads.empty()) {
+		this->start_threads();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->job = &fn;
+		this->running = this->thread_count - 1;
+		this->generation++;
+	}
+	this->start_cv.notify_all();
+
+	fn(0);
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->done_cv.wait(lock, [&] { return this->running == 0; });
+	this->job = nullptr;
+}
+
+void
+WorkerPool::work(unsigned int worker)
+{
+	size_t seen_generation = 0;
+
+	while (true) {
+		const std::function<void(unsigned int)> * current_job;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->start_cv.wait(lock, [&] {
+				return this->stopping || (this->generation != seen_generation);
+			});
+			if (this->stopping) {
+				return;
+			}
+			seen_generation = this->generation;
+			current_job = this->job;
+		}
+
+		(*current_job)(worker);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			last = (--this->running == 0);
+		}
+		if (last) {
+			this->done_cv.notify_one();
+		}
+	}
+}
+
+} // namespace util
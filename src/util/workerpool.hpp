@@ -0,0 +1,64 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <condition_variable> // for condition_variable
+#include <cstddef>            // for size_t
+#include <functional>         // for function
+#include <mutex>              // for mutex
+#include <thread>             // for thread
+#include <vector>             // for vector
+
+namespace util {
+
+/* A fixed set of threads for fork-join parallelism inside an algorithm.
+ *
+ * run() calls the given function once on every worker and returns when all
+ * of them are done. The calling thread is worker 0, so a pool of one thread
+ * never spawns anything. In between two calls, the threads sleep, so a pool
+ * can be kept for the whole run of a solver and used for many short parallel
+ * sections. Threads are only started on the first call of run().
+ *
+ * Everything that the workers wrote is visible to the caller after run()
+ * returns, and everything the caller wrote before run() is visible to the
+ * workers.
+ *
+ * The threads join the ThreadGroup of the thread that first calls run(). Their
+ * resource usage is only counted once the pool is destroyed.
+ */
+class WorkerPool {
+public:
+	explicit WorkerPool(unsigned int thread_count);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool & operator=(const WorkerPool &) = delete;
+
+	unsigned int
+	get_thread_count() const noexcept
+	{
+		return this->thread_count;
+	}
+
+	/* Calls fn(worker_index) for every worker index in [0, thread count). */
+	void run(const std::function<void(unsigned int)> & fn);
+
+private:
+	void start_threads();
+	void work(unsigned int worker);
+
+	unsigned int thread_count;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable start_cv;
+	std::condition_variable done_cv;
+	// Bumped for every run(), workers wait for it to change
+	size_t generation;
+	unsigned int running;
+	bool stopping;
+	const std::function<void(unsigned int)> * job;
+};
+
+} // namespace util
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef TCPSPSUITE_TEST_APLP_HPP
+#define TCPSPSUITE_TEST_APLP_HPP
+
+#include <random>
+
+using namespace testing;
+
+#include "../src/algorithms/graphalgos.hpp"
+#include "../src/instance/instance.hpp"
+#include "../src/instance/job.hpp"
+#include "../src/instance/laggraph.hpp"
+#include "../src/instance/resource.hpp"
+
+namespace test {
+namespace aplp {
+
+constexpr unsigned int TEST_SEED = 4;
+constexpr unsigned int TEST_JOBCOUNT = 300;
+constexpr double TEST_DEP_PROB = 0.01;
+
+// Longest paths by brute force: edges only go from lower to higher IDs.
+std::vector<std::vector<int>>
+longest_paths_by_id(const Instance & ins)
+{
+	const LagGraph & graph = ins.get_laggraph();
+	std::vector<std::vector<int>> result(ins.job_count(),
+	                                     std::vector<int>(ins.job_count(), -1));
+	for (unsigned int s = 0; s < ins.job_count(); ++s) {
+		result[s][s] = 0;
+		for (unsigned int v = s; v < ins.job_count(); ++v) {
+			if (result[s][v] == -1) {
+				continue;
+			}
+			for (const auto & edge : graph.neighbors(v)) {
+				result[s][edge.t] = std::max(result[s][edge.t], result[s][v] + edge.lag);
+			}
+		}
+	}
+	return result;
+}
+
+TEST(APLPTest, AllFormatsAgree)
+{
+	Instance ins;
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	ins.add_resource(std::move(res));
+	std::mt19937 rng(TEST_SEED);
+	std::uniform_int_distribution<unsigned int> duration_distr(1, 10);
+	std::uniform_real_distribution<double> prob_distr(0, 1);
+
+	for (unsigned int id = 0; id < TEST_JOBCOUNT; ++id) {
+		Job j(0, 100000, duration_distr(rng), {1.0}, id);
+		ins.add_job(std::move(j));
+	}
+	for (unsigned int i = 0; i < TEST_JOBCOUNT; ++i) {
+		const Job & job_i = ins.get_job(i);
+		for (unsigned int j = i + 1; j < TEST_JOBCOUNT; ++j) {
+			if (prob_distr(rng) < TEST_DEP_PROB) {
+				ins.get_laggraph().add_edge(
+				    job_i, ins.get_job(j),
+				    {static_cast<int>(job_i.get_duration()), 0, 0});
+			}
+		}
+	}
+
+	auto expected = longest_paths_by_id(ins);
+
+	for (unsigned int threads : {1u, 4u}) {
+		APLPComputer aplp(ins, threads);
+		ASSERT_EQ(aplp.get(), expected);
+
+		LongestPaths sparse = aplp.get_sparse();
+		size_t reachable = 0;
+		for (unsigned int s = 0; s < TEST_JOBCOUNT; ++s) {
+			for (unsigned int t = 0; t < TEST_JOBCOUNT; ++t) {
+				ASSERT_EQ(sparse.get(s, t), expected[s][t]);
+				ASSERT_EQ(aplp.get_path_length(s, t), expected[s][t]);
+				if (expected[s][t] != -1) {
+					reachable++;
+				}
+			}
+			ASSERT_EQ(sparse.get_reachable_count(s),
+			          (size_t)std::count_if(expected[s].begin(), expected[s].end(),
+			                                [](int length) { return length != -1; }));
+		}
+		ASSERT_EQ(sparse.size(), reachable);
+	}
+}
+
+} // namespace aplp
+} // namespace test
+
+#endif
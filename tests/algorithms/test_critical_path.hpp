@@ -0,0 +1,285 @@
+#ifndef TCPSPSUITE_TEST_CRITICAL_PATH_HPP
+#define TCPSPSUITE_TEST_CRITICAL_PATH_HPP
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace testing;
+
+#include "../src/algorithms/graphalgos.hpp"
+#include "../src/instance/instance.hpp"
+#include "../src/instance/job.hpp"
+#include "../src/instance/laggraph.hpp"
+#include "../src/instance/resource.hpp"
+
+namespace test {
+namespace critical_path {
+
+constexpr unsigned int TEST_SEED = 4;
+constexpr unsigned int TEST_JOBCOUNT = 80;
+constexpr unsigned int TEST_OPERATIONS = 3000;
+
+/* Recomputes all times from scratch by relaxing until nothing changes.
+ * Returns false if some window is infeasible. */
+struct Reference
+{
+	std::map<std::pair<unsigned int, unsigned int>, int> edges;
+	std::vector<long> releases;
+	std::vector<long> deadlines;
+	std::vector<long> durations;
+
+	std::vector<long> earliest_starts;
+	std::vector<long> latest_finishs;
+
+	bool
+	compute()
+	{
+		earliest_starts = releases;
+		latest_finishs = deadlines;
+		for (size_t round = 0; round <= releases.size(); ++round) {
+			bool changed = false;
+			for (const auto & [st, lag] : edges) {
+				auto [s, t] = st;
+				if (earliest_starts[s] + lag > earliest_starts[t]) {
+					earliest_starts[t] = earliest_starts[s] + lag;
+					changed = true;
+				}
+				long finish = latest_finishs[t] - durations[t] + durations[s] - lag;
+				if (finish < latest_finishs[s]) {
+					latest_finishs[s] = finish;
+					changed = true;
+				}
+			}
+			if (!changed) {
+				break;
+			}
+			if (round == releases.size()) {
+				return false; // positive cycle
+			}
+		}
+		for (size_t jid = 0; jid < releases.size(); ++jid) {
+			if (earliest_starts[jid] + durations[jid] > latest_finishs[jid]) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+std::vector<unsigned int>
+differing(const std::vector<long> & a, const std::vector<long> & b)
+{
+	std::vector<unsigned int> result;
+	for (unsigned int jid = 0; jid < a.size(); ++jid) {
+		if (a[jid] != b[jid]) {
+			result.push_back(jid);
+		}
+	}
+	return result;
+}
+
+std::vector<unsigned int>
+sorted(std::vector<unsigned int> values)
+{
+	std::sort(values.begin(), values.end());
+	return values;
+}
+
+TEST(CriticalPathTest, IncrementalMatchesRecomputation)
+{
+	std::mt19937 rng(TEST_SEED);
+	std::uniform_int_distribution<unsigned int> job_distr(0, TEST_JOBCOUNT - 1);
+	std::uniform_int_distribution<unsigned int> duration_distr(1, 10);
+	std::uniform_int_distribution<int> op_distr(0, 9);
+
+	Instance ins;
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	ins.add_resource(std::move(res));
+
+	Reference ref;
+	for (unsigned int id = 0; id < TEST_JOBCOUNT; ++id) {
+		unsigned int duration = duration_distr(rng);
+		unsigned int release = duration_distr(rng) * 3;
+		Job j(release, 2000, duration, {1.0}, id);
+		ins.add_job(std::move(j));
+		ref.releases.push_back(release);
+		ref.deadlines.push_back(2000);
+		ref.durations.push_back(duration);
+	}
+	// Initial edges go from lower to higher IDs
+	for (unsigned int i = 0; i < 2 * TEST_JOBCOUNT; ++i) {
+		unsigned int s = job_distr(rng);
+		unsigned int t = job_distr(rng);
+		if (s >= t) {
+			continue;
+		}
+		int lag = (int)ins.get_job(s).get_duration();
+		ins.get_laggraph().add_edge(ins.get_job(s), ins.get_job(t), {lag, 0, 0});
+		ref.edges[{s, t}] = lag;
+	}
+
+	CriticalPathComputer cpc(ins);
+	ASSERT_TRUE(ref.compute());
+	auto expect_times = [&]() {
+		for (unsigned int jid = 0; jid < TEST_JOBCOUNT; ++jid) {
+			ASSERT_EQ(cpc.get_earliest_start(jid), ref.earliest_starts[jid]);
+			ASSERT_EQ(cpc.get_latest_finish(jid), ref.latest_finishs[jid]);
+		}
+	};
+	expect_times();
+
+	unsigned int rejected = 0;
+	for (unsigned int i = 0; i < TEST_OPERATIONS; ++i) {
+		Reference before = ref;
+		int op = op_distr(rng);
+		bool accepted;
+
+		if (op < 5) {
+			unsigned int s = job_distr(rng);
+			unsigned int t = job_distr(rng);
+			if (s == t) {
+				continue;
+			}
+			// Mostly forward. Backward edges make cycles, which must not be
+			// positive.
+			int lag = (s < t) ? (int)duration_distr(rng) * 4
+			                  : -(int)duration_distr(rng) * 40;
+			ref.edges[{s, t}] = lag;
+			accepted = cpc.add_edge(s, t, lag);
+		} else if (op < 8) {
+			if (ref.edges.empty()) {
+				continue;
+			}
+			auto it = ref.edges.begin();
+			std::advance(it, std::uniform_int_distribution<size_t>(
+			                     0, ref.edges.size() - 1)(rng));
+			unsigned int s = it->first.first;
+			unsigned int t = it->first.second;
+			ref.edges.erase(it);
+			ASSERT_TRUE(cpc.remove_edge(s, t));
+			ASSERT_FALSE(cpc.remove_edge(s, t));
+			accepted = true;
+		} else {
+			unsigned int jid = job_distr(rng);
+			long release = ref.releases[jid] + duration_distr(rng);
+			long deadline = ref.deadlines[jid] - 5 * duration_distr(rng);
+			ref.releases[jid] = release;
+			ref.deadlines[jid] = deadline;
+			accepted =
+			    cpc.tighten_window(jid, (unsigned int)release, (unsigned int)deadline);
+		}
+
+		bool feasible = ref.compute();
+		ASSERT_EQ(accepted, feasible);
+		if (!feasible) {
+			rejected++;
+			ref = before;
+			ASSERT_TRUE(ref.compute());
+			expect_times();
+			continue;
+		}
+
+		expect_times();
+		ASSERT_EQ(sorted(cpc.get_changed_earliest_starts()),
+		          differing(before.earliest_starts, ref.earliest_starts));
+		ASSERT_EQ(sorted(cpc.get_changed_latest_finishs()),
+		          differing(before.latest_finishs, ref.latest_finishs));
+	}
+
+	// Both outcomes must have been tested
+	ASSERT_GT(rejected, 0u);
+	ASSERT_LT(rejected, TEST_OPERATIONS / 2);
+}
+
+TEST(CriticalPathTest, CyclesAndExtendedWindows)
+{
+	constexpr unsigned int EXTENSION = 7;
+	constexpr unsigned int HARD_DEADLINE = 1990;
+
+	std::mt19937 rng(TEST_SEED);
+	std::uniform_int_distribution<unsigned int> job_distr(0, TEST_JOBCOUNT - 1);
+	std::uniform_int_distribution<unsigned int> duration_distr(1, 10);
+
+	Instance ins;
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	ins.add_resource(std::move(res));
+
+	Reference ref;
+	for (unsigned int id = 0; id < TEST_JOBCOUNT; ++id) {
+		unsigned int duration = duration_distr(rng);
+		unsigned int release = duration_distr(rng) * 3;
+		ins.add_job(Job(release, 2000, duration, {1.0}, id));
+		ref.releases.push_back(std::max((long)release - (long)EXTENSION, 0l));
+		ref.deadlines.push_back(HARD_DEADLINE);
+		ref.durations.push_back(duration);
+	}
+	// Backward edges with negative lags close cycles of negative length
+	for (unsigned int i = 0; i < 2 * TEST_JOBCOUNT; ++i) {
+		unsigned int s = job_distr(rng);
+		unsigned int t = job_distr(rng);
+		if ((s == t) || (ref.edges.find({s, t}) != ref.edges.end())) {
+			continue;
+		}
+		int lag = (s < t) ? (int)duration_distr(rng) * 4
+		                  : -(int)duration_distr(rng) * 100;
+		ins.get_laggraph().add_edge(ins.get_job(s), ins.get_job(t), {lag, 0, 0});
+		ref.edges[{s, t}] = lag;
+	}
+	ASSERT_TRUE(ref.compute());
+
+	CriticalPathComputer cpc(ins, EXTENSION, HARD_DEADLINE);
+	for (unsigned int jid = 0; jid < TEST_JOBCOUNT; ++jid) {
+		ASSERT_EQ(cpc.get_earliest_start(jid), ref.earliest_starts[jid]);
+		ASSERT_EQ(cpc.get_latest_finish(jid), ref.latest_finishs[jid]);
+	}
+}
+
+TEST(CriticalPathTest, MaximumLagsAreSettled)
+{
+	Instance ins;
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	ins.add_resource(std::move(res));
+	ins.add_job(Job(0, 100, 5, {1.0}, 0));
+	ins.add_job(Job(0, 100, 5, {1.0}, 1));
+	ins.add_job(Job(50, 100, 5, {1.0}, 2));
+
+	// 0 -> 1 -> 2, and 0 may start at most 20 before 2
+	ins.get_laggraph().add_edge(ins.get_job(0), ins.get_job(1), {5, 0, 0});
+	ins.get_laggraph().add_edge(ins.get_job(1), ins.get_job(2), {5, 0, 0});
+	ins.get_laggraph().add_edge(ins.get_job(2), ins.get_job(0), {-20, 0, 0});
+
+	CriticalPathComputer cpc(ins);
+	ASSERT_EQ(cpc.get_forward(), (std::vector<unsigned int>{30, 35, 50}));
+	ASSERT_EQ(cpc.get_reverse(), (std::vector<unsigned int>{90, 95, 100}));
+}
+
+TEST(CriticalPathTest, SelfLoopsAreRejected)
+{
+	Instance ins;
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	ins.add_resource(std::move(res));
+	ins.add_job(Job(0, 100, 10, {1.0}, 0));
+	ins.add_job(Job(5, 100, 10, {1.0}, 1));
+
+	CriticalPathComputer cpc(ins);
+	ASSERT_FALSE(cpc.add_edge(1, 1, 0));
+	ASSERT_FALSE(cpc.add_edge(1, 1, -20));
+	ASSERT_TRUE(cpc.get_changed_earliest_starts().empty());
+	ASSERT_TRUE(cpc.get_changed_latest_finishs().empty());
+	ASSERT_FALSE(cpc.remove_edge(1, 1));
+
+	// The computer stays usable
+	ASSERT_TRUE(cpc.add_edge(0, 1, 10));
+	ASSERT_EQ(cpc.get_earliest_start(1), 10u);
+	ASSERT_EQ(cpc.get_latest_finish(0), 90u);
+}
+
+} // namespace critical_path
+} // namespace test
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef TCPSPSUITE_TEST_GRAPHALGOS_HPP
+#define TCPSPSUITE_TEST_GRAPHALGOS_HPP
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <tuple>
+
+using namespace testing;
+
+#include "../src/algorithms/graphalgos.hpp"
+#include "../src/instance/instance.hpp"
+#include "../src/instance/job.hpp"
+#include "../src/instance/laggraph.hpp"
+#include "../src/instance/resource.hpp"
+
+namespace test {
+namespace graphalgos {
+
+constexpr unsigned int TEST_SEED = 4;
+
+/* A chain through all jobs, plus random edges that skip ahead. This is the
+ * shape of the deepest instances: the DFS depth is the job count. */
+void
+build_deep_instance(Instance & ins, unsigned int job_count,
+                    unsigned int extra_edges, bool shuffle_ids)
+{
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	ins.add_resource(std::move(res));
+
+	std::mt19937 rng(TEST_SEED);
+	for (unsigned int id = 0; id < job_count; ++id) {
+		Job j(0, 10 * job_count, 1, {1.0}, id);
+		ins.add_job(std::move(j));
+	}
+
+	// Position of every job in the chain
+	std::vector<unsigned int> chain(job_count);
+	std::iota(chain.begin(), chain.end(), 0);
+	if (shuffle_ids) {
+		std::shuffle(chain.begin(), chain.end(), rng);
+	}
+
+	for (unsigned int i = 0; i + 1 < job_count; ++i) {
+		ins.get_laggraph().add_edge(ins.get_job(chain[i]), ins.get_job(chain[i + 1]),
+		                            {1, 0, 0});
+	}
+	std::uniform_int_distribution<unsigned int> pos_distr(0, job_count - 1);
+	for (unsigned int i = 0; i < extra_edges; ++i) {
+		unsigned int a = pos_distr(rng);
+		unsigned int b = pos_distr(rng);
+		if (a == b) {
+			continue;
+		}
+		if (a > b) {
+			std::swap(a, b);
+		}
+		ins.get_laggraph().add_edge(ins.get_job(chain[a]), ins.get_job(chain[b]),
+		                            {(int)(b - a), 0, 0});
+	}
+}
+
+bool
+is_topological(const Instance & ins, const std::vector<LagGraph::vertex> & order)
+{
+	if (order.size() != ins.job_count()) {
+		return false;
+	}
+	std::vector<size_t> position(ins.job_count());
+	for (size_t i = 0; i < order.size(); ++i) {
+		position[order[i]] = i;
+	}
+	for (const auto & edge : ins.get_laggraph().edges()) {
+		if (position[edge.s] >= position[edge.t]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+using Event = std::tuple<char, LagGraph::vertex, LagGraph::vertex>;
+
+// The recursive DFS over the LagGraph that the iterative one replaced
+void
+recursive_dfs(const LagGraph & graph, LagGraph::vertex v, LagGraph::vertex from,
+              std::vector<bool> & visited, std::vector<Event> & events)
+{
+	visited[v] = true;
+	events.emplace_back('v', v, from);
+	for (const auto & edge : graph.neighbors(v)) {
+		events.emplace_back('t', v, edge.t);
+		if (!visited[edge.t]) {
+			recursive_dfs(graph, edge.t, v, visited, events);
+		}
+	}
+	events.emplace_back('b', v, v);
+}
+
+std::vector<Event>
+iterative_dfs(const FlatLagGraph & graph, LagGraph::vertex start)
+{
+	std::vector<Event> events;
+	auto visit = [&](LagGraph::vertex v, LagGraph::vertex from) {
+		events.emplace_back('v', v, from);
+		return true;
+	};
+	auto traverse = [&](LagGraph::vertex from, LagGraph::vertex to, int) {
+		events.emplace_back('t', from, to);
+	};
+	auto backtrack = [&](LagGraph::vertex v) { events.emplace_back('b', v, v); };
+	DFS<decltype(visit), decltype(backtrack), decltype(traverse)>(
+	    graph, start, visit, backtrack, traverse);
+	return events;
+}
+
+TEST(GraphAlgosTest, DFSMatchesRecursion)
+{
+	Instance ins;
+	build_deep_instance(ins, 500, 2000, true);
+	FlatLagGraph flat(ins.get_laggraph());
+
+	for (LagGraph::vertex start : {0u, 17u, 499u}) {
+		std::vector<bool> visited(ins.job_count(), false);
+		std::vector<Event> expected;
+		recursive_dfs(ins.get_laggraph(), start, LagGraph::no_vertex, visited,
+		              expected);
+
+		ASSERT_EQ(iterative_dfs(flat, start), expected);
+	}
+}
+
+TEST(GraphAlgosTest, DeepChains)
+{
+	Instance ins;
+	build_deep_instance(ins, 200000, 200000, true);
+
+	auto order = TopologicalSort(ins.get_laggraph()).get();
+	ASSERT_TRUE(is_topological(ins, order));
+
+	// Would overflow the stack if recursive
+	size_t visited = 0;
+	size_t backtracked = 0;
+	auto visit = [&](LagGraph::vertex, LagGraph::vertex) {
+		visited++;
+		return true;
+	};
+	auto traverse = [&](LagGraph::vertex, LagGraph::vertex, int) {};
+	auto backtrack = [&](LagGraph::vertex) { backtracked++; };
+	DFS<decltype(visit), decltype(backtrack), decltype(traverse)>(
+	    ins.get_laggraph(), order.back(), visit, backtrack, traverse, true);
+	ASSERT_EQ(visited, ins.job_count());
+	ASSERT_EQ(backtracked, ins.job_count());
+}
+
+TEST(GraphAlgosTest, TopologicalSortWithCycle)
+{
+	Instance ins;
+	build_deep_instance(ins, 100, 0, false);
+	ins.get_laggraph().add_edge(ins.get_job(60), ins.get_job(40), {1, 0, 0});
+
+	auto order = TopologicalSort(ins.get_laggraph()).get();
+	ASSERT_EQ(order.size(), ins.job_count());
+	ASSERT_FALSE(is_topological(ins, order));
+	// Everything before the cycle is still in order
+	for (unsigned int i = 0; i < 40; ++i) {
+		ASSERT_EQ(order[i], i);
+	}
+}
+
+/* Compares against the recursive DFS on the map-based LagGraph. Disabled by
+ * default, run with --gtest_also_run_disabled_tests. */
+TEST(GraphAlgosTest, DISABLED_BenchmarkDeepInstances)
+{
+	using clock = std::chrono::steady_clock;
+	auto seconds = [](clock::time_point since) {
+		return std::chrono::duration<double>(clock::now() - since).count();
+	};
+
+	// The recursive search needs the default stack to stay below ~30k
+	for (unsigned int job_count : {5000u, 20000u}) {
+		Instance ins;
+		build_deep_instance(ins, job_count, 4 * job_count, true);
+		constexpr unsigned int ROUNDS = 20;
+
+		auto started = clock::now();
+		size_t recursive_events = 0;
+		for (unsigned int round = 0; round < ROUNDS; ++round) {
+			std::vector<bool> visited(ins.job_count(), false);
+			std::vector<Event> events;
+			for (LagGraph::vertex v = 0; v < ins.job_count(); ++v) {
+				if (!visited[v]) {
+					recursive_dfs(ins.get_laggraph(), v, LagGraph::no_vertex, visited,
+					              events);
+				}
+			}
+			recursive_events += events.size();
+		}
+		double recursive_time = seconds(started);
+
+		started = clock::now();
+		for (unsigned int round = 0; round < ROUNDS; ++round) {
+			FlatLagGraph flat(ins.get_laggraph());
+			ASSERT_EQ(flat.vertex_count(), ins.job_count());
+		}
+		double flatten_time = seconds(started);
+
+		FlatLagGraph flat(ins.get_laggraph());
+		auto order = TopologicalSort(flat).get();
+
+		started = clock::now();
+		size_t iterative_events = 0;
+		for (unsigned int round = 0; round < ROUNDS; ++round) {
+			// Starting at the first job in topological order reaches everything
+			iterative_events += iterative_dfs(flat, order.front()).size();
+		}
+		double iterative_time = seconds(started);
+
+		started = clock::now();
+		for (unsigned int round = 0; round < ROUNDS; ++round) {
+			ASSERT_EQ(TopologicalSort(flat).get().size(), ins.job_count());
+		}
+		double toposort_time = seconds(started);
+
+		started = clock::now();
+		for (unsigned int round = 0; round < ROUNDS; ++round) {
+			CriticalPathComputer cpc(ins);
+			ASSERT_EQ(cpc.get_forward().size(), ins.job_count());
+		}
+		double critical_path_time = seconds(started);
+
+		ASSERT_EQ(recursive_events, iterative_events);
+		std::cout << job_count << " jobs, " << ins.get_laggraph().edge_count()
+		          << " edges, ms per round:\n"
+		          << "  recursive DFS on LagGraph: "
+		          << 1000 * recursive_time / ROUNDS << "\n"
+		          << "  iterative DFS on flat:     "
+		          << 1000 * iterative_time / ROUNDS << "\n"
+		          << "  flattening:                "
+		          << 1000 * flatten_time / ROUNDS << "\n"
+		          << "  Kahn on flat:              "
+		          << 1000 * toposort_time / ROUNDS << "\n"
+		          << "  critical path (forward):   "
+		          << 1000 * critical_path_time / ROUNDS << "\n";
+	}
+}
+
+} // namespace graphalgos
+} // namespace test
+
+#endif
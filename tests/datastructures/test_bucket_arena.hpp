@@ -0,0 +1,58 @@
+#ifndef TCPSPSUITE_TEST_BUCKET_ARENA_HPP
+#define TCPSPSUITE_TEST_BUCKET_ARENA_HPP
+
+#include <random>
+#include <vector>
+
+using namespace testing;
+
+#include "../src/datastructures/bucket_arena.hpp"
+
+namespace test {
+namespace bucket_arena {
+
+constexpr unsigned int TEST_SEED = 4;
+constexpr unsigned int TEST_ROUNDS = 50;
+constexpr size_t TEST_BUCKETS = 40;
+
+TEST(BucketArenaTest, MatchesVectorOfVectors)
+{
+	std::mt19937 rng(TEST_SEED);
+	std::uniform_int_distribution<size_t> bucket_distr(0, TEST_BUCKETS - 1);
+	std::uniform_int_distribution<unsigned int> count_distr(0, 100);
+
+	ds::BucketArena<unsigned int> arena(TEST_BUCKETS);
+
+	for (unsigned int round = 0; round < TEST_ROUNDS; ++round) {
+		arena.clear();
+		std::vector<std::vector<unsigned int>> reference(TEST_BUCKETS);
+		std::vector<size_t> first_used;
+
+		unsigned int count = count_distr(rng);
+		for (unsigned int i = 0; i < count; ++i) {
+			size_t bucket = bucket_distr(rng);
+			if (reference[bucket].empty()) {
+				first_used.push_back(bucket);
+			}
+			reference[bucket].push_back(i);
+			arena.push_back(bucket, i);
+		}
+
+		ASSERT_EQ(arena.size(), count);
+		ASSERT_EQ(arena.get_used_buckets(), first_used);
+
+		for (size_t bucket = 0; bucket < TEST_BUCKETS; ++bucket) {
+			ASSERT_EQ(arena.empty(bucket), reference[bucket].empty());
+
+			std::vector<unsigned int> contents;
+			arena.for_each(bucket,
+			               [&](unsigned int value) { contents.push_back(value); });
+			ASSERT_EQ(contents, reference[bucket]);
+		}
+	}
+}
+
+} // namespace bucket_arena
+} // namespace test
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef TCPSPSUITE_TEST_CIRCULAR_VECTOR_HPP
+#define TCPSPSUITE_TEST_CIRCULAR_VECTOR_HPP
+
+#include <deque>
+#include <random>
+#include <utility>
+
+using namespace testing;
+
+#include "../src/datastructures/circular_vector.hpp"
+
+namespace test {
+namespace circular_vector {
+
+constexpr unsigned int TEST_SEED = 4;
+constexpr unsigned int TEST_OPERATIONS = 20000;
+
+void
+expect_equal(const CircularVector<int> & cv, const std::deque<int> & reference)
+{
+	ASSERT_EQ(cv.size(), reference.size());
+	ASSERT_EQ(cv.empty(), reference.empty());
+	for (size_t i = 0; i < reference.size(); ++i) {
+		ASSERT_EQ(cv[i], reference[i]);
+	}
+	if (!reference.empty()) {
+		ASSERT_EQ(cv.front(), reference.front());
+		ASSERT_EQ(cv.back(), reference.back());
+	}
+}
+
+TEST(CircularVectorTest, BehavesLikeDeque)
+{
+	std::mt19937 rng(TEST_SEED);
+	// Pushing more often than popping makes the buffer grow while wrapped
+	std::discrete_distribution<int> op_distr({3, 3, 2, 2});
+
+	CircularVector<int> cv;
+	std::deque<int> reference;
+
+	for (unsigned int i = 0; i < TEST_OPERATIONS; ++i) {
+		int op = op_distr(rng);
+		if ((op >= 2) && reference.empty()) {
+			op -= 2;
+		}
+
+		switch (op) {
+		case 0:
+			cv.push_back((int)i);
+			reference.push_back((int)i);
+			break;
+		case 1:
+			cv.push_front((int)i);
+			reference.push_front((int)i);
+			break;
+		case 2:
+			cv.pop_back();
+			reference.pop_back();
+			break;
+		default:
+			cv.pop_front();
+			reference.pop_front();
+		}
+
+		if ((i % 97) == 0) {
+			expect_equal(cv, reference);
+		}
+	}
+	expect_equal(cv, reference);
+}
+
+TEST(CircularVectorTest, KeepsCapacityAndMoves)
+{
+	CircularVector<int> cv;
+	for (int i = 0; i < 100; ++i) {
+		cv.push_back(i);
+	}
+	size_t capacity = cv.capacity();
+	ASSERT_GE(capacity, 100u);
+
+	cv.clear();
+	ASSERT_TRUE(cv.empty());
+	for (int i = 0; i < 100; ++i) {
+		cv.push_front(i);
+	}
+	ASSERT_EQ(cv.capacity(), capacity);
+
+	CircularVector<int> moved(std::move(cv));
+	ASSERT_EQ(moved.size(), 100u);
+	ASSERT_EQ(moved.front(), 99);
+	ASSERT_EQ(moved.back(), 0);
+}
+
+} // namespace circular_vector
+} // namespace test
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef TCPSPSUITE_TEST_FENWICK_TREE_HPP
+#define TCPSPSUITE_TEST_FENWICK_TREE_HPP
+
+#include <random>
+
+using namespace testing;
+
+#include "../src/datastructures/fenwick_tree.hpp"
+
+namespace test {
+namespace fenwick_tree {
+
+constexpr unsigned int TEST_SEED = 4;
+constexpr unsigned int TEST_ROUNDS = 100;
+constexpr unsigned int TEST_MAX_SIZE = 60;
+
+// Linear scan with the same semantics as FenwickTree::find
+size_t
+find_linear(const std::vector<double> & weights, double point)
+{
+	double sum = 0;
+	size_t i = 0;
+	while ((i < weights.size() - 1) && (sum + weights[i] <= point)) {
+		sum += weights[i];
+		i++;
+	}
+	return i;
+}
+
+TEST(FenwickTreeTest, SampleAndSwapRemove)
+{
+	std::mt19937 rng(TEST_SEED);
+	std::uniform_int_distribution<unsigned int> size_distr(1, TEST_MAX_SIZE);
+	// Integral weights keep all sums exact. Some weights are zero.
+	std::uniform_int_distribution<unsigned int> weight_distr(0, 5);
+
+	for (unsigned int round = 0; round < TEST_ROUNDS; ++round) {
+		std::vector<double> weights(size_distr(rng));
+		for (auto & weight : weights) {
+			weight = weight_distr(rng);
+		}
+		weights[0] = 1; // at least one positive weight
+
+		ds::FenwickTree<double> tree;
+		tree.build(weights.begin(), weights.end(), [](double w) { return w; });
+
+		while (!weights.empty()) {
+			ASSERT_EQ(tree.size(), weights.size());
+			double total = 0;
+			for (double weight : weights) {
+				total += weight;
+			}
+			ASSERT_EQ(tree.total(), total);
+
+			size_t i = 0;
+			if (total > 0) {
+				std::uniform_real_distribution<double> distr(0, total);
+				double point = distr(rng);
+				i = tree.find(point);
+				ASSERT_EQ(i, find_linear(weights, point));
+				ASSERT_GT(weights[i], 0);
+			}
+
+			tree.add(i, weights.back() - weights[i]);
+			tree.pop_back();
+			weights[i] = weights.back();
+			weights.pop_back();
+		}
+		ASSERT_TRUE(tree.empty());
+	}
+}
+
+} // namespace fenwick_tree
+} // namespace test
+
+#endif // TCPSPSUITE_TEST_FENWICK_TREE_HPP
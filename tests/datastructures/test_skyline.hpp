@@ -182,6 +182,30 @@ TEST_F(TreeSkyLineTest, TestRangedConstruction)
   ds::RangedTreeSkyLine sl(&instance);
 }
 
+TEST_F(TreeSkyLineTest, TestMaximumRangeVersion)
+{
+  ds::SkyLine sl{ds::RangedTreeSkyLine(&instance)};
+
+  for (auto & job : instance.get_jobs()) {
+    sl.insert_job(job, job.get_release());
+  }
+
+  // The version must change exactly when the maximum range changes
+  auto range = sl.get_maximum_range();
+  auto version = sl.get_maximum_range_version();
+  for (auto & job : instance.get_jobs()) {
+    std::uniform_int_distribution<unsigned int> pos_distr(
+        job.get_release(), job.get_deadline() - job.get_duration());
+    sl.set_pos(job, pos_distr(rng));
+
+    auto new_range = sl.get_maximum_range();
+    auto new_version = sl.get_maximum_range_version();
+    ASSERT_EQ(new_range != range, new_version != version);
+    range = new_range;
+    version = new_version;
+  }
+}
+
 /*
  * Array based SkyLine
  */
@@ -0,0 +1,52 @@
+#ifndef TCPSPSUITE_TEST_STORAGE_HPP
+#define TCPSPSUITE_TEST_STORAGE_HPP
+
+#include <vector>
+
+using namespace testing;
+
+#include "../src/db/storage.hpp"
+
+namespace test {
+namespace storage {
+
+constexpr size_t MIB = 1024 * 1024;
+
+TEST(StorageTest, PeakOfProcessMeasurements)
+{
+	std::vector<Storage::MemorySample> samples(2);
+	samples[0].rss_bytes_max = 30 * MIB;
+	samples[0].data_bytes_max = 20 * MIB;
+	samples[1].rss_bytes_max = 50 * MIB;
+	samples[1].data_bytes_max = 40 * MIB;
+
+	Maybe<size_t> peak = Storage::get_peak(samples);
+	ASSERT_TRUE(peak.valid());
+	ASSERT_EQ(peak.value(), 50 * MIB);
+
+	ASSERT_FALSE(Storage::get_peak({}).valid());
+}
+
+TEST(StorageTest, PeakIgnoresPerThreadRSS)
+{
+	std::vector<Storage::MemorySample> samples(3);
+	// Measured for the whole process
+	samples[0].rss_bytes_max = 30 * MIB;
+	samples[0].data_bytes_max = 20 * MIB;
+	// Measured per thread, page faults in place of the RSS
+	samples[1].rss_bytes_max = 4000 * MIB;
+	// Measured per thread with malloc() instrumentation
+	samples[2].malloc_max_size = 40 * MIB;
+
+	Maybe<size_t> peak = Storage::get_peak(samples);
+	ASSERT_TRUE(peak.valid());
+	ASSERT_EQ(peak.value(), 40 * MIB);
+
+	// Nothing usable in per-thread rows without malloc() figures
+	ASSERT_FALSE(Storage::get_peak({samples[1]}).valid());
+}
+
+} // namespace storage
+} // namespace test
+
+#endif
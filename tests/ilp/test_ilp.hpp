@@ -1,13 +1,14 @@
 #ifndef TCPSPSUITE_TEST_ILP_HPP
 #define TCPSPSUITE_TEST_ILP_HPP
 
+#include <map>
 #include <random>
 
 using namespace testing;
 
-#include "../src/contrib/ilpabstraction/src/ilpa_gurobi.hpp"
 #include "../src/db/storage.hpp"
 #include "../src/ilp/dtilp.hpp"
+#include "../src/ilp/dtilplns.hpp"
 #include "../src/ilp/ebilp.hpp"
 #include "../src/ilp/fbilp.hpp"
 #include "../src/ilp/obilp.hpp"
@@ -16,11 +17,24 @@ using namespace testing;
 #include "../src/manager/errors.hpp"
 #include "../src/util/solverconfig.hpp"
 
+#if defined(GUROBI_FOUND)
+#include "../src/contrib/ilpabstraction/src/ilpa_gurobi.hpp"
+#elif defined(HIGHS_FOUND)
+#include "../src/ilp/ilpa_highs.hpp"
+#endif
+
 namespace test {
 namespace ilp {
 
 constexpr unsigned int TEST_SEED = 4;
 
+// Prefer Gurobi if it is available, fall back to the open-source HiGHS
+#if defined(GUROBI_FOUND)
+using TestMIPSolver = ilpabstraction::GurobiInterface;
+#elif defined(HIGHS_FOUND)
+using TestMIPSolver = ilpabstraction::HighsInterface;
+#endif
+
 class ILPTest : public Test {
 public:
 	ILPTest() : sconf("GRBTest", "ID", {}, {10u}, false, 1, {}, {1}) {}
@@ -33,37 +47,37 @@ public:
 	}
 
 	void
-	run_gurobi_dtilp()
+	run_dtilp()
 	{
 		AdditionalResultStorage aresult;
-		DTILP<ilpabstraction::GurobiInterface> ilp(instance, aresult, sconf);
+		DTILP<TestMIPSolver> ilp(instance, aresult, sconf);
 		ilp.run();
 		sol = ilp.get_solution();
 	}
 
 	void
-	run_gurobi_ebilp()
+	run_ebilp()
 	{
 		AdditionalResultStorage aresult;
-		EBILP<ilpabstraction::GurobiInterface> ilp(instance, aresult, sconf);
+		EBILP<TestMIPSolver> ilp(instance, aresult, sconf);
 		ilp.run();
 		sol = ilp.get_solution();
 	}
 
 	void
-	run_gurobi_fbilp()
+	run_fbilp()
 	{
 		AdditionalResultStorage aresult;
-		FBILP<ilpabstraction::GurobiInterface> ilp(instance, aresult, sconf);
+		FBILP<TestMIPSolver> ilp(instance, aresult, sconf);
 		ilp.run();
 		sol = ilp.get_solution();
 	}
 
 	void
-	run_gurobi_obilp()
+	run_obilp()
 	{
 		AdditionalResultStorage aresult;
-		OBILP<ilpabstraction::GurobiInterface> ilp(instance, aresult, sconf);
+		OBILP<TestMIPSolver> ilp(instance, aresult, sconf);
 		ilp.run();
 		sol = ilp.get_solution();
 	}
@@ -128,28 +142,28 @@ public:
 TEST_F(BasicTestFixture, BasicTestGrbDTILP)
 {
 	this->create();
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 	this->verify();
 }
 
 TEST_F(BasicTestFixture, BasicTestGrbOBILP)
 {
 	this->create();
-	this->run_gurobi_obilp();
+	this->run_obilp();
 	this->verify();
 }
 
 TEST_F(BasicTestFixture, BasicTestGrbEBILP)
 {
 	this->create();
-	this->run_gurobi_ebilp();
+	this->run_ebilp();
 	this->verify();
 }
 
 TEST_F(BasicTestFixture, BasicTestGrbFBILP)
 {
 	this->create();
-	this->run_gurobi_fbilp();
+	this->run_fbilp();
 	this->verify();
 }
 
@@ -170,7 +184,7 @@ TEST_F(ILPTest, TestWindowExtensionHardDeadline)
 	instance.set_window_extension_hard_deadline(1);
 
 	this->sconf.override_seed(5);
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 
 	unsigned int start0 = this->sol.get_start_time(0);
 	unsigned int start1 = this->sol.get_start_time(1);
@@ -197,7 +211,7 @@ TEST_F(ILPTest, TestWindowExtensionViolation)
 	instance.set_window_extension(2, 2);
 
 	this->sconf.override_seed(5);
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 
 	unsigned int start0 = this->sol.get_start_time(0);
 	unsigned int start1 = this->sol.get_start_time(1);
@@ -278,7 +292,7 @@ TEST_F(ProvokeOffByOneIfNoWindowExtensionTest,
        ProvokeOffByOneIfNoWindowExtensionDTILP)
 {
   this->create();
-  this->run_gurobi_dtilp();
+  this->run_dtilp();
   this->verify();
 }
 
@@ -286,7 +300,7 @@ TEST_F(ProvokeOffByOneIfNoWindowExtensionTest,
        ProvokeOffByOneIfNoWindowExtensionEBILP)
 {
   this->create();
-  this->run_gurobi_ebilp();
+  this->run_ebilp();
   this->verify();
 }
 
@@ -294,7 +308,7 @@ TEST_F(ProvokeOffByOneIfNoWindowExtensionTest,
        ProvokeOffByOneIfNoWindowExtensionFBILP)
 {
   this->create();
-  this->run_gurobi_fbilp();
+  this->run_fbilp();
   this->verify();
 }
 
@@ -302,7 +316,7 @@ TEST_F(ProvokeOffByOneIfNoWindowExtensionTest,
        ProvokeOffByOneIfNoWindowExtensionOBILP)
 {
   this->create();
-  this->run_gurobi_obilp();
+  this->run_obilp();
   this->verify();
 }
 */
@@ -326,7 +340,7 @@ TEST_F(ILPTest, BasicExtensionTest)
 
 	instance.set_window_extension(5, 1);
 
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 
 	this->sol.verify(sconf.get_seed());
 
@@ -353,7 +367,7 @@ TEST_F(ILPTest, CanExtendRightTest)
 
 	instance.set_window_extension(2, 1);
 
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 
 	this->sol.verify(sconf.get_seed());
 
@@ -380,7 +394,7 @@ TEST_F(ILPTest, CanExtendLeftTest)
 
 	instance.set_window_extension(5, 1);
 
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 
 	this->sol.verify(sconf.get_seed());
 
@@ -412,7 +426,7 @@ TEST_F(ILPTest, TestOvershootWithChangingAvailability)
 	Job j1(0, 100, 10, {9.0}, 1);
 	instance.add_job(std::move(j1));
 
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 	this->sol.verify(sconf.get_seed());
 
 	ASSERT_EQ(sol.get_start_time(0), 0);
@@ -441,7 +455,7 @@ TEST_F(ILPTest, TestInvestmentWithChangingAvailability)
 	Job j1(0, 100, 1, {16.0}, 1);
 	instance.add_job(std::move(j1));
 
-	this->run_gurobi_dtilp();
+	this->run_dtilp();
 	this->sol.verify(sconf.get_seed());
 
 	ASSERT_EQ(sol.get_start_time(0), 10);
@@ -449,6 +463,42 @@ TEST_F(ILPTest, TestInvestmentWithChangingAvailability)
 	ASSERT_EQ(sol.get_costs(), 1);
 }
 
+TEST_F(ILPTest, LNSReoptimizesThePeak)
+{
+	Resource res(0);
+	res.set_investment_costs({{1.0, 1.0}});
+	this->instance.add_resource(std::move(res));
+
+	// The EarlyScheduler starts all of them at 0
+	for (unsigned int jid = 0; jid < 4; ++jid) {
+		this->instance.add_job(Job(0, 40, 10, {1.0}, jid));
+	}
+
+	// Never look at random points, all neighbourhoods are at the peak then
+	SolverConfig lns_conf("LNSTest", "ID",
+	                      {{"lns_iteration_time", 1}, {"lns_max_stagnation", 1000}},
+	                      {2u}, false, 1, {}, {1});
+	AdditionalResultStorage aresult;
+	DTILPLNS<TestMIPSolver> lns(this->instance, aresult, lns_conf);
+	lns.run();
+	this->sol = lns.get_solution();
+	this->sol.verify(lns_conf.get_seed());
+
+	ASSERT_FALSE(aresult.intermediate_results.empty());
+	double initial_costs = aresult.intermediate_results.front().costs.value();
+	ASSERT_EQ(initial_costs, 4.0);
+	ASSERT_LE(this->sol.get_costs(), initial_costs);
+
+	std::map<std::string, int> measures;
+	for (const auto & measure : aresult.extended_measures) {
+		measures[measure.key] = measure.value.v_int;
+	}
+	ASSERT_GT(measures["LNS_ITERATIONS"], 0);
+	// Jobs always run at the peak, so every free set holds some
+	ASSERT_EQ(measures["LNS_EMPTY_NEIGHBOURHOODS"], 0);
+	ASSERT_GT(measures["LNS_IMPROVEMENTS"], 0);
+}
+
 } // namespace ilp
 } // namespace test
 
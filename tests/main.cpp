@@ -9,12 +9,21 @@
 #include "datastructures/test_skyline.hpp"
 #include "instance/test_solution.hpp"
 #include "algorithms/test_permutation.hpp"
+#include "algorithms/test_aplp.hpp"
+#include "algorithms/test_graphalgos.hpp"
+#include "algorithms/test_critical_path.hpp"
 //#include "state_propagation/test_sp.hpp"
 //#include "state_propagation/test_propagator.hpp"
 #include "datastructures/test_intrusive_shared_ptr_pool.hpp"
 #include "datastructures/test_overlapping_jobs_generator.hpp"
+#include "datastructures/test_fenwick_tree.hpp"
+#include "datastructures/test_circular_vector.hpp"
+#include "datastructures/test_bucket_arena.hpp"
+#include "manager/test_checkpoint.hpp"
+#include "db/test_storage.hpp"
+#include "util/test_workerpool.hpp"
 
-#if defined(GUROBI_FOUND)
+#if defined(GUROBI_FOUND) || defined(HIGHS_FOUND)
 #include "ilp/test_ilp.hpp"
 #endif
 
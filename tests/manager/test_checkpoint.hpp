@@ -0,0 +1,95 @@
+#ifndef TCPSPSUITE_TEST_CHECKPOINT_HPP
+#define TCPSPSUITE_TEST_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace testing;
+
+#include "../src/manager/checkpoint.hpp"
+
+namespace test {
+namespace checkpoint {
+
+const std::string TEST_DIR = "/tmp";
+
+TEST(CheckpointTest, RoundTrip)
+{
+	std::mt19937 rng(42);
+	rng.discard(17);
+
+	{
+		manager::Checkpoint ckpt(TEST_DIR, "checkpoint-test-roundtrip", 10);
+		ckpt.discard();
+		ASSERT_FALSE(ckpt.can_resume());
+
+		manager::CheckpointWriter out;
+		out.write((uint64_t)1234);
+		out.write(std::vector<unsigned int>{3, 1, 4, 1, 5});
+		out.write(std::string("state"));
+		out.write(rng);
+		ASSERT_TRUE(ckpt.write(out, 12.5));
+	}
+
+	manager::Checkpoint ckpt(TEST_DIR, "checkpoint-test-roundtrip", 10);
+	ASSERT_TRUE(ckpt.can_resume());
+	ASSERT_DOUBLE_EQ(ckpt.get_previous_elapsed(), 12.5);
+	ASSERT_FALSE(ckpt.is_due(20));
+	ASSERT_TRUE(ckpt.is_due(23));
+
+	manager::CheckpointReader in = ckpt.resume();
+	uint64_t value = 0;
+	std::vector<unsigned int> values;
+	std::string text;
+	std::mt19937 restored;
+	in.read(value);
+	in.read(values);
+	in.read(text);
+	in.read(restored);
+
+	ASSERT_TRUE(in.good());
+	ASSERT_TRUE(in.at_end());
+	ASSERT_EQ(value, 1234u);
+	ASSERT_EQ(values, (std::vector<unsigned int>{3, 1, 4, 1, 5}));
+	ASSERT_EQ(text, "state");
+	ASSERT_EQ(restored(), rng());
+
+	// Reading past the end fails
+	in.read(value);
+	ASSERT_FALSE(in.good());
+
+	ckpt.discard();
+	manager::Checkpoint discarded(TEST_DIR, "checkpoint-test-roundtrip", 10);
+	ASSERT_FALSE(discarded.can_resume());
+}
+
+TEST(CheckpointTest, IgnoresCorruptFiles)
+{
+	std::string path;
+	{
+		manager::Checkpoint ckpt(TEST_DIR, "checkpoint-test-corrupt", 10);
+		manager::CheckpointWriter out;
+		out.write(std::vector<double>(100, 1.0));
+		ASSERT_TRUE(ckpt.write(out, 1.0));
+		path = ckpt.get_path();
+	}
+
+	{
+		// Flip a byte in the payload
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(-20, std::ios::end);
+		file.put('x');
+	}
+
+	manager::Checkpoint ckpt(TEST_DIR, "checkpoint-test-corrupt", 10);
+	ASSERT_FALSE(ckpt.can_resume());
+	ckpt.discard();
+}
+
+} // namespace checkpoint
+} // namespace test
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef TCPSPSUITE_TEST_WORKERPOOL_HPP
+#define TCPSPSUITE_TEST_WORKERPOOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace testing;
+
+#include "../src/util/threadgroup.hpp"
+#include "../src/util/workerpool.hpp"
+
+namespace test {
+namespace workerpool {
+
+constexpr unsigned int TEST_THREADS = 4;
+constexpr unsigned int TEST_ROUNDS = 200;
+
+TEST(WorkerPoolTest, RunsEveryWorkerOncePerRound)
+{
+	util::WorkerPool pool(TEST_THREADS);
+	ASSERT_EQ(pool.get_thread_count(), TEST_THREADS);
+
+	std::vector<unsigned int> counts(TEST_THREADS, 0);
+	for (unsigned int round = 0; round < TEST_ROUNDS; ++round) {
+		// Plain writes, run() must make them visible to us
+		pool.run([&](unsigned int worker) { counts[worker]++; });
+	}
+
+	for (unsigned int worker = 0; worker < TEST_THREADS; ++worker) {
+		ASSERT_EQ(counts[worker], TEST_ROUNDS);
+	}
+}
+
+TEST(WorkerPoolTest, SharesWork)
+{
+	util::WorkerPool pool(TEST_THREADS);
+
+	std::vector<unsigned int> data(10000);
+	std::atomic<size_t> next(0);
+	pool.run([&](unsigned int worker) {
+		(void)worker;
+		for (size_t i = next++; i < data.size(); i = next++) {
+			data[i] = (unsigned int)i * 2;
+		}
+	});
+
+	for (size_t i = 0; i < data.size(); ++i) {
+		ASSERT_EQ(data[i], i * 2);
+	}
+}
+
+TEST(WorkerPoolTest, SingleThreadRunsInline)
+{
+	util::WorkerPool pool(1);
+	unsigned int calls = 0;
+	pool.run([&](unsigned int worker) {
+		ASSERT_EQ(worker, 0u);
+		calls++;
+	});
+	ASSERT_EQ(calls, 1u);
+}
+
+TEST(WorkerPoolTest, WorkersJoinThreadGroup)
+{
+	auto group = std::make_shared<util::ThreadGroup>();
+	{
+		util::ThreadGroup::Membership membership(group);
+		ASSERT_EQ(util::ThreadGroup::current(), group);
+		{
+			util::WorkerPool pool(TEST_THREADS);
+			pool.run([&](unsigned int worker) {
+				(void)worker;
+				ASSERT_EQ(util::ThreadGroup::current(), group);
+				// Burn some CPU time, s.t. there is something to count
+				auto until =
+				    std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+				while (std::chrono::steady_clock::now() < until) {
+				}
+			});
+			ASSERT_EQ(group->get_member_count(), TEST_THREADS);
+		}
+		// The workers have left when the pool is gone
+		ASSERT_EQ(group->get_member_count(), 1u);
+	}
+	ASSERT_EQ(group->get_member_count(), 0u);
+	ASSERT_EQ(util::ThreadGroup::current(), nullptr);
+
+	util::ThreadGroup::Usage usage = group->get_usage();
+	ASSERT_GT(usage.user_usecs + usage.system_usecs, 0ul);
+}
+
+} // namespace workerpool
+} // namespace test
+
+#endif